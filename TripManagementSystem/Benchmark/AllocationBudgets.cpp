@@ -0,0 +1,182 @@
+#include "AllocationBudgets.h"
+
+#include <iomanip>
+#include <sstream>
+
+#include "../Managers/PersonManager.h"
+#include "../Managers/TripFilter.h"
+#include "../Managers/TripManager.h"
+#include "AllocationCounter.h"
+
+using namespace std;
+
+namespace {
+// NOTE: Operations per check, spread over the dataset so one unusual trip does not decide the result
+const size_t OPERATIONS_PER_CHECK = 100;
+
+// NOTE: Measured allocations per operation plus about a quarter, which absorbs the differences between standard
+// libraries (short string sizes, vector growth) but not a new copy of a trip or of one of its lists
+const uint64_t OPEN_TRIP_BUDGET = 460;
+const uint64_t FILTER_TRIPS_BUDGET = 860;
+const uint64_t ADD_EXPENSE_BUDGET = 280;
+
+// CLASS: STEPTALLY
+struct STEPTALLY {
+    string name;
+    ALLOCATIONCOUNTS counts;
+};
+
+BUDGETCHECK summarize(const string &operation, uint64_t budget, const ALLOCATIONCOUNTS &total,
+                      const vector<STEPTALLY> &steps, size_t operations) {
+    BUDGETCHECK check;
+    check.operation = operation;
+    check.budget = budget;
+    check.allocationsPerOperation = static_cast<double>(total.count) / operations;
+    for (const STEPTALLY &step : steps) {
+        check.steps.emplace_back(step.name, static_cast<double>(step.counts.count) / operations);
+    }
+    return check;
+}
+
+// NOTE: Every k-th trip of the store, the same ones on every run
+vector<string> spreadTripIDs(const TRIPMANAGER &trips) {
+    TRIPSNAPSHOT snapshot = trips.getAllTrips();
+    size_t step = max<size_t>(1, snapshot.size() / OPERATIONS_PER_CHECK);
+    vector<string> ids;
+    for (size_t i = 0; i < snapshot.size() && ids.size() < OPERATIONS_PER_CHECK; i += step) {
+        ids.push_back(snapshot[i].getID());
+    }
+    return ids;
+}
+
+// FUNC: What MainWindow::onViewTripDetailsClicked and the ViewTripDialog do before the dialog shows
+BUDGETCHECK checkOpenTrip(TRIPMANAGER &trips, const PERSONMANAGER &people, const vector<string> &ids) {
+    ALLOCATIONCOUNTS total;
+    vector<STEPTALLY> steps = {{"load details", {}}, {"copy trip", {}}, {"host and members", {}}, {"expenses", {}}};
+    for (const string &id : ids) {
+        ALLOCATIONSCOPE operation(total);
+        shared_ptr<const TRIP> shared;
+        {
+            ALLOCATIONSCOPE step(steps[0].counts);
+            trips.loadTripDetails(id, &people);
+            shared = trips.shareTripById(id);
+        }
+        TRIP trip = [&]() {
+            ALLOCATIONSCOPE step(steps[1].counts);
+            return TRIP(*shared);
+        }();
+        {
+            ALLOCATIONSCOPE step(steps[2].counts);
+            HOST host = trip.getHost();
+            for (const MEMBER &member : trip.getMembers()) {
+                trip.getTotalPaidBy(member.getKey());
+            }
+        }
+        {
+            ALLOCATIONSCOPE step(steps[3].counts);
+            trip.getAllExpenses();
+        }
+    }
+    return summarize("open_trip", OPEN_TRIP_BUDGET, total, steps, ids.size());
+}
+
+// FUNC: What FilterTripDialog::applyFilters does on every change of a criterion
+BUDGETCHECK checkFilterTrips(const TRIPMANAGER &trips) {
+    TRIPFILTER filter;
+    filter.destinationText = "a";
+    filter.statuses = {STATUS::Completed, STATUS::Planned};
+    filter.keywords = splitKeywords("nhom, gia dinh");
+    filter.filterDates = true;
+    filter.startFrom = DATE(1, 1, 2023);
+    filter.startTo = DATE(31, 12, 2024);
+    filter.endFrom = DATE(1, 1, 2023);
+    filter.endTo = DATE(31, 12, 2024);
+
+    ALLOCATIONCOUNTS total;
+    vector<STEPTALLY> steps = {{"snapshot", {}}, {"filter", {}}, {"sort", {}}};
+    for (size_t i = 0; i < OPERATIONS_PER_CHECK; ++i) {
+        ALLOCATIONSCOPE operation(total);
+        TRIPSNAPSHOT snapshot = [&]() {
+            ALLOCATIONSCOPE step(steps[0].counts);
+            return trips.getAllTrips();
+        }();
+        TRIPSNAPSHOT filtered = [&]() {
+            ALLOCATIONSCOPE step(steps[1].counts);
+            return snapshot.filter([&filter](const TRIP &trip) { return filter.matches(trip); });
+        }();
+        ALLOCATIONSCOPE step(steps[2].counts);
+        sortTrips(filtered, TRIPSORTKEY::StartDate, true);
+    }
+    return summarize("filter_trips", FILTER_TRIPS_BUDGET, total, steps, OPERATIONS_PER_CHECK);
+}
+
+// FUNC: What the add expense button of the ViewTripDialog does, and saving the edited trip back to the store
+BUDGETCHECK checkAddExpense(TRIPMANAGER &trips, const vector<string> &ids) {
+    ALLOCATIONCOUNTS total;
+    vector<STEPTALLY> steps = {{"copy trip", {}}, {"add expense", {}}, {"update store", {}}};
+    size_t operations = 0;
+    for (const string &id : ids) {
+        shared_ptr<const TRIP> original = trips.shareTripById(id);
+        vector<MEMBER> members = original->getMembers();
+        if (members.empty()) {
+            continue;
+        }
+        EXPENSE expense(original->getStartDate(), CATEGORY::Food, 150000, "Lunch", members.front());
+
+        ALLOCATIONSCOPE operation(total);
+        TRIP trip = [&]() {
+            ALLOCATIONSCOPE step(steps[0].counts);
+            return TRIP(*original);
+        }();
+        {
+            ALLOCATIONSCOPE step(steps[1].counts);
+            trip.addExpense(expense);
+        }
+        ALLOCATIONSCOPE step(steps[2].counts);
+        trips.updateTrip(*original, trip);
+        ++operations;
+    }
+    if (operations == 0) {
+        throw runtime_error("no trip with members to add an expense to");
+    }
+    return summarize("add_expense", ADD_EXPENSE_BUDGET, total, steps, operations);
+}
+}  // namespace
+
+bool BUDGETCHECK::isWithinBudget() const { return this->allocationsPerOperation <= this->budget; }
+
+vector<BUDGETCHECK> checkAllocationBudgets(const BENCHMARKDATASET &dataset) {
+    if (dataset.getSummary().trips != BUDGET_DATASET_SIZE) {
+        throw runtime_error("the allocation budgets are set for " + to_string(BUDGET_DATASET_SIZE) + " trips");
+    }
+    // NOTE: The store reads the dataset's cache files, its folder is the cache directory while it exists
+    PERSONMANAGER people;
+    TRIPMANAGER trips;
+    trips.loadSnapshot();
+    vector<string> ids = spreadTripIDs(trips);
+
+    vector<BUDGETCHECK> checks;
+    checks.push_back(checkOpenTrip(trips, people, ids));
+    checks.push_back(checkFilterTrips(trips));
+    checks.push_back(checkAddExpense(trips, ids));
+    return checks;
+}
+
+string budgetReport(const vector<BUDGETCHECK> &checks) {
+    ostringstream out;
+    out << fixed << setprecision(1);
+    size_t over = 0;
+    for (const BUDGETCHECK &check : checks) {
+        bool within = check.isWithinBudget();
+        over += within ? 0 : 1;
+        out << (within ? "  ok    " : "  OVER  ") << left << setw(14) << check.operation << right << setw(10)
+            << check.allocationsPerOperation << " allocations per operation, budget " << check.budget << '\n';
+        for (const auto &step : check.steps) {
+            out << "          " << left << setw(18) << step.first << right << setw(6) << step.second << '\n';
+        }
+    }
+    out << (over == 0 ? "All operations within their allocation budgets"
+                      : to_string(over) + " operation(s) over their allocation budget")
+        << '\n';
+    return out.str();
+}
@@ -0,0 +1,34 @@
+#ifndef ALLOCATIONBUDGETS_H
+#define ALLOCATIONBUDGETS_H
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Benchmarks.h"
+
+using namespace std;
+
+// NOTE: The budgets are set for the dataset of this many trips generated with the default seed
+const size_t BUDGET_DATASET_SIZE = 1000;
+
+// CLASS: BUDGETCHECK
+// Heap allocations of one operation the UI performs, against the most it may make. Allocation counts do not depend on
+// the machine's speed, so unlike the timings they are compared exactly; a copy of a trip or of a member list added to
+// one of these paths shows up as a jump of tens or thousands of allocations.
+struct BUDGETCHECK {
+    string operation;
+    uint64_t budget = 0;
+    double allocationsPerOperation = 0;
+    // NOTE: Allocations per operation of each step, to find where an overrun comes from
+    vector<pair<string, double>> steps;
+
+    bool isWithinBudget() const;
+};
+
+// FUNC: Opening a trip, filtering and sorting the trip list and adding an expense, on a store loaded from the cache
+vector<BUDGETCHECK> checkAllocationBudgets(const BENCHMARKDATASET &dataset);
+string budgetReport(const vector<BUDGETCHECK> &checks);
+
+#endif  // ALLOCATIONBUDGETS_H
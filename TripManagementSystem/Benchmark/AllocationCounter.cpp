@@ -0,0 +1,109 @@
+#include "AllocationCounter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+using namespace std;
+
+namespace {
+atomic<uint64_t> allocationCount{0};
+atomic<uint64_t> allocatedBytes{0};
+// NOTE: Innermost open scope of the thread, the others are reached through its parents
+thread_local ALLOCATIONSCOPE *innermostScope = nullptr;
+
+void *countedAllocate(size_t size) {
+    allocationCount.fetch_add(1, memory_order_relaxed);
+    allocatedBytes.fetch_add(size, memory_order_relaxed);
+    ALLOCATIONSCOPE::attribute(size);
+    return malloc(size == 0 ? 1 : size);
+}
+
+void *countedAllocate(size_t size, align_val_t alignment) {
+    allocationCount.fetch_add(1, memory_order_relaxed);
+    allocatedBytes.fetch_add(size, memory_order_relaxed);
+    ALLOCATIONSCOPE::attribute(size);
+    size_t align = static_cast<size_t>(alignment);
+    // NOTE: aligned_alloc wants the size to be a multiple of the alignment
+    size_t rounded = (size + align - 1) / align * align;
+#ifdef _WIN32
+    return _aligned_malloc(rounded == 0 ? align : rounded, align);
+#else
+    return aligned_alloc(align, rounded == 0 ? align : rounded);
+#endif
+}
+
+void alignedFree(void *pointer) {
+#ifdef _WIN32
+    _aligned_free(pointer);
+#else
+    free(pointer);
+#endif
+}
+}  // namespace
+
+ALLOCATIONCOUNTS currentAllocationCounts() {
+    ALLOCATIONCOUNTS counts;
+    counts.count = allocationCount.load(memory_order_relaxed);
+    counts.bytes = allocatedBytes.load(memory_order_relaxed);
+    return counts;
+}
+
+// FUNC: Scopes
+ALLOCATIONSCOPE::ALLOCATIONSCOPE(ALLOCATIONCOUNTS &tally) : tally(tally), counts(), parent(innermostScope) {
+    innermostScope = this;
+}
+
+ALLOCATIONSCOPE::~ALLOCATIONSCOPE() {
+    innermostScope = this->parent;
+    this->tally.count += this->counts.count;
+    this->tally.bytes += this->counts.bytes;
+}
+
+void ALLOCATIONSCOPE::attribute(size_t bytes) {
+    for (ALLOCATIONSCOPE *scope = innermostScope; scope; scope = scope->parent) {
+        scope->counts.count++;
+        scope->counts.bytes += bytes;
+    }
+}
+
+// FUNC: Replaced global allocation functions
+void *operator new(size_t size) {
+    void *pointer = countedAllocate(size);
+    if (!pointer) {
+        throw bad_alloc();
+    }
+    return pointer;
+}
+
+void *operator new[](size_t size) { return operator new(size); }
+
+void *operator new(size_t size, const nothrow_t &) noexcept { return countedAllocate(size); }
+
+void *operator new[](size_t size, const nothrow_t &) noexcept { return countedAllocate(size); }
+
+void *operator new(size_t size, align_val_t alignment) {
+    void *pointer = countedAllocate(size, alignment);
+    if (!pointer) {
+        throw bad_alloc();
+    }
+    return pointer;
+}
+
+void *operator new[](size_t size, align_val_t alignment) { return operator new(size, alignment); }
+
+void operator delete(void *pointer) noexcept { free(pointer); }
+
+void operator delete[](void *pointer) noexcept { free(pointer); }
+
+void operator delete(void *pointer, size_t) noexcept { free(pointer); }
+
+void operator delete[](void *pointer, size_t) noexcept { free(pointer); }
+
+void operator delete(void *pointer, align_val_t) noexcept { alignedFree(pointer); }
+
+void operator delete[](void *pointer, align_val_t) noexcept { alignedFree(pointer); }
+
+void operator delete(void *pointer, size_t, align_val_t) noexcept { alignedFree(pointer); }
+
+void operator delete[](void *pointer, size_t, align_val_t) noexcept { alignedFree(pointer); }
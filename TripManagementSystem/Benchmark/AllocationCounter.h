@@ -0,0 +1,39 @@
+#ifndef ALLOCATIONCOUNTER_H
+#define ALLOCATIONCOUNTER_H
+
+#include <cstddef>
+#include <cstdint>
+
+using namespace std;
+
+// CLASS: ALLOCATIONCOUNTS
+// Heap allocations made through operator new since the program started, by all threads
+struct ALLOCATIONCOUNTS {
+    uint64_t count = 0;
+    uint64_t bytes = 0;
+};
+
+// NOTE: Only counts in programs that link AllocationCounter.cpp, which replaces the global operator new
+ALLOCATIONCOUNTS currentAllocationCounts();
+
+// CLASS: ALLOCATIONSCOPE
+// Attributes the allocations the current thread makes while the scope lives to a tally, which it adds them to when it
+// ends. Scopes nest and an allocation counts for every scope open on the thread, so an outer tally includes the inner
+// ones. The hook only adds to the open scopes, so a scope can wrap any code, even code that allocates on every call.
+class ALLOCATIONSCOPE {
+   private:
+    ALLOCATIONCOUNTS &tally;
+    ALLOCATIONCOUNTS counts;
+    ALLOCATIONSCOPE *parent;
+
+   public:
+    explicit ALLOCATIONSCOPE(ALLOCATIONCOUNTS &tally);
+    ~ALLOCATIONSCOPE();
+    ALLOCATIONSCOPE(const ALLOCATIONSCOPE &) = delete;
+    ALLOCATIONSCOPE &operator=(const ALLOCATIONSCOPE &) = delete;
+
+    // NOTE: Called by operator new for the scopes open on the calling thread
+    static void attribute(size_t bytes);
+};
+
+#endif  // ALLOCATIONCOUNTER_H
@@ -0,0 +1,233 @@
+#include "BenchmarkRunner.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <unordered_map>
+
+#include "AllocationCounter.h"
+
+#ifdef _WIN32
+#include <windows.h>
+// windows.h has to come first
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+using namespace std;
+
+namespace {
+const double CALIBRATION_SECONDS = 0.05;
+// NOTE: Keeps the compiler from dropping the calibration work
+volatile size_t calibrationSink = 0;
+
+size_t calibrationRound() {
+    vector<string> words;
+    words.reserve(1024);
+    uint64_t state = 88172645463325252ULL;
+    for (size_t i = 0; i < 1024; ++i) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        words.push_back(to_string(state));
+    }
+    sort(words.begin(), words.end());
+
+    unordered_map<string, size_t> positions;
+    for (size_t i = 0; i < words.size(); ++i) {
+        positions.emplace(words[i], i);
+    }
+    size_t sum = 0;
+    for (const string &word : words) {
+        sum += positions[word];
+    }
+    return sum;
+}
+}  // namespace
+
+uint64_t peakResidentBytes() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return counters.PeakWorkingSetSize;
+    }
+    return 0;
+#else
+    rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+#ifdef __APPLE__
+    return static_cast<uint64_t>(usage.ru_maxrss);
+#else
+    // NOTE: Linux reports kilobytes
+    return static_cast<uint64_t>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+}
+
+double median(vector<double> samples) {
+    if (samples.empty()) {
+        return 0;
+    }
+    size_t middle = samples.size() / 2;
+    nth_element(samples.begin(), samples.begin() + middle, samples.end());
+    double upper = samples[middle];
+    if (samples.size() % 2 == 1) {
+        return upper;
+    }
+    return (*max_element(samples.begin(), samples.begin() + middle) + upper) / 2;
+}
+
+double medianAbsoluteDeviation(const vector<double> &samples) {
+    double center = median(samples);
+    vector<double> deviations;
+    deviations.reserve(samples.size());
+    for (double sample : samples) {
+        deviations.push_back(fabs(sample - center));
+    }
+    return median(deviations);
+}
+
+double BENCHMARKRESULT::getNanosecondsPerOperation() const {
+    return (this->operations > 0) ? this->seconds * 1e9 / this->operations : 0;
+}
+
+double BENCHMARKRESULT::getOperationsPerSecond() const {
+    return (this->seconds > 0) ? this->operations / this->seconds : 0;
+}
+
+double BENCHMARKRESULT::getAllocationsPerOperation() const {
+    return (this->operations > 0) ? static_cast<double>(this->allocations) / this->operations : 0;
+}
+
+double BENCHMARKRESULT::getAllocatedBytesPerOperation() const {
+    return (this->operations > 0) ? static_cast<double>(this->allocatedBytes) / this->operations : 0;
+}
+
+double BENCHMARKRESULT::getRelativeThroughput() const {
+    return (this->machineSpeed > 0) ? getOperationsPerSecond() / this->machineSpeed : 0;
+}
+
+vector<double> BENCHMARKSERIES::getRelativeThroughputSamples() const {
+    vector<double> samples;
+    for (const BENCHMARKRESULT &run : this->runs) {
+        samples.push_back(run.getRelativeThroughput());
+    }
+    return samples;
+}
+
+vector<double> BENCHMARKSERIES::getOperationsPerSecondSamples() const {
+    vector<double> samples;
+    for (const BENCHMARKRESULT &run : this->runs) {
+        samples.push_back(run.getOperationsPerSecond());
+    }
+    return samples;
+}
+
+json BENCHMARKSERIES::toJson() const {
+    vector<double> throughput = getOperationsPerSecondSamples();
+    vector<double> relative = getRelativeThroughputSamples();
+    vector<double> latency, allocations, allocatedBytes, machineSpeeds;
+    uint64_t peakResident = 0;
+    for (const BENCHMARKRESULT &run : this->runs) {
+        machineSpeeds.push_back(run.machineSpeed);
+        latency.push_back(run.getNanosecondsPerOperation());
+        allocations.push_back(run.getAllocationsPerOperation());
+        allocatedBytes.push_back(run.getAllocatedBytesPerOperation());
+        peakResident = max(peakResident, run.peakResidentBytes);
+    }
+
+    json opsPerSecond = {
+        {"median", median(throughput)}, {"mad", medianAbsoluteDeviation(throughput)}, {"samples", throughput}};
+    json relativeThroughput = {
+        {"median", median(relative)}, {"mad", medianAbsoluteDeviation(relative)}, {"samples", relative}};
+    return json{{"group", this->group},
+                {"repetitions", this->runs.size()},
+                {"ops_per_second", opsPerSecond},
+                {"machine_speed", median(machineSpeeds)},
+                {"relative_throughput", relativeThroughput},
+                {"ns_per_op", median(latency)},
+                {"allocations_per_op", median(allocations)},
+                {"allocated_bytes_per_op", median(allocatedBytes)},
+                {"peak_rss_bytes", peakResident}};
+}
+
+BENCHMARKRUNNER::BENCHMARKRUNNER(double minSeconds, const string &nameFilter, ostream &progress)
+    : minSeconds(minSeconds), nameFilter(nameFilter), progress(progress) {}
+
+bool BENCHMARKRUNNER::isSelected(const string &name) const {
+    bool listed = find(this->onlyNames.begin(), this->onlyNames.end(), name) != this->onlyNames.end();
+    if (!this->onlyNames.empty() && !listed) {
+        return false;
+    }
+    return this->nameFilter.empty() || name.find(this->nameFilter) != string::npos;
+}
+
+void BENCHMARKRUNNER::restrictTo(const vector<string> &names) { this->onlyNames = names; }
+
+BENCHMARKSERIES &BENCHMARKRUNNER::seriesOf(const string &name, const string &group, size_t datasetSize) {
+    for (BENCHMARKSERIES &existing : this->series) {
+        if (existing.name == name && existing.datasetSize == datasetSize) {
+            return existing;
+        }
+    }
+    this->series.push_back(BENCHMARKSERIES{name, group, datasetSize, {}});
+    return this->series.back();
+}
+
+void BENCHMARKRUNNER::run(const string &name, const string &group, size_t datasetSize, const BATCH &batch,
+                          const SETUP &setup) {
+    if (!isSelected(name)) {
+        return;
+    }
+
+    BENCHMARKRESULT result;
+    result.machineSpeed = measureMachineSpeed();
+    do {
+        if (setup) {
+            setup();
+        }
+        ALLOCATIONCOUNTS before = currentAllocationCounts();
+        auto started = chrono::steady_clock::now();
+        result.operations += batch();
+        auto finished = chrono::steady_clock::now();
+        ALLOCATIONCOUNTS after = currentAllocationCounts();
+
+        result.seconds += chrono::duration<double>(finished - started).count();
+        result.allocations += after.count - before.count;
+        result.allocatedBytes += after.bytes - before.bytes;
+        result.iterations++;
+    } while (result.seconds < this->minSeconds);
+    result.peakResidentBytes = peakResidentBytes();
+
+    this->progress << left << setw(28) << name << right << setw(10) << datasetSize << setw(14) << fixed
+                   << setprecision(1) << result.getNanosecondsPerOperation() << " ns/op" << setw(14)
+                   << setprecision(0) << result.getOperationsPerSecond() << " op/s" << setw(10) << setprecision(2)
+                   << result.getAllocationsPerOperation() << " alloc/op" << endl;
+    seriesOf(name, group, datasetSize).runs.push_back(result);
+}
+
+double BENCHMARKRUNNER::measureMachineSpeed() const {
+    size_t rounds = 0;
+    double seconds = 0;
+    auto started = chrono::steady_clock::now();
+    do {
+        calibrationSink = calibrationSink + calibrationRound();
+        ++rounds;
+        seconds = chrono::duration<double>(chrono::steady_clock::now() - started).count();
+    } while (seconds < CALIBRATION_SECONDS);
+    return rounds / seconds;
+}
+
+const vector<BENCHMARKSERIES> &BENCHMARKRUNNER::getSeries() const { return this->series; }
+
+json BENCHMARKRUNNER::toJson() const {
+    json results = json::object();
+    for (const BENCHMARKSERIES &entry : this->series) {
+        results[entry.name][to_string(entry.datasetSize)] = entry.toJson();
+    }
+    return results;
+}
@@ -0,0 +1,95 @@
+#ifndef BENCHMARKRUNNER_H
+#define BENCHMARKRUNNER_H
+
+#include <cstdint>
+#include <functional>
+#include <nlohmann/json.hpp>
+#include <ostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+using json = nlohmann::ordered_json;
+
+// CLASS: BENCHMARKRESULT
+// One run of a benchmark. Time and allocations only cover the measured batches, not their setup. The peak resident
+// size is the process peak once the run finished, so it is only comparable between runs of the same suite.
+struct BENCHMARKRESULT {
+    uint64_t iterations = 0;
+    uint64_t operations = 0;
+    double seconds = 0;
+    uint64_t allocations = 0;
+    uint64_t allocatedBytes = 0;
+    uint64_t peakResidentBytes = 0;
+    // NOTE: Calibration rounds per second measured right before the run, see BENCHMARKRUNNER::measureMachineSpeed
+    double machineSpeed = 0;
+
+    double getNanosecondsPerOperation() const;
+    double getOperationsPerSecond() const;
+    double getAllocationsPerOperation() const;
+    double getAllocatedBytesPerOperation() const;
+    double getRelativeThroughput() const;
+};
+
+// CLASS: BENCHMARKSERIES
+// Every run of one benchmark at one dataset size. Throughput is summarized by its median and median absolute
+// deviation, which a single slow run caused by the machine does not move much. The relative throughput divides each
+// run by the machine speed measured with it, which cancels the machine getting slower or faster over minutes
+// (thermal or power throttling, busy neighbours on a shared host).
+struct BENCHMARKSERIES {
+    string name;
+    // NOTE: What the benchmark measures (load, save, lookup, filter, edit, sort, validate, analytics, ui), the gate
+    // selects by it
+    string group;
+    size_t datasetSize = 0;
+    vector<BENCHMARKRESULT> runs;
+
+    vector<double> getOperationsPerSecondSamples() const;
+    vector<double> getRelativeThroughputSamples() const;
+    json toJson() const;
+};
+
+// CLASS: BENCHMARKRUNNER
+// Repeats a batch until it has run for the minimum time and records the run. A batch returns how many operations it
+// did (trips parsed, lookups, ...), which is what throughput is counted in. Running the same benchmark and size again
+// adds a run to its series.
+class BENCHMARKRUNNER {
+   public:
+    using BATCH = function<uint64_t()>;
+    using SETUP = function<void()>;
+
+   private:
+    double minSeconds;
+    string nameFilter;
+    vector<string> onlyNames;
+    ostream &progress;
+    vector<BENCHMARKSERIES> series;
+
+    BENCHMARKSERIES &seriesOf(const string &name, const string &group, size_t datasetSize);
+    // NOTE: Rounds per second of a fixed mix of string, hashing and sorting work
+    double measureMachineSpeed() const;
+
+   public:
+    BENCHMARKRUNNER(double minSeconds, const string &nameFilter, ostream &progress);
+
+    // NOTE: Names containing the filter run, an empty filter runs everything
+    bool isSelected(const string &name) const;
+    // NOTE: Runs only these benchmarks from now on, on top of the filter
+    void restrictTo(const vector<string> &names);
+    // NOTE: The setup runs before each batch and is not measured
+    void run(const string &name, const string &group, size_t datasetSize, const BATCH &batch,
+             const SETUP &setup = nullptr);
+
+    const vector<BENCHMARKSERIES> &getSeries() const;
+    // NOTE: Keyed by benchmark name, then by dataset size
+    json toJson() const;
+};
+
+// FUNC: Robust statistics over benchmark samples, 0 for no samples
+double median(vector<double> samples);
+double medianAbsoluteDeviation(const vector<double> &samples);
+
+// FUNC: Peak resident set size of this process in bytes, 0 where the platform does not tell
+uint64_t peakResidentBytes();
+
+#endif  // BENCHMARKRUNNER_H
@@ -0,0 +1,316 @@
+#include "Benchmarks.h"
+
+#include <algorithm>
+
+#include "../Managers/ExpenseAnalytics.h"
+#include "../Managers/FileManager.h"
+#include "../Managers/PersonManager.h"
+#include "../Managers/SnapshotArena.h"
+#include "../Managers/TripFilter.h"
+#include "../Managers/TripManager.h"
+
+using namespace std;
+
+namespace {
+// NOTE: Lookups per batch, independent of the dataset size so the batches of every size take comparable time
+const size_t LOOKUPS_PER_BATCH = 100000;
+// NOTE: Trips added or removed per batch, each one records an undo step like an edit in the application does
+const size_t CHANGES_PER_BATCH = 200;
+
+// NOTE: Visits every index once in a scattered order, the same order on every run
+vector<size_t> scatteredOrder(size_t count) {
+    vector<size_t> order(count);
+    size_t stride = 7919;
+    while (count > 1 && (stride % count == 0 || count % stride == 0)) {
+        ++stride;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        order[i] = (i * stride) % count;
+    }
+    return order;
+}
+
+uint64_t fileSize(const string &path) { return filesystem::exists(path) ? filesystem::file_size(path) : 0; }
+
+// CLASS: LOADEDCACHE
+// The trip cache loaded into an arena, as TRIPMANAGER::loadSnapshot does, or onto the global heap. The arena is
+// declared first so the trips are destroyed before it. Only ever destroyed whole: an assignment would replace the
+// arena before the trips built on it.
+struct LOADEDCACHE {
+    unique_ptr<SNAPSHOTARENA> arena;
+    vector<TRIP> trips;
+};
+
+unique_ptr<LOADEDCACHE> loadCache(bool useArena) {
+    unique_ptr<LOADEDCACHE> cache = make_unique<LOADEDCACHE>();
+    if (useArena) {
+        cache->arena = make_unique<SNAPSHOTARENA>();
+        ARENASCOPE scope(*cache->arena);
+        loadTripCacheFile(cache->trips);
+    } else {
+        loadTripCacheFile(cache->trips);
+    }
+    return cache;
+}
+}  // namespace
+
+BENCHMARKDATASET::BENCHMARKDATASET(const filesystem::path &workDirectory, size_t tripCount, uint64_t seed)
+    : directory(workDirectory / ("dataset_" + to_string(tripCount))) {
+    filesystem::remove_all(this->directory);
+    filesystem::create_directories(this->directory);
+    setCacheDirectory(this->directory.string());
+
+    DATASETSPEC spec;
+    spec.seed = seed;
+    spec.tripCount = tripCount;
+    spec.memberCount = max<size_t>(tripCount / 2, 20);
+    spec.hostCount = max<size_t>(tripCount / 20, 5);
+    DATASETGENERATOR generator(spec);
+    generator.writeFiles(getPeopleFile(), getTripsFile());
+    this->summary = generator.getSummary();
+
+    // NOTE: The people import format is also the people cache format. The trip cache goes through an import so it
+    // holds what the application writes.
+    filesystem::copy_file(getPeopleFile(), getPeopleCacheFilePath(), filesystem::copy_options::overwrite_existing);
+    PERSONMANAGER people;
+    vector<TRIP> trips;
+    importTripInfoFromJson(trips, getTripsFile(), &people);
+    updateCacheFile(trips);
+}
+
+BENCHMARKDATASET::~BENCHMARKDATASET() {
+    error_code ignored;
+    filesystem::remove_all(this->directory, ignored);
+}
+
+string BENCHMARKDATASET::getPeopleFile() const { return (this->directory / "people.json").string(); }
+
+string BENCHMARKDATASET::getTripsFile() const { return (this->directory / "trips.json").string(); }
+
+string BENCHMARKDATASET::getScratchFile() const { return (this->directory / "scratch.json").string(); }
+
+const DATASETSUMMARY &BENCHMARKDATASET::getSummary() const { return this->summary; }
+
+// FUNC: Import and export files, and the cache files loaded at startup and written after changes
+void runPersistenceBenchmarks(BENCHMARKRUNNER &runner, const BENCHMARKDATASET &dataset) {
+    size_t size = dataset.getSummary().trips;
+    PERSONMANAGER people;
+    vector<TRIP> imported;
+
+    runner.run("trip_import", "load", size, [&]() -> uint64_t {
+        importTripInfoFromJson(imported, dataset.getTripsFile(), &people);
+        return imported.size();
+    });
+    if (imported.empty()) {
+        importTripInfoFromJson(imported, dataset.getTripsFile(), &people);
+    }
+
+    runner.run("trip_export", "save", size, [&]() -> uint64_t {
+        exportTripsInfoToJson(imported, dataset.getScratchFile());
+        return imported.size();
+    });
+
+    runner.run("trip_cache_load", "load", size, [&]() -> uint64_t {
+        TRIPMANAGER trips;
+        return trips.loadSnapshot();
+    });
+
+    // NOTE: Arena against global heap, loading and freeing measured apart. Freeing is where they differ most: the
+    // heap returns every string and list of every trip on its own, the arena returns a few large blocks.
+    for (bool useArena : {true, false}) {
+        string allocator = useArena ? "arena" : "heap";
+        unique_ptr<LOADEDCACHE> loaded;
+        runner.run(
+            "trip_cache_load_" + allocator, "load", size,
+            [&]() -> uint64_t {
+                loaded = loadCache(useArena);
+                return loaded->trips.size();
+            },
+            [&]() { loaded.reset(); });
+        runner.run(
+            "trip_cache_teardown_" + allocator, "load", size,
+            [&]() -> uint64_t {
+                size_t count = loaded->trips.size();
+                loaded.reset();
+                return count;
+            },
+            [&]() { loaded = loadCache(useArena); });
+    }
+
+    TRIPMANAGER trips;
+    trips.loadSnapshot();
+    TRIPSNAPSHOT snapshot = trips.getAllTrips();
+    uint64_t cacheBytes = fileSize(getCacheFilePath());
+    runner.run("trip_cache_save", "save", size, [&]() -> uint64_t {
+        updateCacheFile(snapshot);
+        return snapshot.size();
+    });
+    if (fileSize(getCacheFilePath()) != cacheBytes) {
+        throw runtime_error("trip cache changed size when saved unchanged");
+    }
+
+    runner.run("people_cache_load", "load", size, []() -> uint64_t {
+        PERSONMANAGER loaded;
+        return loaded.getPersonCount();
+    });
+
+    PEOPLESNAPSHOT peopleSnapshot = people.getSnapshot();
+    runner.run("people_cache_save", "save", size, [&]() -> uint64_t {
+        updatePeopleCacheFile(peopleSnapshot.getMembers(), peopleSnapshot.getHosts());
+        return peopleSnapshot.getMembers().size() + peopleSnapshot.getHosts().size();
+    });
+}
+
+// FUNC: Lookups, additions and removals on a store loaded from the cache like at startup
+void runTripManagerBenchmarks(BENCHMARKRUNNER &runner, const BENCHMARKDATASET &dataset) {
+    size_t size = dataset.getSummary().trips;
+    PERSONMANAGER people;
+    TRIPMANAGER trips;
+    trips.loadSnapshot();
+
+    TRIPSNAPSHOT loaded = trips.getAllTrips();
+    vector<string> tripIDs;
+    tripIDs.reserve(loaded.size());
+    for (size_t index : scatteredOrder(loaded.size())) {
+        tripIDs.push_back(loaded[index].getID());
+    }
+
+    runner.run("trip_find_by_id", "lookup", size, [&]() -> uint64_t {
+        size_t found = 0;
+        for (size_t i = 0; i < LOOKUPS_PER_BATCH; ++i) {
+            found += trips.findTripById(tripIDs[i % tripIDs.size()]) != nullptr;
+        }
+        if (found != LOOKUPS_PER_BATCH) {
+            throw runtime_error("trip lookup missed a stored trip");
+        }
+        return LOOKUPS_PER_BATCH;
+    });
+
+    // NOTE: Copies of stored trips, addTrip gives each one a free ID next to the original's
+    vector<TRIP> additions;
+    for (size_t i = 0; i < CHANGES_PER_BATCH; ++i) {
+        additions.push_back(loaded[i % loaded.size()]);
+    }
+    vector<string> addedIDs;
+    auto removeAdded = [&]() {
+        for (const string &id : addedIDs) {
+            trips.removeTrip(id);
+        }
+        addedIDs.clear();
+    };
+    auto addAll = [&]() {
+        for (const TRIP &trip : additions) {
+            addedIDs.push_back(trips.addTrip(trip));
+        }
+    };
+
+    runner.run(
+        "trip_add", "edit", size,
+        [&]() -> uint64_t {
+            addAll();
+            return additions.size();
+        },
+        removeAdded);
+    removeAdded();
+
+    runner.run(
+        "trip_remove", "edit", size,
+        [&]() -> uint64_t {
+            removeAdded();
+            return additions.size();
+        },
+        addAll);
+    removeAdded();
+}
+
+// FUNC: Person lookups and the integrity check
+void runPersonManagerBenchmarks(BENCHMARKRUNNER &runner, const BENCHMARKDATASET &dataset) {
+    size_t size = dataset.getSummary().trips;
+    PERSONMANAGER people;
+    PEOPLESNAPSHOT snapshot = people.getSnapshot();
+
+    vector<string> memberIDs;
+    for (size_t index : scatteredOrder(snapshot.getMembers().size())) {
+        memberIDs.push_back(snapshot.getMembers()[index].getID());
+    }
+    vector<string> hostIDs;
+    for (size_t index : scatteredOrder(snapshot.getHosts().size())) {
+        hostIDs.push_back(snapshot.getHosts()[index].getID());
+    }
+
+    const PERSONMANAGER &reader = people;
+    runner.run("person_find_by_id", "lookup", size, [&]() -> uint64_t {
+        size_t found = 0;
+        for (size_t i = 0; i < LOOKUPS_PER_BATCH; ++i) {
+            found += (i % 4 == 3) ? reader.findHostById(hostIDs[i % hostIDs.size()]) != nullptr
+                                  : reader.findMemberById(memberIDs[i % memberIDs.size()]) != nullptr;
+        }
+        if (found != LOOKUPS_PER_BATCH) {
+            throw runtime_error("person lookup missed a stored person");
+        }
+        return LOOKUPS_PER_BATCH;
+    });
+
+    runner.run("people_validate", "validate", size, [&]() -> uint64_t {
+        if (!people.validateDataIntegrity()) {
+            throw runtime_error("generated people failed validation");
+        }
+        return people.getPersonCount();
+    });
+}
+
+// FUNC: The filter dialog's criteria and sort orders over the whole trip list
+void runQueryBenchmarks(BENCHMARKRUNNER &runner, const BENCHMARKDATASET &dataset) {
+    size_t size = dataset.getSummary().trips;
+    TRIPMANAGER trips;
+    trips.loadSnapshot();
+    TRIPSNAPSHOT snapshot = trips.getAllTrips();
+
+    TRIPFILTER filter;
+    filter.destinationText = "a";
+    filter.statuses = {STATUS::Completed, STATUS::Planned};
+    filter.keywords = splitKeywords("nhom, gia dinh");
+    filter.filterDates = true;
+    filter.startFrom = DATE(1, 1, 2023);
+    filter.startTo = DATE(31, 12, 2024);
+    filter.endFrom = DATE(1, 1, 2023);
+    filter.endTo = DATE(31, 12, 2024);
+    runner.run("trip_filter", "filter", size, [&]() -> uint64_t {
+        snapshot.filter([&filter](const TRIP &trip) { return filter.matches(trip); });
+        return snapshot.size();
+    });
+
+    runner.run("trip_sort_start_date", "sort", size, [&]() -> uint64_t {
+        return sortTrips(snapshot, TRIPSORTKEY::StartDate, true).size();
+    });
+
+    runner.run("trip_sort_destination_desc", "sort", size, [&]() -> uint64_t {
+        return sortTrips(snapshot, TRIPSORTKEY::Destination, false).size();
+    });
+
+    runner.run("trip_sort_status", "sort", size, [&]() -> uint64_t {
+        return sortTrips(snapshot, TRIPSORTKEY::Status, true).size();
+    });
+}
+
+// FUNC: Projecting every expense into columns and a group-by with percentiles over them
+void runAnalyticsBenchmarks(BENCHMARKRUNNER &runner, const BENCHMARKDATASET &dataset) {
+    size_t size = dataset.getSummary().trips;
+    PERSONMANAGER people;
+    TRIPMANAGER trips;
+    trips.loadSnapshot();
+    trips.loadAllTripDetails(&people);
+    TRIPSNAPSHOT snapshot = trips.getAllTrips();
+
+    runner.run("expense_projection", "analytics", size,
+               [&]() -> uint64_t { return projectExpenses(snapshot).size(); });
+
+    EXPENSECOLUMNS columns = projectExpenses(snapshot);
+    ANALYTICSQUERY query;
+    query.groupBy = {GROUPKEY::Destination, GROUPKEY::Month};
+    query.aggregates = {parseAggregate("sum"), parseAggregate("avg"), parseAggregate("p90")};
+    runner.run("expense_group_by", "analytics", size, [&]() -> uint64_t {
+        runAnalytics(columns, query);
+        return columns.size();
+    });
+}
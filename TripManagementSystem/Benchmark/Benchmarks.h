@@ -0,0 +1,40 @@
+#ifndef BENCHMARKS_H
+#define BENCHMARKS_H
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+#include "../Managers/DatasetGenerator.h"
+#include "BenchmarkRunner.h"
+
+using namespace std;
+
+// CLASS: BENCHMARKDATASET
+// A generated dataset of one size, as import files and as the cache files the application starts from. It lives in
+// its own folder, which becomes the cache directory while the dataset exists and is removed with it.
+class BENCHMARKDATASET {
+   private:
+    filesystem::path directory;
+    DATASETSUMMARY summary;
+
+   public:
+    BENCHMARKDATASET(const filesystem::path &workDirectory, size_t tripCount, uint64_t seed);
+    ~BENCHMARKDATASET();
+    BENCHMARKDATASET(const BENCHMARKDATASET &) = delete;
+    BENCHMARKDATASET &operator=(const BENCHMARKDATASET &) = delete;
+
+    string getPeopleFile() const;
+    string getTripsFile() const;
+    string getScratchFile() const;
+    const DATASETSUMMARY &getSummary() const;
+};
+
+// FUNC: Every benchmark of the managers and the persistence layer over one dataset
+void runPersistenceBenchmarks(BENCHMARKRUNNER &runner, const BENCHMARKDATASET &dataset);
+void runTripManagerBenchmarks(BENCHMARKRUNNER &runner, const BENCHMARKDATASET &dataset);
+void runPersonManagerBenchmarks(BENCHMARKRUNNER &runner, const BENCHMARKDATASET &dataset);
+void runQueryBenchmarks(BENCHMARKRUNNER &runner, const BENCHMARKDATASET &dataset);
+void runAnalyticsBenchmarks(BENCHMARKRUNNER &runner, const BENCHMARKDATASET &dataset);
+
+#endif  // BENCHMARKS_H
@@ -0,0 +1,184 @@
+#include "RegressionGate.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+
+using namespace std;
+
+namespace {
+// NOTE: Scales a MAD to the standard deviation it estimates for normally distributed noise
+const double MAD_TO_SIGMA = 1.4826;
+
+const json &resultsOf(const json &report, const string &which) {
+    if (!report.is_object() || report.value("suite", "") != "tripbench" || !report.contains("results") ||
+        !report["results"].is_object()) {
+        throw runtime_error("the " + which + " is not a tripbench report");
+    }
+    return report["results"];
+}
+
+double medianOf(const json &entry, const char *measure = "ops_per_second") {
+    return entry.contains(measure) ? entry[measure].value("median", 0.0) : 0.0;
+}
+
+double sigmaOf(const json &entry, const char *measure) {
+    return entry.contains(measure) ? entry[measure].value("mad", 0.0) * MAD_TO_SIGMA : 0.0;
+}
+
+const char *verdictLabel(GATEFINDING::VERDICT verdict) {
+    switch (verdict) {
+        case GATEFINDING::VERDICT::Regressed:
+            return "REGRESSED";
+        case GATEFINDING::VERDICT::Unconfirmed:
+            return "unconfirmed";
+        case GATEFINDING::VERDICT::Slower:
+            return "slower";
+        case GATEFINDING::VERDICT::Improved:
+            return "improved";
+        case GATEFINDING::VERDICT::NotRun:
+            return "not run";
+        case GATEFINDING::VERDICT::New:
+            return "new";
+        default:
+            return "ok";
+    }
+}
+}  // namespace
+
+bool GATEPOLICY::isGated(const string &group) const {
+    return find(this->groups.begin(), this->groups.end(), group) != this->groups.end();
+}
+
+bool GATEREPORT::hasRegressions() const {
+    return any_of(this->findings.begin(), this->findings.end(),
+                  [](const GATEFINDING &finding) { return finding.verdict == GATEFINDING::VERDICT::Regressed; });
+}
+
+vector<GATEFINDING> GATEREPORT::getRegressions() const {
+    vector<GATEFINDING> regressions;
+    copy_if(this->findings.begin(), this->findings.end(), back_inserter(regressions),
+            [](const GATEFINDING &finding) { return finding.verdict == GATEFINDING::VERDICT::Regressed; });
+    return regressions;
+}
+
+void GATEREPORT::confirmWith(const GATEREPORT &rerun) {
+    for (GATEFINDING &finding : this->findings) {
+        if (finding.verdict != GATEFINDING::VERDICT::Regressed) {
+            continue;
+        }
+        bool repeated = any_of(rerun.findings.begin(), rerun.findings.end(), [&](const GATEFINDING &again) {
+            return again.name == finding.name && again.datasetSize == finding.datasetSize &&
+                   again.verdict == GATEFINDING::VERDICT::Regressed;
+        });
+        if (!repeated) {
+            finding.verdict = GATEFINDING::VERDICT::Unconfirmed;
+        }
+    }
+}
+
+string GATEREPORT::toString() const {
+    vector<GATEFINDING> ordered = this->findings;
+    stable_sort(ordered.begin(), ordered.end(), [](const GATEFINDING &a, const GATEFINDING &b) {
+        return (a.verdict == GATEFINDING::VERDICT::Regressed) > (b.verdict == GATEFINDING::VERDICT::Regressed);
+    });
+
+    ostringstream text;
+    if (this->machineNormalized) {
+        text << "Changes are relative to the machine speed measured with each run\n";
+    }
+    size_t regressions = 0;
+    size_t notRun = 0;
+    for (const GATEFINDING &finding : ordered) {
+        // NOTE: Counted only, a filtered run would list most of the baseline
+        if (finding.verdict == GATEFINDING::VERDICT::NotRun) {
+            ++notRun;
+            continue;
+        }
+        text << left << setw(12) << verdictLabel(finding.verdict) << setw(28) << finding.name << right << setw(10)
+             << finding.datasetSize << "  " << setw(8) << finding.group;
+        if (finding.verdict == GATEFINDING::VERDICT::New) {
+            text << '\n';
+            continue;
+        }
+        text << "  " << fixed << setprecision(0) << setw(14) << finding.baselineOpsPerSecond << " -> " << setw(14)
+             << finding.currentOpsPerSecond << " op/s  " << showpos << setprecision(1) << setw(7)
+             << finding.change * 100 << "%" << noshowpos << "  (noise " << finding.noise * 100 << "%)\n";
+        regressions += (finding.verdict == GATEFINDING::VERDICT::Regressed);
+    }
+    if (notRun > 0) {
+        text << notRun << " baseline benchmark(s) not run\n";
+    }
+    text << (regressions > 0 ? to_string(regressions) + " regression(s) against the baseline"
+                             : string("No regressions against the baseline"))
+         << '\n';
+    return text.str();
+}
+
+GATEREPORT compareToBaseline(const json &baseline, const json &current, const GATEPOLICY &policy) {
+    const json &baselineResults = resultsOf(baseline, "baseline");
+    const json &currentResults = resultsOf(current, "current run");
+    if (baseline.value("seed", 0ULL) != current.value("seed", 0ULL)) {
+        throw runtime_error("the baseline was made with seed " + to_string(baseline.value("seed", 0ULL)) +
+                            ", the current run with " + to_string(current.value("seed", 0ULL)));
+    }
+
+    GATEREPORT report;
+    for (const auto &[name, sizes] : baselineResults.items()) {
+        for (const auto &[size, entry] : sizes.items()) {
+            GATEFINDING finding;
+            finding.name = name;
+            finding.group = entry.value("group", "");
+            finding.datasetSize = stoull(size);
+            finding.baselineOpsPerSecond = medianOf(entry);
+
+            if (!currentResults.contains(name) || !currentResults[name].contains(size)) {
+                finding.verdict = GATEFINDING::VERDICT::NotRun;
+                report.findings.push_back(finding);
+                continue;
+            }
+
+            const json &now = currentResults[name][size];
+            finding.currentOpsPerSecond = medianOf(now);
+            if (finding.baselineOpsPerSecond <= 0) {
+                finding.verdict = GATEFINDING::VERDICT::New;
+                report.findings.push_back(finding);
+                continue;
+            }
+
+            // NOTE: Falls back to the absolute throughput when a report has no machine speeds
+            const char *measure = "ops_per_second";
+            if (medianOf(entry, "relative_throughput") > 0 && medianOf(now, "relative_throughput") > 0) {
+                measure = "relative_throughput";
+                report.machineNormalized = true;
+            }
+            double before = medianOf(entry, measure);
+            finding.change = (medianOf(now, measure) - before) / before;
+            finding.noise = hypot(sigmaOf(entry, measure), sigmaOf(now, measure)) / before;
+            double threshold = max(policy.tolerance, policy.noiseFactor * finding.noise);
+            if (finding.change < -threshold) {
+                finding.verdict =
+                    policy.isGated(finding.group) ? GATEFINDING::VERDICT::Regressed : GATEFINDING::VERDICT::Slower;
+            } else if (finding.change > threshold) {
+                finding.verdict = GATEFINDING::VERDICT::Improved;
+            }
+            report.findings.push_back(finding);
+        }
+    }
+
+    for (const auto &[name, sizes] : currentResults.items()) {
+        for (const auto &[size, entry] : sizes.items()) {
+            if (!baselineResults.contains(name) || !baselineResults[name].contains(size)) {
+                GATEFINDING finding;
+                finding.name = name;
+                finding.group = entry.value("group", "");
+                finding.datasetSize = stoull(size);
+                finding.currentOpsPerSecond = medianOf(entry);
+                finding.verdict = GATEFINDING::VERDICT::New;
+                report.findings.push_back(finding);
+            }
+        }
+    }
+    return report;
+}
@@ -0,0 +1,58 @@
+#ifndef REGRESSIONGATE_H
+#define REGRESSIONGATE_H
+
+#include <string>
+#include <vector>
+
+#include "BenchmarkRunner.h"
+
+using namespace std;
+
+// CLASS: GATEPOLICY
+// When a drop in throughput counts as a regression. It has to exceed the tolerance and also noiseFactor times the
+// combined noise of both medians, estimated from their MADs; with single runs only the tolerance applies. Throughput
+// is compared relative to the machine speed measured with each run when both reports have it.
+struct GATEPOLICY {
+    double tolerance = 0.15;
+    double noiseFactor = 3.0;
+    vector<string> groups = {"load", "save", "lookup", "filter", "ui"};
+
+    bool isGated(const string &group) const;
+};
+
+// CLASS: GATEFINDING
+// One benchmark and size present in the baseline, the current run or both
+struct GATEFINDING {
+    // NOTE: Slower is a drop beyond the thresholds in a group the policy does not gate, Unconfirmed a regression that
+    // did not show again when the benchmark was run once more
+    enum class VERDICT { Regressed, Unconfirmed, Slower, Improved, Unchanged, NotRun, New };
+
+    string name;
+    string group;
+    size_t datasetSize = 0;
+    double baselineOpsPerSecond = 0;
+    double currentOpsPerSecond = 0;
+    // NOTE: Relative change of the median throughput, and the noise it was held against, both as fractions
+    double change = 0;
+    double noise = 0;
+    VERDICT verdict = VERDICT::Unchanged;
+};
+
+// CLASS: GATEREPORT
+struct GATEREPORT {
+    vector<GATEFINDING> findings;
+    bool machineNormalized = false;
+
+    bool hasRegressions() const;
+    vector<GATEFINDING> getRegressions() const;
+    // NOTE: Regressions that are not regressions in the second comparison as well become Unconfirmed
+    void confirmWith(const GATEREPORT &rerun);
+    // NOTE: One aligned line per finding, regressions first, then a summary line
+    string toString() const;
+};
+
+// FUNC: Compare two tripbench reports. Throws runtime_error when they were not made with the same seed, whose
+// datasets differ, or when one is not a tripbench report.
+GATEREPORT compareToBaseline(const json &baseline, const json &current, const GATEPOLICY &policy);
+
+#endif  // REGRESSIONGATE_H
@@ -0,0 +1,307 @@
+#include "StressTest.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <thread>
+
+#include "../Managers/PersonManager.h"
+#include "../Managers/TripManager.h"
+
+using namespace std;
+
+namespace {
+// NOTE: Failures kept for the report, the first ones tell what broke
+const size_t MAX_REPORTED_FAILURES = 20;
+// NOTE: Share handles a reader holds on to and reads again while the writer goes on
+const size_t HELD_HANDLES = 16;
+// NOTE: Reader operations between two checks of the snapshot the reader holds
+const size_t SNAPSHOT_CHECK_INTERVAL = 64;
+
+// CLASS: FAILURELOG
+// Broken invariants reported by any of the threads. The first failure stops every thread.
+class FAILURELOG {
+   private:
+    mutex failuresMutex;
+    vector<string> failures;
+    atomic<bool> failed{false};
+
+   public:
+    void report(const string &failure) {
+        lock_guard<mutex> lock(this->failuresMutex);
+        this->failed = true;
+        if (this->failures.size() < MAX_REPORTED_FAILURES) {
+            this->failures.push_back(failure);
+        }
+    }
+    bool hasFailed() const { return this->failed; }
+    vector<string> getFailures() {
+        lock_guard<mutex> lock(this->failuresMutex);
+        return this->failures;
+    }
+};
+
+// NOTE: What a reader saw of a trip, compared when it reads the same trip again
+string fingerprint(const TRIP &trip) {
+    return trip.getID() + '|' + trip.getDescription() + '|' + to_string(trip.getTotalExpense());
+}
+
+size_t hashSnapshot(const TRIPSNAPSHOT &snapshot, size_t &count) {
+    size_t hash = 0;
+    count = 0;
+    for (const TRIP &trip : snapshot) {
+        hash = hash * 31 + std::hash<string>()(fingerprint(trip));
+        ++count;
+    }
+    return hash;
+}
+
+bool isSortedUnique(const vector<IDKEY> &keys) {
+    return adjacent_find(keys.begin(), keys.end(), [](const IDKEY &a, const IDKEY &b) { return !(a < b); }) ==
+           keys.end();
+}
+
+// FUNC: One reader thread, cycling through snapshots, share handles, person lookups and index queries
+uint64_t runReader(const TRIPMANAGER &trips, const PERSONMANAGER &people, const vector<string> &tripIDs,
+                   const vector<IDKEY> &memberKeys, unsigned seed, const atomic<bool> &stop, FAILURELOG &log) {
+    mt19937 random(seed);
+    vector<pair<shared_ptr<const TRIP>, string>> held;
+    TRIPSNAPSHOT heldSnapshot = trips.getAllTrips();
+    size_t heldCount = 0;
+    size_t heldHash = hashSnapshot(heldSnapshot, heldCount);
+    uint64_t lastEpoch = heldSnapshot.getEpoch();
+
+    uint64_t reads = 0;
+    while (!stop && !log.hasFailed()) {
+        const string &tripID = tripIDs[random() % tripIDs.size()];
+        const IDKEY &memberKey = memberKeys[random() % memberKeys.size()];
+        switch (reads % 4) {
+            case 0: {
+                TRIPSNAPSHOT snapshot = trips.getAllTrips();
+                if (snapshot.getEpoch() < lastEpoch) {
+                    log.report("snapshot epoch went back from " + to_string(lastEpoch) + " to " +
+                               to_string(snapshot.getEpoch()));
+                }
+                lastEpoch = snapshot.getEpoch();
+                size_t count = 0;
+                for (const TRIP &trip : snapshot) {
+                    count += trip.getID().empty() ? 0 : 1;
+                }
+                if (count != snapshot.size()) {
+                    log.report("snapshot of " + to_string(snapshot.size()) + " trips iterated " + to_string(count));
+                }
+                break;
+            }
+            case 1: {
+                shared_ptr<const TRIP> trip = trips.shareTripById(tripID);
+                if (!trip) {
+                    break;
+                }
+                if (trip->getID() != tripID) {
+                    log.report("share handle for " + tripID + " holds trip " + trip->getID());
+                }
+                if (held.size() < HELD_HANDLES) {
+                    held.emplace_back(trip, fingerprint(*trip));
+                } else {
+                    held[random() % HELD_HANDLES] = make_pair(trip, fingerprint(*trip));
+                }
+                break;
+            }
+            case 2: {
+                const MEMBER *member = people.findMemberByKey(memberKey);
+                shared_ptr<const MEMBER> shared = people.shareMemberByKey(memberKey);
+                if (!member || member->getKey() != memberKey || !shared || shared->getKey() != memberKey) {
+                    log.report("person lookup missed member " + memberKey.str());
+                }
+                break;
+            }
+            default: {
+                vector<IDKEY> joined = trips.getTripKeysOfMember(memberKey.str());
+                vector<IDKEY> members = trips.getMemberKeysOfTrip(tripID);
+                trips.isMemberOfTrip(tripID, memberKey.str());
+                if (!isSortedUnique(joined) || !isSortedUnique(members)) {
+                    log.report("index query for " + tripID + " / " + memberKey.str() + " returned unsorted keys");
+                }
+                break;
+            }
+        }
+
+        // NOTE: Held handles and the held snapshot read the same however the store changed since they were taken
+        if (!held.empty()) {
+            const auto &handle = held[reads % held.size()];
+            if (fingerprint(*handle.first) != handle.second) {
+                log.report("share handle of trip " + handle.first->getID() + " changed under its reader");
+            }
+        }
+        if (++reads % SNAPSHOT_CHECK_INTERVAL == 0) {
+            size_t count = 0;
+            if (hashSnapshot(heldSnapshot, count) != heldHash || count != heldCount) {
+                log.report("snapshot at epoch " + to_string(heldSnapshot.getEpoch()) + " changed under its reader");
+            }
+            heldSnapshot = trips.getAllTrips();
+            heldHash = hashSnapshot(heldSnapshot, heldCount);
+        }
+    }
+    return reads;
+}
+
+// FUNC: The writer thread, cycling through add, update, remove and undo or redo of a random trip
+uint64_t runWriter(TRIPMANAGER &trips, unsigned seed, const atomic<bool> &stop, FAILURELOG &log) {
+    mt19937 random(seed);
+    uint64_t writes = 0;
+    while (!stop && !log.hasFailed()) {
+        TRIPSNAPSHOT snapshot = trips.getAllTrips();
+        if (snapshot.empty()) {
+            log.report("the writer emptied the store");
+            break;
+        }
+        size_t before = snapshot.size();
+        size_t expected = before;
+        const TRIP &trip = snapshot[random() % before];
+        string change = "stress change " + to_string(writes);
+
+        switch (writes % 5) {
+            case 0: {
+                TRIP copy = trip;
+                copy.setDescription(change);
+                trips.addTrip(copy);
+                expected = before + 1;
+                break;
+            }
+            case 1: {
+                TRIP updated = trip;
+                updated.setDescription(change);
+                if (!trips.updateTrip(trip, updated)) {
+                    log.report("update of stored trip " + trip.getID() + " failed");
+                }
+                break;
+            }
+            case 2:
+                if (!trips.removeTrip(trip.getID())) {
+                    log.report("removal of stored trip " + trip.getID() + " failed");
+                }
+                expected = before - 1;
+                break;
+            case 3:
+                trips.undo();
+                break;
+            default:
+                trips.redo();
+                break;
+        }
+
+        // NOTE: Undo and redo may change the count either way, the other writes by exactly one
+        bool countKnown = writes % 5 < 3;
+        if (countKnown && trips.getTripCount() != expected) {
+            log.report("trip count " + to_string(trips.getTripCount()) + " after a write, expected " +
+                       to_string(expected));
+        }
+        if (snapshot.size() != before) {
+            log.report("the writer's own snapshot changed size during a write");
+        }
+        ++writes;
+    }
+    return writes;
+}
+
+// NOTE: Runs a thread body, turning an exception into a failure so it does not end the process
+void guarded(FAILURELOG &log, const function<void()> &body) {
+    try {
+        body();
+    } catch (const exception &e) {
+        log.report(string("exception: ") + e.what());
+    }
+}
+}  // namespace
+
+bool STRESSRESULT::passed() const { return this->failures.empty(); }
+
+string STRESSRESULT::toString() const {
+    ostringstream out;
+    out << fixed << setprecision(1);
+    out << "Stress test: " << this->readerCount << " reader(s) against one writer for " << this->seconds << " s\n";
+    out << "  reads  " << setw(12) << this->reads << "  (" << this->reads / max(this->seconds, 1e-9) << " per s)\n";
+    out << "  writes " << setw(12) << this->writes << "  (" << this->writes / max(this->seconds, 1e-9) << " per s)\n";
+    for (const string &failure : this->failures) {
+        out << "  FAIL  " << failure << '\n';
+    }
+    out << (passed() ? "All invariants held" : to_string(this->failures.size()) + " invariant(s) broken") << '\n';
+    return out.str();
+}
+
+STRESSRESULT runStressTest(const BENCHMARKDATASET &dataset, unsigned readerCount, double seconds) {
+    // NOTE: The store reads the dataset's cache files, its folder is the cache directory while it exists
+    PERSONMANAGER people;
+    TRIPMANAGER trips;
+    trips.loadSnapshot();
+
+    vector<string> tripIDs;
+    for (const TRIP &trip : trips.getAllTrips()) {
+        tripIDs.push_back(trip.getID());
+    }
+    vector<IDKEY> memberKeys;
+    for (const MEMBER &member : people.getSnapshot().getMembers()) {
+        memberKeys.push_back(member.getKey());
+    }
+    if (tripIDs.empty() || memberKeys.empty()) {
+        throw runtime_error("the stress test needs trips and members, the dataset of " +
+                            to_string(dataset.getSummary().trips) + " trips has none");
+    }
+
+    FAILURELOG log;
+    atomic<bool> stop{false};
+    vector<uint64_t> readCounts(readerCount, 0);
+    uint64_t writes = 0;
+
+    auto started = chrono::steady_clock::now();
+    vector<thread> readers;
+    for (unsigned reader = 0; reader < readerCount; ++reader) {
+        readers.emplace_back([&, reader]() {
+            guarded(log, [&]() {
+                readCounts[reader] = runReader(trips, people, tripIDs, memberKeys, reader + 1, stop, log);
+            });
+        });
+    }
+    thread writer([&]() { guarded(log, [&]() { writes = runWriter(trips, 0, stop, log); }); });
+
+    auto deadline = started + chrono::duration<double>(seconds);
+    while (chrono::steady_clock::now() < deadline && !log.hasFailed()) {
+        this_thread::sleep_for(chrono::milliseconds(10));
+    }
+    stop = true;
+    writer.join();
+    for (thread &reader : readers) {
+        reader.join();
+    }
+    double elapsed = chrono::duration<double>(chrono::steady_clock::now() - started).count();
+
+    // NOTE: Once the threads are done the indexes must match the list the writer left
+    for (const string &problem : trips.findIntegrityProblems(&people)) {
+        log.report("after the run: " + problem);
+    }
+    TRIPSNAPSHOT final = trips.getAllTrips();
+    if (final.size() != trips.getTripCount()) {
+        log.report("after the run: snapshot of " + to_string(final.size()) + " trips, store count " +
+                   to_string(trips.getTripCount()));
+    }
+    for (const TRIP &trip : final) {
+        if (trips.shareTripById(trip.getID()).get() != &trip) {
+            log.report("after the run: trip " + trip.getID() + " is not found by its ID");
+        }
+    }
+
+    STRESSRESULT result;
+    result.readerCount = readerCount;
+    result.seconds = elapsed;
+    for (uint64_t reads : readCounts) {
+        result.reads += reads;
+    }
+    result.writes = writes;
+    result.failures = log.getFailures();
+    return result;
+}
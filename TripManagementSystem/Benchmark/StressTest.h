@@ -0,0 +1,33 @@
+#ifndef STRESSTEST_H
+#define STRESSTEST_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Benchmarks.h"
+
+using namespace std;
+
+// NOTE: The stress test runs on the dataset of this many trips
+const size_t STRESS_DATASET_SIZE = 2000;
+
+// CLASS: STRESSRESULT
+// Outcome of reader threads running against a writer on one store. Any broken invariant is a failure, whatever
+// the counts.
+struct STRESSRESULT {
+    unsigned readerCount = 0;
+    double seconds = 0;
+    uint64_t reads = 0;
+    uint64_t writes = 0;
+    vector<string> failures;
+
+    bool passed() const;
+    string toString() const;
+};
+
+// FUNC: Readers take snapshots, share handles, person lookups and index queries while one writer adds, updates,
+// removes and undoes trips, for the given time. The store is checked once more after the threads stop.
+STRESSRESULT runStressTest(const BENCHMARKDATASET &dataset, unsigned readerCount, double seconds);
+
+#endif  // STRESSTEST_H
@@ -0,0 +1,37 @@
+# Benchmarks of the managers and the persistence layer on generated datasets, results as JSON, and the gate
+# comparing them to a baseline
+CONFIG += c++17 console debug_and_release
+CONFIG -= qt app_bundle
+
+TARGET = tripbench
+TEMPLATE = app
+
+include(../core/core.pri)
+
+CONFIG(debug, debug|release) {
+    DESTDIR = $$OUT_PWD/../debug
+}
+
+CONFIG(release, debug|release) {
+    DESTDIR = $$OUT_PWD/../release
+}
+
+SOURCES += main.cpp \
+    AllocationBudgets.cpp \
+    AllocationCounter.cpp \
+    BenchmarkRunner.cpp \
+    Benchmarks.cpp \
+    RegressionGate.cpp \
+    StressTest.cpp
+
+HEADERS += AllocationBudgets.h \
+    AllocationCounter.h \
+    BenchmarkRunner.h \
+    Benchmarks.h \
+    RegressionGate.h \
+    StressTest.h
+
+# Peak working set size
+win32: LIBS += -lpsapi
+
+QMAKE_CXXFLAGS += -Wall -Wextra
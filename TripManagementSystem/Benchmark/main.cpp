@@ -0,0 +1,305 @@
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "AllocationBudgets.h"
+#include "Benchmarks.h"
+#include "RegressionGate.h"
+#include "StressTest.h"
+
+#ifdef TRIP_UI_BENCHMARKS
+#include <QApplication>
+
+#include "UIBenchmarks.h"
+#endif
+
+using namespace std;
+
+namespace {
+const char *const USAGE =
+    "Usage: tripbench [--sizes <n,n,...>] [--filter <text>] [--min-time-ms <ms>] [--repetitions <n>] [--seed <n>]\n"
+    "                 [--output <file>] [--work-dir <dir>]\n"
+    "                 [--baseline <file> [--tolerance <percent>] [--gate-groups <group,group,...>]]\n"
+    "       tripbench budgets [--seed <n>] [--work-dir <dir>]\n"
+    "       tripbench stress [--readers <n>] [--duration-ms <ms>] [--seed <n>] [--work-dir <dir>]\n"
+    "\n"
+    "Runs the benchmarks of the managers and the persistence layer on generated datasets of each size (number of\n"
+    "trips) and writes the results as JSON to the output file, or to stdout. Progress goes to stderr.\n"
+    "\n"
+    "With --baseline the median throughput of each benchmark, relative to the machine speed, is compared to a report\n"
+    "written earlier. A drop larger than the tolerance (15% by default) and than three times the measured noise in\n"
+    "the gated groups (load, save, lookup, filter and ui by default) is run once more, and if it shows again the\n"
+    "differences are printed to stderr and the exit code is 1.\n"
+    "\n"
+    "tripuibench runs the same suite plus the benchmarks of the main window (group ui) on Qt's offscreen platform,\n"
+    "or on the one QT_QPA_PLATFORM names.\n"
+    "\n"
+    "budgets counts the heap allocations of opening a trip, filtering the trip list and adding an expense on a\n"
+    "generated dataset of 1000 trips and compares them to fixed budgets. The counts are printed to stderr and the\n"
+    "exit code is 1 when an operation goes over its budget.\n"
+    "\n"
+    "stress runs reader threads (one per core by default) taking snapshots, share handles, person lookups and index\n"
+    "queries against a writer adding, updating, removing and undoing trips, on a generated dataset of 2000 trips for\n"
+    "5 seconds by default. The exit code is 1 when a reader sees a snapshot or a handle change, a lookup miss or the\n"
+    "indexes disagree with the list.\n";
+
+// CLASS: OPTIONS
+struct OPTIONS {
+    vector<size_t> sizes = {1000, 10000, 100000};
+    string filter;
+    double minSeconds = 0.5;
+    size_t repetitions = 1;
+    uint64_t seed = 1;
+    string output;
+    filesystem::path workDirectory = filesystem::temp_directory_path() / "tripbench";
+    string baseline;
+    GATEPOLICY gate;
+    unsigned readers = max(2u, thread::hardware_concurrency());
+    double stressSeconds = 5;
+};
+
+vector<string> splitList(const string &text) {
+    vector<string> parts;
+    stringstream stream(text);
+    string part;
+    while (getline(stream, part, ',')) {
+        if (!part.empty()) {
+            parts.push_back(part);
+        }
+    }
+    if (parts.empty()) {
+        throw invalid_argument("empty list " + text);
+    }
+    return parts;
+}
+
+vector<size_t> parseSizes(const string &text) {
+    vector<size_t> sizes;
+    for (const string &part : splitList(text)) {
+        size_t size = stoull(part);
+        if (size == 0) {
+            throw invalid_argument("sizes must be positive");
+        }
+        sizes.push_back(size);
+    }
+    return sizes;
+}
+
+json readReport(const string &path) {
+    ifstream file(path);
+    if (!file.is_open()) {
+        throw runtime_error("Cannot open benchmark report: " + path);
+    }
+    return json::parse(file);
+}
+
+void writeReport(const json &report, const string &path) {
+    if (path.empty()) {
+        cout << report.dump(2) << '\n';
+        return;
+    }
+    ofstream file(path);
+    if (!file.is_open()) {
+        throw runtime_error("Cannot open file for writing: " + path);
+    }
+    file << report.dump(2) << '\n';
+}
+
+OPTIONS parseOptions(const vector<string> &args) {
+    OPTIONS options;
+    for (size_t i = 0; i < args.size(); i += 2) {
+        if (i + 1 >= args.size()) {
+            throw invalid_argument("missing value for " + args[i]);
+        }
+        const string &name = args[i];
+        const string &value = args[i + 1];
+        if (name == "--sizes") {
+            options.sizes = parseSizes(value);
+        } else if (name == "--filter") {
+            options.filter = value;
+        } else if (name == "--min-time-ms") {
+            options.minSeconds = stod(value) / 1000;
+        } else if (name == "--repetitions") {
+            options.repetitions = stoull(value);
+            if (options.repetitions == 0) {
+                throw invalid_argument("repetitions must be positive");
+            }
+        } else if (name == "--seed") {
+            options.seed = stoull(value);
+        } else if (name == "--output") {
+            options.output = value;
+        } else if (name == "--work-dir") {
+            options.workDirectory = value;
+        } else if (name == "--baseline") {
+            options.baseline = value;
+        } else if (name == "--tolerance") {
+            options.gate.tolerance = stod(value) / 100;
+        } else if (name == "--gate-groups") {
+            options.gate.groups = splitList(value);
+        } else if (name == "--readers") {
+            options.readers = static_cast<unsigned>(stoul(value));
+            if (options.readers == 0) {
+                throw invalid_argument("readers must be positive");
+            }
+        } else if (name == "--duration-ms") {
+            options.stressSeconds = stod(value) / 1000;
+        } else {
+            throw invalid_argument("unknown option " + name);
+        }
+    }
+    return options;
+}
+
+// CLASS: WORKDIRECTORY
+// Removes the work directory when the run ends, if the run created it. The datasets delete their own files; anything
+// else left in it, such as a report written there, keeps the directory. Never throws.
+class WORKDIRECTORY {
+   private:
+    filesystem::path path;
+    bool created;
+
+   public:
+    explicit WORKDIRECTORY(const filesystem::path &_path) : path(_path) {
+        error_code ignored;
+        this->created = !filesystem::exists(_path, ignored);
+    }
+    ~WORKDIRECTORY() {
+        if (this->created) {
+            error_code ignored;
+            filesystem::remove(this->path, ignored);
+        }
+    }
+};
+
+// FUNC: Run the suite on a dataset of each size, only the named benchmarks when names are given
+json runSuite(const OPTIONS &options, const vector<size_t> &sizes, const vector<string> &names) {
+    BENCHMARKRUNNER runner(options.minSeconds, options.filter, cerr);
+    runner.restrictTo(names);
+    for (size_t size : sizes) {
+        cerr << "Generating " << size << " trips..." << endl;
+        BENCHMARKDATASET dataset(options.workDirectory, size, options.seed);
+        cerr << dataset.getSummary().toString() << endl;
+
+        // NOTE: Repetitions go round the whole suite, so a slow spell of the machine is spread over benchmarks
+        // instead of hitting every run of one of them
+        for (size_t repetition = 0; repetition < options.repetitions; ++repetition) {
+            runPersistenceBenchmarks(runner, dataset);
+            runTripManagerBenchmarks(runner, dataset);
+            runPersonManagerBenchmarks(runner, dataset);
+            runQueryBenchmarks(runner, dataset);
+            runAnalyticsBenchmarks(runner, dataset);
+#ifdef TRIP_UI_BENCHMARKS
+            runUIBenchmarks(runner, dataset);
+#endif
+        }
+    }
+
+    return json{{"suite", "tripbench"},
+                {"seed", options.seed},
+                {"min_time_ms", options.minSeconds * 1000},
+                {"repetitions", options.repetitions},
+                {"sizes", sizes},
+                {"results", runner.toJson()}};
+}
+
+// FUNC: Allocation budgets of the UI's common operations, the exit code tells whether they all hold
+int runBudgets(const OPTIONS &options) {
+    vector<BUDGETCHECK> checks;
+    {
+        BENCHMARKDATASET dataset(options.workDirectory, BUDGET_DATASET_SIZE, options.seed);
+        checks = checkAllocationBudgets(dataset);
+    }
+    cerr << budgetReport(checks);
+    bool withinBudgets = all_of(checks.begin(), checks.end(), [](const BUDGETCHECK &check) {
+        return check.isWithinBudget();
+    });
+    return withinBudgets ? 0 : 1;
+}
+
+// FUNC: Readers against a writer on one store, the exit code tells whether every invariant held
+int runStress(const OPTIONS &options) {
+    STRESSRESULT result;
+    {
+        BENCHMARKDATASET dataset(options.workDirectory, STRESS_DATASET_SIZE, options.seed);
+        result = runStressTest(dataset, options.readers, options.stressSeconds);
+    }
+    cerr << result.toString();
+    return result.passed() ? 0 : 1;
+}
+}  // namespace
+
+int main(int argc, char *argv[]) {
+#ifdef TRIP_UI_BENCHMARKS
+    // NOTE: No window shows up and no display is needed, unless QT_QPA_PLATFORM asks for a platform
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QApplication app(argc, argv);
+#endif
+
+    vector<string> args(argv + 1, argv + argc);
+    if (!args.empty() && (args[0] == "--help" || args[0] == "help")) {
+        cout << USAGE;
+        return 0;
+    }
+
+    string command;
+    if (!args.empty() && (args[0] == "budgets" || args[0] == "stress")) {
+        command = args[0];
+        args.erase(args.begin());
+    }
+
+    OPTIONS options;
+    try {
+        options = parseOptions(args);
+    } catch (const exception &e) {
+        cerr << "tripbench: " << e.what() << "\n\n" << USAGE;
+        return 2;
+    }
+
+    WORKDIRECTORY workDirectory(options.workDirectory);
+    try {
+        if (command == "budgets") {
+            return runBudgets(options);
+        }
+        if (command == "stress") {
+            return runStress(options);
+        }
+
+        // NOTE: Read first, a missing baseline should not cost a whole benchmark run
+        json baseline = options.baseline.empty() ? json() : readReport(options.baseline);
+
+        json report = runSuite(options, options.sizes, {});
+        writeReport(report, options.output);
+        if (baseline.is_null()) {
+            return 0;
+        }
+
+        GATEREPORT gate = compareToBaseline(baseline, report, options.gate);
+        vector<GATEFINDING> regressions = gate.getRegressions();
+        if (!regressions.empty()) {
+            // NOTE: A regression has to show again in a second run of the benchmark before it fails the gate
+            vector<string> names;
+            vector<size_t> sizes;
+            for (const GATEFINDING &finding : regressions) {
+                names.push_back(finding.name);
+                sizes.push_back(finding.datasetSize);
+            }
+            sort(sizes.begin(), sizes.end());
+            sizes.erase(unique(sizes.begin(), sizes.end()), sizes.end());
+
+            cerr << "\nRunning " << regressions.size() << " regressed benchmark(s) again to rule out noise..." << endl;
+            gate.confirmWith(compareToBaseline(baseline, runSuite(options, sizes, names), options.gate));
+        }
+        cerr << '\n' << gate.toString();
+        return gate.hasRegressions() ? 1 : 0;
+    } catch (const exception &e) {
+        cerr << "tripbench: " << e.what() << '\n';
+        return 2;
+    }
+}
@@ -0,0 +1,474 @@
+#include "CommandLine.h"
+
+#include <algorithm>
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <unordered_set>
+
+#include "../Managers/DatasetGenerator.h"
+#include "../Managers/ExpenseAnalytics.h"
+#include "../Managers/FileManager.h"
+#include "../Managers/MergeImport.h"
+#include "../Managers/Metrics.h"
+#include "../Managers/PersonManager.h"
+#include "../Managers/Trace.h"
+#include "../Managers/TripFilter.h"
+#include "../Managers/TripManager.h"
+#include "../Models/header.h"
+
+using namespace std;
+
+namespace {
+const char *const USAGE =
+    "Usage: tripcli [--cache <dir>] [--trace <file>] [--metrics <file>] <command> [arguments]\n"
+    "\n"
+    "Commands:\n"
+    "  import trips|people <file> [--policy skip|overwrite|newest|merge]\n"
+    "  export trips|people <file>\n"
+    "  query trips [--status <status>] [--destination <text>] [--member <id>] [--host <id>]\n"
+    "  query people [--role member|host] [--name <text>]\n"
+    "  stats\n"
+    "  analyze [--by <key,key,...>] [--aggregates <aggregate,aggregate,...>] [--threads <n>]\n"
+    "  validate\n"
+    "  generate <people-file> <trips-file> [--seed <n>] [--trips <n>] [--members <n>] [--hosts <n>]\n"
+    "           [--members-per-trip <n>] [--expenses-per-trip <n>]\n"
+    "\n"
+    "The store is the cache folder of the application, \"cache\" under the working directory by default.\n"
+    "generate writes a synthetic dataset for import and does not touch the store, one seed gives the same files.\n"
+    "analyze groups every expense by trip, destination, host, member (person in charge), category, day, month, year\n"
+    "or status (destination by default) and prints sum, count, avg, min, max, median or p<0-100> of the amounts\n"
+    "(sum,count by default) as tab separated columns.\n"
+    "--trace writes the timed load, save and parse steps of the command as a Chrome trace for Perfetto, in builds\n"
+    "made with CONFIG+=tracing.\n"
+    "--metrics writes the counters, timings and latest log messages of the command as JSON, \"-\" for stdout.\n";
+
+// CLASS: USAGEERROR
+// Bad command line, reported together with the usage text
+class USAGEERROR : public runtime_error {
+   public:
+    explicit USAGEERROR(const string &message) : runtime_error(message) {}
+};
+
+// CLASS: ARGUMENTS
+// Positional arguments and "--name value" options of one command
+struct ARGUMENTS {
+    vector<string> positional;
+    map<string, string> options;
+
+    string option(const string &name) const {
+        auto it = options.find(name);
+        return (it != options.end()) ? it->second : "";
+    }
+
+    void allowOnly(const set<string> &names) const {
+        for (const auto &entry : options) {
+            if (!names.count(entry.first)) {
+                throw USAGEERROR("unknown option --" + entry.first);
+            }
+        }
+    }
+};
+
+ARGUMENTS parseArguments(vector<string>::const_iterator begin, vector<string>::const_iterator end) {
+    ARGUMENTS parsed;
+    for (auto it = begin; it != end; ++it) {
+        if (it->rfind("--", 0) != 0) {
+            parsed.positional.push_back(*it);
+            continue;
+        }
+        if (next(it) == end) {
+            throw USAGEERROR("missing value for " + *it);
+        }
+        parsed.options[it->substr(2)] = *next(it);
+        ++it;
+    }
+    return parsed;
+}
+
+// CLASS: STORE
+// Both managers loaded from the cache folder. The people cache is written by its manager on every change, the trip
+// cache is written here after a trip import, like the main window does when it closes.
+struct STORE {
+    PERSONMANAGER people;
+    TRIPMANAGER trips;
+
+    STORE() {
+        if (cacheFileExists()) {
+            trips.loadSnapshot();
+        }
+    }
+
+    void saveTrips() { updateCacheFile(trips.getAllTrips()); }
+};
+
+MERGEPOLICY parsePolicy(const string &name) {
+    if (name.empty() || name == "skip") return MERGEPOLICY::Skip;
+    if (name == "overwrite") return MERGEPOLICY::Overwrite;
+    if (name == "newest") return MERGEPOLICY::NewestWins;
+    if (name == "merge") return MERGEPOLICY::FieldMerge;
+    throw USAGEERROR("unknown merge policy " + name);
+}
+
+// NOTE: stringToStatus falls back to Planned, so a status only counts as valid when it converts back unchanged
+STATUS parseStatus(const string &name) {
+    STATUS status = stringToStatus(name);
+    if (statusToString(status) != name) {
+        throw USAGEERROR("unknown status " + name + " (Planned, Ongoing, Completed or Cancelled)");
+    }
+    return status;
+}
+
+// NOTE: Whole non-negative numbers only, "10k" or "-1" are usage errors rather than silently read as 10 or huge
+uint64_t parseCount(const ARGUMENTS &args, const string &name, uint64_t fallback) {
+    string value = args.option(name);
+    if (value.empty()) {
+        return fallback;
+    }
+    if (value.find_first_not_of("0123456789") != string::npos || value.size() > 19) {
+        throw USAGEERROR("--" + name + " expects a whole number, got " + value);
+    }
+    return stoull(value);
+}
+
+bool containsIgnoringCase(const string &text, const string &part) {
+    return toUpper(text).find(toUpper(part)) != string::npos;
+}
+
+const string &requireKind(const ARGUMENTS &args, size_t count) {
+    if (args.positional.size() != count || (args.positional[0] != "trips" && args.positional[0] != "people")) {
+        throw USAGEERROR("expected trips or people" + string(count > 1 ? " and a file" : ""));
+    }
+    return args.positional[0];
+}
+
+// FUNC: Commands
+int importCommand(const ARGUMENTS &args, ostream &out) {
+    args.allowOnly({"policy"});
+    const string &kind = requireKind(args, 2);
+    const string &file = args.positional[1];
+    MERGEPOLICY policy = parsePolicy(args.option("policy"));
+
+    STORE store;
+    MERGEREPORT report;
+    if (kind == "trips") {
+        vector<TRIP> imported;
+        importTripInfoFromJson(imported, file, &store.people);
+        report = store.trips.mergeTrips(imported, policy, &store.people);
+        if (!report.changedIDs.empty()) {
+            store.saveTrips();
+        }
+    } else {
+        vector<MEMBER> members;
+        vector<HOST> hosts;
+        importPeopleInfoFromJson(members, hosts, file);
+        report = store.people.mergePeople(members, hosts, policy);
+    }
+
+    out << report.toString() << '\n';
+    return 0;
+}
+
+int exportCommand(const ARGUMENTS &args, ostream &out) {
+    args.allowOnly({});
+    const string &kind = requireKind(args, 2);
+    const string &file = args.positional[1];
+
+    STORE store;
+    if (kind == "trips") {
+        TRIPSNAPSHOT trips = store.trips.getAllTrips();
+        exportTripsInfoToJson(trips, file);
+        out << "Exported " << trips.size() << " trips to " << file << '\n';
+    } else {
+        PEOPLESNAPSHOT people = store.people.getSnapshot();
+        exportPeopleInfoToJson(people.getMembers(), people.getHosts(), file);
+        out << "Exported " << people.getMembers().size() + people.getHosts().size() << " people to " << file << '\n';
+    }
+    return 0;
+}
+
+int queryTrips(const ARGUMENTS &args, ostream &out) {
+    args.allowOnly({"status", "destination", "member", "host"});
+    string statusName = args.option("status");
+    string destination = args.option("destination");
+    string memberID = args.option("member");
+    string hostID = args.option("host");
+    STATUS status = statusName.empty() ? STATUS::Planned : parseStatus(statusName);
+
+    STORE store;
+    // NOTE: Membership and hosting come from the indexes, no trip details are loaded
+    unordered_set<IDKEY, IDKEY_HASH> withMember;
+    unordered_set<IDKEY, IDKEY_HASH> withHost;
+    if (!memberID.empty()) {
+        vector<IDKEY> keys = store.trips.getTripKeysOfMember(memberID);
+        withMember.insert(keys.begin(), keys.end());
+    }
+    if (!hostID.empty()) {
+        vector<IDKEY> keys = store.trips.getTripKeysOfHost(hostID);
+        withHost.insert(keys.begin(), keys.end());
+    }
+
+    TRIPSNAPSHOT matches = store.trips.getAllTrips().filter([&](const TRIP &trip) {
+        return (statusName.empty() || trip.getStatus() == status) &&
+               (destination.empty() || containsIgnoringCase(trip.getDestination(), destination)) &&
+               (memberID.empty() || withMember.count(trip.getKey())) &&
+               (hostID.empty() || withHost.count(trip.getKey()));
+    });
+
+    for (const TRIP &trip : matches) {
+        out << trip.getID() << '\t' << trip.getDestination() << '\t' << trip.getStartDate().toString() << '\t'
+            << trip.getEndDate().toString() << '\t' << trip.getStatusString() << '\n';
+    }
+    return 0;
+}
+
+int queryPeople(const ARGUMENTS &args, ostream &out) {
+    args.allowOnly({"role", "name"});
+    string role = args.option("role");
+    string name = args.option("name");
+    if (!role.empty() && role != "member" && role != "host") {
+        throw USAGEERROR("unknown role " + role + " (member or host)");
+    }
+
+    STORE store;
+    PEOPLESNAPSHOT people = store.people.getSnapshot();
+    for (const PERSON &person : people.getAllPeople()) {
+        if (!role.empty() && toUpper(person.getRole()) != toUpper(role)) {
+            continue;
+        }
+        if (!name.empty() && !containsIgnoringCase(person.getFullName(), name)) {
+            continue;
+        }
+        out << person.getID() << '\t' << person.getRole() << '\t' << person.getFullName() << '\t' << person.getEmail()
+            << '\n';
+    }
+    return 0;
+}
+
+int queryCommand(const ARGUMENTS &args, ostream &out) {
+    if (args.positional.size() != 1) {
+        throw USAGEERROR("expected trips or people");
+    }
+    if (args.positional[0] == "trips") {
+        return queryTrips(args, out);
+    }
+    if (args.positional[0] == "people") {
+        return queryPeople(args, out);
+    }
+    throw USAGEERROR("expected trips or people");
+}
+
+int statsCommand(const ARGUMENTS &args, ostream &out) {
+    args.allowOnly({});
+    if (!args.positional.empty()) {
+        throw USAGEERROR("stats takes no arguments");
+    }
+
+    STORE store;
+    // NOTE: The expense totals come from the aggregates, trips stay header-only
+    TRIPSNAPSHOT trips = store.trips.getAllTrips();
+
+    map<string, size_t> byStatus;
+    for (const TRIP &trip : trips) {
+        byStatus[trip.getStatusString()]++;
+    }
+
+    out << "Trips: " << trips.size() << '\n';
+    for (const auto &entry : byStatus) {
+        out << "  " << entry.first << ": " << entry.second << '\n';
+    }
+    out << "Total expense: " << store.trips.getExpenseTotal().amount << '\n';
+    for (size_t i = 0; i < CATEGORY_COUNT; ++i) {
+        CATEGORY category = static_cast<CATEGORY>(i);
+        EXPENSESUM sum = store.trips.getExpenseTotalOfCategory(category);
+        out << "  " << categoryToString(category) << ": " << sum.amount << " (" << sum.count << " expenses)\n";
+    }
+    out << "Members: " << store.people.getMemberCount() << '\n';
+    out << "Hosts: " << store.people.getHostCount() << '\n';
+    out << "Trip snapshot arena: " << store.trips.getSnapshotBytes() << " bytes\n";
+    return 0;
+}
+
+// NOTE: Comma separated names, blanks around them ignored
+vector<string> splitNames(const string &text) {
+    vector<string> names;
+    for (const string &name : splitKeywords(text)) {
+        if (!name.empty()) {
+            names.push_back(name);
+        }
+    }
+    return names;
+}
+
+int analyzeCommand(const ARGUMENTS &args, ostream &out) {
+    args.allowOnly({"by", "aggregates", "threads"});
+    if (!args.positional.empty()) {
+        throw USAGEERROR("analyze takes no arguments");
+    }
+
+    string keyNames = args.options.count("by") ? args.option("by") : "destination";
+    string aggregateNames = args.options.count("aggregates") ? args.option("aggregates") : "sum,count";
+    ANALYTICSQUERY query;
+    try {
+        for (const string &name : splitNames(keyNames)) {
+            query.groupBy.push_back(parseGroupKey(name));
+        }
+        for (const string &name : splitNames(aggregateNames)) {
+            query.aggregates.push_back(parseAggregate(name));
+        }
+    } catch (const runtime_error &e) {
+        throw USAGEERROR(e.what());
+    }
+    if (query.aggregates.empty()) {
+        throw USAGEERROR("expected at least one aggregate");
+    }
+    unsigned threadCount = static_cast<unsigned>(parseCount(args, "threads", 0));
+
+    STORE store;
+    // NOTE: Trips are cached header-only, the projection reads their expenses
+    store.trips.loadAllTripDetails(&store.people);
+    EXPENSECOLUMNS columns = projectExpenses(store.trips.getAllTrips());
+    ANALYTICSRESULT result = runAnalytics(columns, query, threadCount);
+
+    vector<string> header = result.keyNames;
+    header.insert(header.end(), result.valueNames.begin(), result.valueNames.end());
+    for (size_t i = 0; i < header.size(); ++i) {
+        out << (i ? "\t" : "") << header[i];
+    }
+    out << '\n';
+    for (const ANALYTICSROW &row : result.rows) {
+        for (size_t i = 0; i < row.keys.size(); ++i) {
+            out << row.keys[i] << '\t';
+        }
+        for (size_t i = 0; i < row.values.size(); ++i) {
+            out << (i ? "\t" : "") << formatAggregateValue(query.aggregates[i], row.values[i]);
+        }
+        out << '\n';
+    }
+    return 0;
+}
+
+int validateCommand(const ARGUMENTS &args, ostream &out) {
+    args.allowOnly({});
+    if (!args.positional.empty()) {
+        throw USAGEERROR("validate takes no arguments");
+    }
+
+    STORE store;
+    bool peopleValid = store.people.validateDataIntegrity();
+    vector<string> problems = store.trips.findIntegrityProblems(&store.people);
+    for (const string &problem : problems) {
+        out << problem << '\n';
+    }
+
+    if (!peopleValid || !problems.empty()) {
+        out << "Validation failed: " << problems.size() << " trip problems"
+            << (peopleValid ? "" : ", duplicate people IDs (see the log)") << '\n';
+        return 1;
+    }
+    out << "Validation passed: " << store.trips.getTripCount() << " trips, " << store.people.getPersonCount()
+        << " people\n";
+    return 0;
+}
+
+int generateCommand(const ARGUMENTS &args, ostream &out) {
+    args.allowOnly({"seed", "trips", "members", "hosts", "members-per-trip", "expenses-per-trip"});
+    if (args.positional.size() != 2) {
+        throw USAGEERROR("expected a people file and a trips file");
+    }
+
+    DATASETSPEC spec;
+    spec.seed = parseCount(args, "seed", spec.seed);
+    spec.tripCount = parseCount(args, "trips", spec.tripCount);
+    spec.memberCount = parseCount(args, "members", spec.memberCount);
+    spec.hostCount = parseCount(args, "hosts", spec.hostCount);
+    spec.meanMembersPerTrip = parseCount(args, "members-per-trip", spec.meanMembersPerTrip);
+    spec.meanExpensesPerTrip = parseCount(args, "expenses-per-trip", spec.meanExpensesPerTrip);
+    try {
+        spec.validate();
+    } catch (const runtime_error &e) {
+        throw USAGEERROR(e.what());
+    }
+
+    DATASETGENERATOR generator(spec);
+    generator.writeFiles(args.positional[0], args.positional[1]);
+    out << generator.getSummary().toString() << '\n';
+    return 0;
+}
+
+void writeMetricsFile(const string &filePath, ostream &out) {
+    if (filePath == "-") {
+        writeMetricsJson(out);
+        return;
+    }
+    ofstream file(filePath);
+    if (!file.is_open()) {
+        throw runtime_error("Could not open metrics file: " + filePath);
+    }
+    writeMetricsJson(file);
+}
+
+int runCommand(const string &command, const ARGUMENTS &args, ostream &out) {
+    if (command == "import") return importCommand(args, out);
+    if (command == "export") return exportCommand(args, out);
+    if (command == "query") return queryCommand(args, out);
+    if (command == "stats") return statsCommand(args, out);
+    if (command == "analyze") return analyzeCommand(args, out);
+    if (command == "validate") return validateCommand(args, out);
+    if (command == "generate") return generateCommand(args, out);
+    if (command == "help" || command == "--help") {
+        out << USAGE;
+        return 0;
+    }
+    throw USAGEERROR("unknown command " + command);
+}
+}  // namespace
+
+int runCommandLine(const vector<string> &args, ostream &out, ostream &err) {
+    try {
+        auto command = args.begin();
+        string traceFile;
+        string metricsFile;
+        while (command != args.end() && (*command == "--cache" || *command == "--trace" || *command == "--metrics")) {
+            if (next(command) == args.end()) {
+                throw USAGEERROR("missing value for " + *command);
+            }
+            if (*command == "--cache") {
+                setCacheDirectory(*next(command));
+            } else if (*command == "--trace") {
+                traceFile = *next(command);
+            } else {
+                metricsFile = *next(command);
+            }
+            command += 2;
+        }
+        if (command == args.end()) {
+            throw USAGEERROR("missing command");
+        }
+
+        ARGUMENTS commandArgs = parseArguments(next(command), args.end());
+        if (!traceFile.empty()) {
+            if (!tracingCompiledIn()) {
+                throw runtime_error("this build has no trace spans, build with CONFIG+=tracing to use --trace");
+            }
+            startTracing();
+        }
+
+        int result = runCommand(*command, commandArgs, out);
+
+        if (!traceFile.empty()) {
+            stopTracing();
+            writeChromeTraceFile(traceFile);
+        }
+        if (!metricsFile.empty()) {
+            writeMetricsFile(metricsFile, out);
+        }
+        return result;
+    } catch (const USAGEERROR &e) {
+        err << "tripcli: " << e.what() << "\n\n" << USAGE;
+        return 2;
+    } catch (const exception &e) {
+        err << "tripcli: " << e.what() << '\n';
+        return 2;
+    }
+}
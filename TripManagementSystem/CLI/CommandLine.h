@@ -0,0 +1,14 @@
+#ifndef COMMANDLINE_H
+#define COMMANDLINE_H
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// FUNC: Run the headless tool on its arguments (without the program name) and return the process exit code:
+// 0 on success, 1 when validate finds problems, 2 on a usage or data error
+int runCommandLine(const vector<string> &args, ostream &out, ostream &err);
+
+#endif  // COMMANDLINE_H
@@ -0,0 +1,23 @@
+# Headless command-line tool over the core library: import, export, query, stats and validate
+CONFIG += c++17 console debug_and_release
+CONFIG -= qt app_bundle
+
+TARGET = tripcli
+TEMPLATE = app
+
+include(../core/core.pri)
+
+CONFIG(debug, debug|release) {
+    DESTDIR = $$OUT_PWD/../debug
+}
+
+CONFIG(release, debug|release) {
+    DESTDIR = $$OUT_PWD/../release
+}
+
+SOURCES += main.cpp \
+    CommandLine.cpp
+
+HEADERS += CommandLine.h
+
+QMAKE_CXXFLAGS += -Wall -Wextra
@@ -0,0 +1,390 @@
+#include "DatasetGenerator.h"
+
+#include <algorithm>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+
+#include "PersonFactory.h"
+#include "TripFactory.h"
+
+using namespace std;
+
+namespace {
+// NOTE: Weights are rough shares of domestic trips, people and spending, they only have to look plausible
+const vector<pair<string, uint32_t>> DESTINATIONS = {
+    {"Ha Noi", 14}, {"Ho Chi Minh", 14}, {"Da Nang", 12}, {"Da Lat", 11}, {"Nha Trang", 10}, {"Vung Tau", 9},
+    {"Phu Quoc", 8}, {"Hoi An", 8}, {"Ha Long", 7}, {"Sa Pa", 6}, {"Hue", 6}, {"Quy Nhon", 4},
+    {"Can Tho", 4}, {"Mui Ne", 3}, {"Ninh Binh", 3}, {"Con Dao", 2}, {"Ha Giang", 2}, {"Phong Nha", 1}};
+const vector<string> PURPOSES = {"Du lich", "Kham pha", "Nghi duong o", "Team building tai", "Di choi"};
+const vector<string> COMPANIONS = {"cung nhom ban", "cung gia dinh", "cung dong nghiep", "cung lop"};
+
+// NOTE: Month of the start date, peaks around Tet, the April holidays and the summer break
+const vector<pair<int, uint32_t>> START_MONTHS = {{1, 9},  {2, 10}, {3, 5},  {4, 9},  {5, 8},  {6, 12},
+                                                  {7, 13}, {8, 11}, {9, 5},  {10, 5}, {11, 5}, {12, 8}};
+const vector<pair<int, uint32_t>> TRIP_DAYS = {{1, 15}, {2, 25}, {3, 25}, {4, 14}, {5, 9},
+                                               {6, 5},  {7, 4},  {10, 2}, {14, 1}};
+
+const vector<pair<string, uint32_t>> SURNAMES = {{"Nguyen", 38}, {"Tran", 11}, {"Le", 9}, {"Pham", 7}, {"Hoang", 5},
+                                                 {"Huynh", 5},   {"Phan", 4},  {"Vu", 4}, {"Vo", 4},   {"Dang", 2},
+                                                 {"Bui", 2},     {"Do", 2},    {"Ho", 2}, {"Ngo", 2},  {"Duong", 1},
+                                                 {"Ly", 1}};
+const vector<string> MALE_MIDDLE_NAMES = {"Van", "Duc", "Minh", "Quang", "Thanh", "Huu", "Gia", "Tuan"};
+const vector<string> FEMALE_MIDDLE_NAMES = {"Thi", "Ngoc", "Thu", "Kim", "Thanh", "My", "Bao", "Khanh"};
+const vector<string> MALE_GIVEN_NAMES = {"Huy", "Minh", "Nam",  "Bao",  "Khoa", "Long", "Phuc",
+                                         "Dung", "Tuan", "Hieu", "Quan", "Son", "Dat",  "Vinh"};
+const vector<string> FEMALE_GIVEN_NAMES = {"Lan",  "Linh", "Ha",  "Mai", "Trang", "Huong", "Anh",
+                                           "Thao", "Vy",   "Ngan", "Nhi", "Thu",  "Chi",   "Uyen"};
+const vector<string> STREETS = {"Nguyen Hue", "Le Loi",       "Tran Hung Dao", "Hai Ba Trung", "Ly Thuong Kiet",
+                                "Pasteur",    "Vo Van Tan",   "Dien Bien Phu", "Cach Mang Thang Tam"};
+const vector<string> AREAS = {"District 1, Ho Chi Minh City", "District 3, Ho Chi Minh City",
+                              "Binh Thanh District, Ho Chi Minh City", "Hoan Kiem District, Ha Noi",
+                              "Cau Giay District, Ha Noi", "Hai Chau District, Da Nang", "Ninh Kieu District, Can Tho"};
+
+const vector<pair<CATEGORY, uint32_t>> CATEGORIES = {{CATEGORY::Food, 35},
+                                                     {CATEGORY::Drink, 20},
+                                                     {CATEGORY::Gas, 15},
+                                                     {CATEGORY::Accommodation, 12},
+                                                     {CATEGORY::Others, 18}};
+
+// CLASS: SPENDING
+// Amount range of a category in thousands of VND, and what the expense notes say
+struct SPENDING {
+    long long lowest;
+    long long highest;
+    vector<string> notes;
+};
+
+const SPENDING &spendingOf(CATEGORY category) {
+    static const SPENDING FOOD = {30, 500, {"Bua sang", "Bua trua", "Bua toi", "Hai san", "An vat"}};
+    static const SPENDING DRINK = {15, 200, {"Ca phe", "Tra sua", "Nuoc mia", "Bia", "Sinh to"}};
+    static const SPENDING GAS = {50, 800, {"Do xang", "Xang xe may", "Phi cau duong", "Gui xe"}};
+    static const SPENDING ACCOMMODATION = {400, 5000, {"Khach san", "Homestay", "Resort", "Dat coc phong"}};
+    static const SPENDING OTHERS = {20, 1000, {"Ve tham quan", "Qua luu niem", "Thue xe", "Ve cap treo"}};
+    switch (category) {
+        case CATEGORY::Food:
+            return FOOD;
+        case CATEGORY::Drink:
+            return DRINK;
+        case CATEGORY::Gas:
+            return GAS;
+        case CATEGORY::Accommodation:
+            return ACCOMMODATION;
+        default:
+            return OTHERS;
+    }
+}
+
+// FUNC: Calendar arithmetic on DATE, which has none of its own
+bool isLeapYear(int year) { return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0; }
+
+int daysInMonth(int month, int year) {
+    static const int DAYS[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    return (month == 2 && isLeapYear(year)) ? 29 : DAYS[month - 1];
+}
+
+DATE addDays(const DATE &date, int days) {
+    int day = date.getDay() + days;
+    int month = date.getMonth();
+    int year = date.getYear();
+    while (day > daysInMonth(month, year)) {
+        day -= daysInMonth(month, year);
+        if (++month > 12) {
+            month = 1;
+            ++year;
+        }
+    }
+    return DATE(day, month, year);
+}
+
+// NOTE: Days from 1/1/1970 in the proleptic Gregorian calendar (H. Hinnant's days_from_civil)
+long long daysSinceEpoch(const DATE &date) {
+    int year = date.getYear() - (date.getMonth() <= 2 ? 1 : 0);
+    long long era = (year >= 0 ? year : year - 399) / 400;
+    long long yearOfEra = year - era * 400;
+    long long dayOfYear = (153 * (date.getMonth() + (date.getMonth() > 2 ? -3 : 9)) + 2) / 5 + date.getDay() - 1;
+    long long dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + dayOfEra - 719468;
+}
+
+// NOTE: Noon UTC of the day, what updated_at holds for generated records
+long long noonOf(const DATE &date) { return daysSinceEpoch(date) * 86400 + 12 * 3600; }
+
+string toLowerCase(const string &text) {
+    string lower = text;
+    transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char c) { return tolower(c); });
+    return lower;
+}
+
+void appendJsonString(string &record, const string &text) {
+    static const char HEX[] = "0123456789abcdef";
+    record += '"';
+    for (unsigned char c : text) {
+        if (c == '"' || c == '\\') {
+            record += '\\';
+            record += static_cast<char>(c);
+        } else if (c < 0x20) {
+            record += "\\u00";
+            record += HEX[c >> 4];
+            record += HEX[c & 0xF];
+        } else {
+            record += static_cast<char>(c);
+        }
+    }
+    record += '"';
+}
+
+void appendField(string &record, const char *name, const string &value) {
+    record += '"';
+    record += name;
+    record += "\":";
+    appendJsonString(record, value);
+}
+
+void appendField(string &record, const char *name, long long value) {
+    record += '"';
+    record += name;
+    record += "\":";
+    record += to_string(value);
+}
+}  // namespace
+
+void DATASETSPEC::validate() const {
+    if (this->tripCount > 0 && (this->memberCount == 0 || this->hostCount == 0)) {
+        throw runtime_error("trips need at least one member and one host");
+    }
+    if (this->meanMembersPerTrip == 0) {
+        throw runtime_error("members per trip must be at least 1");
+    }
+    if (this->yearCount < 1 || this->firstYear < 1900 || this->firstYear + this->yearCount > 10000) {
+        throw runtime_error("trip years must lie within 1900 and 9999");
+    }
+    int month = this->referenceDate.getMonth();
+    int year = this->referenceDate.getYear();
+    if (month < 1 || month > 12 || this->referenceDate.getDay() < 1 ||
+        this->referenceDate.getDay() > daysInMonth(month, year)) {
+        throw runtime_error("invalid reference date " + this->referenceDate.toString());
+    }
+}
+
+string DATASETSUMMARY::toString() const {
+    return "Generated " + to_string(this->members) + " members, " + to_string(this->hosts) + " hosts, " +
+           to_string(this->trips) + " trips, " + to_string(this->expenses) +
+           " expenses (total amount: " + to_string(this->totalAmount) + ")";
+}
+
+DATASETGENERATOR::DATASETGENERATOR(const DATASETSPEC &spec) : spec(spec), random(spec.seed) { spec.validate(); }
+
+// NOTE: Rejection sampling instead of uniform_int_distribution, whose output differs between standard libraries
+uint64_t DATASETGENERATOR::below(uint64_t bound) {
+    if (bound <= 1) {
+        return 0;
+    }
+    uint64_t limit = numeric_limits<uint64_t>::max() - numeric_limits<uint64_t>::max() % bound;
+    uint64_t drawn;
+    do {
+        drawn = this->random();
+    } while (drawn >= limit);
+    return drawn % bound;
+}
+
+long long DATASETGENERATOR::between(long long low, long long high) {
+    return low + static_cast<long long>(below(static_cast<uint64_t>(high - low) + 1));
+}
+
+bool DATASETGENERATOR::chance(uint32_t percent) { return below(100) < percent; }
+
+// NOTE: Product of two uniform draws, index 0 is the most likely and the mean is count / 4. Gives a few frequent
+// travellers and hosts and a long tail of people who travel once.
+size_t DATASETGENERATOR::skewedIndex(size_t count) { return static_cast<size_t>(below(count) * below(count) / count); }
+
+// NOTE: Triangular on [0, 2 * mean]
+size_t DATASETGENERATOR::aroundMean(size_t mean) { return static_cast<size_t>(below(mean + 1) + below(mean + 1)); }
+
+string DATASETGENERATOR::uniqueID(unordered_map<string, uint32_t> &holders, const string &baseID) {
+    uint32_t holder = ++holders[baseID];
+    return (holder == 1) ? baseID : baseID + "_" + to_string(holder);
+}
+
+DATE DATASETGENERATOR::drawStartDate() {
+    int year = static_cast<int>(between(this->spec.firstYear, this->spec.firstYear + this->spec.yearCount - 1));
+    int month = pickWeighted(START_MONTHS);
+    int day = static_cast<int>(between(1, daysInMonth(month, year)));
+    return DATE(day, month, year);
+}
+
+string DATASETGENERATOR::drawPerson(const string &role, vector<string> &ids) {
+    bool male = chance(50);
+    const string &surname = pickWeighted(SURNAMES);
+    const string &middleName = pick(male ? MALE_MIDDLE_NAMES : FEMALE_MIDDLE_NAMES);
+    const string &givenName = pick(male ? MALE_GIVEN_NAMES : FEMALE_GIVEN_NAMES);
+    string fullName = surname + " " + middleName + " " + givenName;
+
+    int year = static_cast<int>(between(1960, 2006));
+    int month = static_cast<int>(between(1, 12));
+    DATE dateOfBirth(static_cast<int>(between(1, daysInMonth(month, year))), month, year);
+    ids.push_back(uniqueID(this->personIDHolders, PERSONFACTORY::generatePersonID(fullName, dateOfBirth)));
+
+    string phone = to_string(below(100000000));
+    phone = "09" + string(8 - phone.size(), '0') + phone;
+    size_t number = this->summary.members + this->summary.hosts + 1;
+
+    string record = "{";
+    appendField(record, "id", ids.back());
+    record += ',';
+    appendField(record, "full_name", fullName);
+    record += ',';
+    appendField(record, "date_of_birth", dateOfBirth.toString());
+    record += ',';
+    appendField(record, "email", toLowerCase(givenName + "." + surname) + to_string(number) + "@gmail.com");
+    record += ',';
+    appendField(record, "phone_number", phone);
+    record += ',';
+    appendField(record, "gender", male ? "Male" : "Female");
+    record += ',';
+    appendField(record, "address", to_string(between(1, 999)) + " " + pick(STREETS) + " Street, " + pick(AREAS));
+    record += ',';
+    appendField(record, "role", role);
+    record += ',';
+    appendField(record, "updated_at", noonOf(this->spec.referenceDate));
+    record += '}';
+    return record;
+}
+
+string DATASETGENERATOR::drawTrip() {
+    const string &destination = pickWeighted(DESTINATIONS);
+    DATE startDate = drawStartDate();
+    int days = pickWeighted(TRIP_DAYS);
+    DATE endDate = addDays(startDate, days - 1);
+
+    const DATE &today = this->spec.referenceDate;
+    STATUS status = STATUS::Ongoing;
+    if (endDate < today) {
+        status = chance(6) ? STATUS::Cancelled : STATUS::Completed;
+    } else if (today < startDate) {
+        status = chance(4) ? STATUS::Cancelled : STATUS::Planned;
+    }
+
+    string record = "{";
+    appendField(record, "id", uniqueID(this->tripIDHolders, TRIPFACTORY::generateTripID(destination, startDate)));
+    record += ',';
+    appendField(record, "destination", destination);
+    record += ',';
+    appendField(record, "description", pick(PURPOSES) + " " + destination + " " + pick(COMPANIONS));
+    record += ',';
+    appendField(record, "start_date", startDate.toString());
+    record += ',';
+    appendField(record, "end_date", endDate.toString());
+    record += ',';
+    appendField(record, "status", statusToString(status));
+    record += ',';
+    appendField(record, "updated_at", noonOf(endDate < today ? endDate : today));
+    record += ',';
+    appendField(record, "host_id", this->hostIDs[skewedIndex(this->hostIDs.size())]);
+
+    // NOTE: Uniform draws once a trip takes most of the members, skewed draws would rarely reach the last ones
+    size_t memberCount = min(this->memberIDs.size(), 1 + aroundMean(this->spec.meanMembersPerTrip - 1));
+    bool crowded = memberCount * 2 > this->memberIDs.size();
+    vector<size_t> members;
+    members.reserve(memberCount);
+    while (members.size() < memberCount) {
+        size_t index = crowded ? below(this->memberIDs.size()) : skewedIndex(this->memberIDs.size());
+        if (find(members.begin(), members.end(), index) == members.end()) {
+            members.push_back(index);
+        }
+    }
+    record += ",\"member_ids\":[";
+    for (size_t i = 0; i < members.size(); ++i) {
+        record += (i > 0) ? "," : "";
+        appendJsonString(record, this->memberIDs[members[i]]);
+    }
+
+    // NOTE: Expense IDs follow TRIP::allocateExpenseID, payers are skewed towards the first members drawn
+    size_t expenseCount = aroundMean(this->spec.meanExpensesPerTrip);
+    record += "],\"expenses\":[";
+    for (size_t i = 0; i < expenseCount; ++i) {
+        CATEGORY category = pickWeighted(CATEGORIES);
+        const SPENDING &spending = spendingOf(category);
+        long long amount = between(spending.lowest, spending.highest) * 1000;
+        if (chance(8)) {
+            amount *= between(2, 5);
+        }
+
+        record += (i > 0) ? ",{" : "{";
+        appendField(record, "id", "E" + to_string(i + 1));
+        record += ',';
+        appendField(record, "date", addDays(startDate, static_cast<int>(below(days))).toString());
+        record += ',';
+        appendField(record, "category", categoryToString(category));
+        record += ',';
+        appendField(record, "amount", amount);
+        record += ',';
+        appendField(record, "note", pick(spending.notes));
+        record += ',';
+        appendField(record, "personInCharge", this->memberIDs[members[skewedIndex(members.size())]]);
+        record += '}';
+        this->summary.totalAmount += amount;
+    }
+    record += "]}";
+    this->summary.expenses += expenseCount;
+    return record;
+}
+
+void DATASETGENERATOR::writePeople(ostream &out) {
+    if (this->summary.members > 0 || this->summary.hosts > 0) {
+        throw runtime_error("people have already been written");
+    }
+
+    this->hostIDs.reserve(this->spec.hostCount);
+    this->memberIDs.reserve(this->spec.memberCount);
+    out << "[\n";
+    for (size_t i = 0; i < this->spec.hostCount; ++i) {
+        out << drawPerson("Host", this->hostIDs) << ",\n";
+        this->summary.hosts++;
+    }
+    for (size_t i = 0; i < this->spec.memberCount; ++i) {
+        out << drawPerson("Member", this->memberIDs) << (i + 1 < this->spec.memberCount ? ",\n" : "\n");
+        this->summary.members++;
+    }
+    out << "]\n";
+}
+
+void DATASETGENERATOR::writeTrips(ostream &out) {
+    if (this->spec.tripCount > 0 && this->memberIDs.empty()) {
+        throw runtime_error("people have to be written before trips");
+    }
+    if (this->summary.trips > 0) {
+        throw runtime_error("trips have already been written");
+    }
+
+    out << "[\n";
+    for (size_t i = 0; i < this->spec.tripCount; ++i) {
+        out << drawTrip() << (i + 1 < this->spec.tripCount ? ",\n" : "\n");
+        this->summary.trips++;
+    }
+    out << "]\n";
+}
+
+void DATASETGENERATOR::writeFiles(const string &peoplePath, const string &tripsPath) {
+    ofstream peopleFile(peoplePath);
+    if (!peopleFile.is_open()) {
+        throw runtime_error("Cannot open file for writing: " + peoplePath);
+    }
+    writePeople(peopleFile);
+    peopleFile.close();
+    if (peopleFile.fail()) {
+        throw runtime_error("Cannot write file: " + peoplePath);
+    }
+
+    ofstream tripsFile(tripsPath);
+    if (!tripsFile.is_open()) {
+        throw runtime_error("Cannot open file for writing: " + tripsPath);
+    }
+    writeTrips(tripsFile);
+    tripsFile.close();
+    if (tripsFile.fail()) {
+        throw runtime_error("Cannot write file: " + tripsPath);
+    }
+}
+
+const DATASETSUMMARY &DATASETGENERATOR::getSummary() const { return this->summary; }
@@ -0,0 +1,107 @@
+#ifndef DATASETGENERATOR_H
+#define DATASETGENERATOR_H
+
+#include <cstdint>
+#include <ostream>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "../Models/header.h"
+
+using namespace std;
+
+// CLASS: DATASETSPEC
+// Size and shape of a synthetic dataset. Trips start in [firstYear, firstYear + yearCount), trips ending before
+// referenceDate are Completed, those starting after it Planned and the rest Ongoing.
+struct DATASETSPEC {
+    uint64_t seed = 1;
+    size_t tripCount = 1000;
+    size_t memberCount = 500;
+    size_t hostCount = 50;
+    size_t meanMembersPerTrip = 4;
+    size_t meanExpensesPerTrip = 20;
+    int firstYear = 2022;
+    int yearCount = 4;
+    DATE referenceDate = DATE(15, 6, 2025);
+
+    // NOTE: Throws runtime_error naming the first field out of range
+    void validate() const;
+};
+
+// CLASS: DATASETSUMMARY
+// What a generator wrote, for reports and for sizing benchmarks
+struct DATASETSUMMARY {
+    size_t members = 0;
+    size_t hosts = 0;
+    size_t trips = 0;
+    size_t expenses = 0;
+    long long totalAmount = 0;
+
+    string toString() const;
+};
+
+// CLASS: DATASETGENERATOR
+// Writes people and trips in the schema read by importPeopleInfoFromJson and importTripInfoFromJson. The output only
+// depends on the spec: the generator draws from its own mt19937_64 with integer arithmetic, so one seed gives the same
+// bytes on every platform. Records are streamed as they are drawn, only the person IDs are kept in memory, which keeps
+// datasets with tens of millions of expenses within a few megabytes.
+//
+// People have to be written before trips, the trips pick their host, members and payers among them.
+class DATASETGENERATOR {
+   private:
+    DATASETSPEC spec;
+    mt19937_64 random;
+    vector<string> memberIDs;
+    vector<string> hostIDs;
+    // NOTE: Holders of each base ID, people and trips are separate ID spaces like in the managers
+    unordered_map<string, uint32_t> personIDHolders;
+    unordered_map<string, uint32_t> tripIDHolders;
+    DATASETSUMMARY summary;
+
+    // FUNC: Draws
+    uint64_t below(uint64_t bound);
+    long long between(long long low, long long high);
+    bool chance(uint32_t percent);
+    size_t skewedIndex(size_t count);
+    size_t aroundMean(size_t mean);
+    template <class T>
+    const T &pick(const vector<T> &choices) {
+        return choices[below(choices.size())];
+    }
+    template <class T>
+    const T &pickWeighted(const vector<pair<T, uint32_t>> &choices) {
+        uint64_t total = 0;
+        for (const auto &choice : choices) {
+            total += choice.second;
+        }
+        uint64_t drawn = below(total);
+        for (const auto &choice : choices) {
+            if (drawn < choice.second) {
+                return choice.first;
+            }
+            drawn -= choice.second;
+        }
+        return choices.back().first;
+    }
+
+    string uniqueID(unordered_map<string, uint32_t> &holders, const string &baseID);
+    DATE drawStartDate();
+    // NOTE: One JSON object each, without separators
+    string drawPerson(const string &role, vector<string> &ids);
+    string drawTrip();
+
+   public:
+    explicit DATASETGENERATOR(const DATASETSPEC &spec);
+
+    void writePeople(ostream &out);
+    void writeTrips(ostream &out);
+    // NOTE: Both files in one go, throws runtime_error when one cannot be written
+    void writeFiles(const string &peoplePath, const string &tripsPath);
+
+    const DATASETSUMMARY &getSummary() const;
+};
+
+#endif  // DATASETGENERATOR_H
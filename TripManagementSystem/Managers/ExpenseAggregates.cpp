@@ -0,0 +1,148 @@
+#include "ExpenseAggregates.h"
+
+#include <algorithm>
+
+using namespace std;
+
+namespace {
+void applyTo(EXPENSESUM &sum, const EXPENSESUM &change, bool adding) {
+    if (adding) {
+        sum.amount += change.amount;
+        sum.count += change.count;
+    } else {
+        sum.amount -= change.amount;
+        sum.count -= change.count;
+    }
+}
+
+// NOTE: A group is dropped once no expense is left in it, so the maps only hold what the store has
+template <class MAP, class KEY>
+void applyToGroup(MAP &groups, const KEY &key, const EXPENSESUM &change, bool adding) {
+    EXPENSESUM &sum = groups[key];
+    applyTo(sum, change, adding);
+    if (sum.count == 0) {
+        groups.erase(key);
+    }
+}
+
+template <class MAP, class KEY>
+EXPENSESUM findGroup(const MAP &groups, const KEY &key) {
+    auto it = groups.find(key);
+    return it == groups.end() ? EXPENSESUM() : it->second;
+}
+}  // namespace
+
+bool EXPENSEAGGREGATES::CONTRIBUTION::matches(const EXPENSETOTALS &totals) const {
+    if (!(this->total == totals.getTotal()) || this->byPayer.size() != totals.getByPayer().size() ||
+        this->byMonth.size() != totals.getByMonth().size()) {
+        return false;
+    }
+    for (size_t i = 0; i < CATEGORY_COUNT; ++i) {
+        if (!(this->byCategory[i] == totals.getByCategory(static_cast<CATEGORY>(i)))) {
+            return false;
+        }
+    }
+    for (const auto &payer : this->byPayer) {
+        if (!(payer.second == totals.getPaidBy(payer.first))) {
+            return false;
+        }
+    }
+    for (const auto &month : this->byMonth) {
+        auto found = find_if(totals.getByMonth().begin(), totals.getByMonth().end(),
+                             [&month](const pair<int, EXPENSESUM> &other) { return other.first == month.first; });
+        if (found == totals.getByMonth().end() || !(found->second == month.second)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// FUNC: Updates
+void EXPENSEAGGREGATES::apply(const CONTRIBUTION &contribution, bool adding) {
+    applyTo(this->total, contribution.total, adding);
+    for (size_t i = 0; i < CATEGORY_COUNT; ++i) {
+        applyTo(this->byCategory[i], contribution.byCategory[i], adding);
+    }
+    for (const auto &payer : contribution.byPayer) {
+        applyToGroup(this->byMember, payer.first, payer.second, adding);
+    }
+    for (const auto &month : contribution.byMonth) {
+        applyToGroup(this->byMonth, month.first, month.second, adding);
+    }
+    if (contribution.total.count > 0) {
+        applyToGroup(this->byDestination, contribution.destination, contribution.total, adding);
+    }
+}
+
+void EXPENSEAGGREGATES::setTrip(const TRIP &trip) {
+    removeTrip(trip.getKey());
+
+    const EXPENSETOTALS &totals = trip.getExpenseTotals();
+    if (totals.getTotal().count == 0) {
+        return;
+    }
+
+    CONTRIBUTION contribution;
+    contribution.destination = trip.getDestination();
+    contribution.total = totals.getTotal();
+    for (size_t i = 0; i < CATEGORY_COUNT; ++i) {
+        contribution.byCategory[i] = totals.getByCategory(static_cast<CATEGORY>(i));
+    }
+    contribution.byPayer.assign(totals.getByPayer().begin(), totals.getByPayer().end());
+    contribution.byMonth.assign(totals.getByMonth().begin(), totals.getByMonth().end());
+
+    apply(contribution, true);
+    this->byTrip.emplace(trip.getKey(), move(contribution));
+}
+
+void EXPENSEAGGREGATES::removeTrip(const IDKEY &tripID) {
+    auto it = this->byTrip.find(tripID);
+    if (it == this->byTrip.end()) {
+        return;
+    }
+    apply(it->second, false);
+    this->byTrip.erase(it);
+}
+
+void EXPENSEAGGREGATES::clear() {
+    this->byTrip.clear();
+    this->byMember.clear();
+    this->byDestination.clear();
+    this->byMonth.clear();
+    for (EXPENSESUM &sum : this->byCategory) {
+        sum = EXPENSESUM();
+    }
+    this->total = EXPENSESUM();
+}
+
+// FUNC: Queries
+EXPENSESUM EXPENSEAGGREGATES::getTotal() const { return this->total; }
+
+EXPENSESUM EXPENSEAGGREGATES::getTripTotal(const IDKEY &tripID) const {
+    auto it = this->byTrip.find(tripID);
+    return it == this->byTrip.end() ? EXPENSESUM() : it->second.total;
+}
+
+EXPENSESUM EXPENSEAGGREGATES::getMemberTotal(const IDKEY &memberID) const {
+    return findGroup(this->byMember, memberID);
+}
+
+EXPENSESUM EXPENSEAGGREGATES::getCategoryTotal(CATEGORY category) const {
+    return this->byCategory[static_cast<size_t>(category)];
+}
+
+EXPENSESUM EXPENSEAGGREGATES::getDestinationTotal(const string &destination) const {
+    return findGroup(this->byDestination, toUpper(destination));
+}
+
+vector<pair<int, EXPENSESUM>> EXPENSEAGGREGATES::getMonthTotals() const {
+    return vector<pair<int, EXPENSESUM>>(this->byMonth.begin(), this->byMonth.end());
+}
+
+bool EXPENSEAGGREGATES::isUpToDate(const TRIP &trip) const {
+    auto it = this->byTrip.find(trip.getKey());
+    if (it == this->byTrip.end()) {
+        return trip.getExpenseTotals().getTotal().count == 0;
+    }
+    return it->second.destination == trip.getDestination() && it->second.matches(trip.getExpenseTotals());
+}
@@ -0,0 +1,62 @@
+#ifndef EXPENSEAGGREGATES_H
+#define EXPENSEAGGREGATES_H
+
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "../Models/header.h"
+
+using namespace std;
+
+// CLASS: EXPENSEAGGREGATES
+// Expense totals of the whole store by trip, member (person in charge), category, month and destination. Each trip
+// contributes its own EXPENSETOTALS, and a copy of them is kept per trip so replacing or removing a trip takes back
+// exactly what it added: the cost is the size of that trip's totals, never a rescan of the store. Header-only trips
+// contribute the totals parsed with their header.
+class EXPENSEAGGREGATES {
+   private:
+    // CLASS: CONTRIBUTION
+    // What one trip added, on the global heap since the trip's own totals live in its snapshot arena
+    struct CONTRIBUTION {
+        string destination;
+        EXPENSESUM total;
+        EXPENSESUM byCategory[CATEGORY_COUNT];
+        vector<pair<IDKEY, EXPENSESUM>> byPayer;
+        vector<pair<int, EXPENSESUM>> byMonth;
+
+        bool matches(const EXPENSETOTALS &totals) const;
+    };
+
+    unordered_map<IDKEY, CONTRIBUTION, IDKEY_HASH> byTrip;
+    unordered_map<IDKEY, EXPENSESUM, IDKEY_HASH> byMember;
+    unordered_map<string, EXPENSESUM> byDestination;
+    map<int, EXPENSESUM> byMonth;
+    EXPENSESUM byCategory[CATEGORY_COUNT];
+    EXPENSESUM total;
+
+    void apply(const CONTRIBUTION &contribution, bool adding);
+
+   public:
+    // FUNC: Updates
+    // NOTE: Replaces whatever the trip contributed before
+    void setTrip(const TRIP &trip);
+    void removeTrip(const IDKEY &tripID);
+    void clear();
+
+    // FUNC: Queries
+    EXPENSESUM getTotal() const;
+    EXPENSESUM getTripTotal(const IDKEY &tripID) const;
+    EXPENSESUM getMemberTotal(const IDKEY &memberID) const;
+    EXPENSESUM getCategoryTotal(CATEGORY category) const;
+    // NOTE: Any case, trips store their destination upper case
+    EXPENSESUM getDestinationTotal(const string &destination) const;
+    // NOTE: In calendar order, keyed by monthKey
+    vector<pair<int, EXPENSESUM>> getMonthTotals() const;
+    // NOTE: For the integrity check, whether the trip's current totals are the ones it contributed
+    bool isUpToDate(const TRIP &trip) const;
+};
+
+#endif  // EXPENSEAGGREGATES_H
@@ -0,0 +1,581 @@
+#include "ExpenseAnalytics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <limits>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+
+#include "Trace.h"
+
+using namespace std;
+
+namespace {
+const size_t MIN_ROWS_PER_WORKER = 16384;
+// NOTE: Up to this many key combinations the combined key is the group number itself, no renumbering pass
+const uint64_t DIRECT_GROUP_LIMIT = uint64_t(1) << 20;
+
+// CLASS: DICTIONARY
+// Codes handed out in first-seen order while projecting, renumbered in value order once every value is in
+template <class VALUE, class HASH = hash<VALUE>>
+class DICTIONARY {
+   private:
+    unordered_map<VALUE, uint32_t, HASH> codes;
+    vector<VALUE> values;
+
+   public:
+    // NOTE: The code of the value and whether the value is new
+    pair<uint32_t, bool> add(const VALUE &value) {
+        auto inserted = this->codes.emplace(value, static_cast<uint32_t>(this->values.size()));
+        if (inserted.second) {
+            this->values.push_back(value);
+        }
+        return {inserted.first->second, inserted.second};
+    }
+
+    uint32_t code(const VALUE &value) { return add(value).first; }
+
+    // FUNC: Sorts the values into sorted and returns the new code of each old one
+    template <class OUT, class CONVERT>
+    vector<uint32_t> sortInto(vector<OUT> &sorted, CONVERT convert) const {
+        vector<uint32_t> order(this->values.size());
+        iota(order.begin(), order.end(), 0);
+        sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b) { return this->values[a] < this->values[b]; });
+
+        vector<uint32_t> remap(order.size());
+        sorted.resize(order.size());
+        for (size_t i = 0; i < order.size(); ++i) {
+            remap[order[i]] = static_cast<uint32_t>(i);
+            sorted[i] = convert(this->values[order[i]]);
+        }
+        return remap;
+    }
+};
+
+void renumber(vector<uint32_t> &codes, const vector<uint32_t> &remap) {
+    for (uint32_t &code : codes) {
+        code = remap[code];
+    }
+}
+
+// NOTE: Moves per-trip values from old trip codes to new ones
+vector<uint32_t> reorder(const vector<uint32_t> &byOldCode, const vector<uint32_t> &remap) {
+    vector<uint32_t> byNewCode(byOldCode.size());
+    for (size_t i = 0; i < byOldCode.size(); ++i) {
+        byNewCode[remap[i]] = byOldCode[i];
+    }
+    return byNewCode;
+}
+
+int dayValue(const DATE &date) { return date.getYear() * 10000 + date.getMonth() * 100 + date.getDay(); }
+
+string twoDigits(int value) { return (value < 10 ? "0" : "") + to_string(value); }
+
+// NOTE: Dates as the rest of the application writes them, dd/mm/yyyy
+string dayLabel(int day) {
+    return twoDigits(day % 100) + "/" + twoDigits(day / 100 % 100) + "/" + to_string(day / 10000);
+}
+
+string monthLabel(int month) { return twoDigits(month % 100) + "/" + to_string(month / 100); }
+
+// FUNC: Partitions
+// NOTE: Contiguous ranges on separate threads, the calling thread takes the first one
+size_t partitionCountFor(size_t rows, unsigned threadCount) {
+    size_t wanted = (rows + MIN_ROWS_PER_WORKER - 1) / MIN_ROWS_PER_WORKER;
+    return max<size_t>(1, min<size_t>(threadCount, wanted));
+}
+
+template <class WORK>
+void runPartitions(size_t count, size_t partitionCount, const WORK &work) {
+    auto runPartition = [&](size_t partition) {
+        work(partition, count * partition / partitionCount, count * (partition + 1) / partitionCount);
+    };
+    vector<thread> workers;
+    workers.reserve(partitionCount - 1);
+    for (size_t partition = 1; partition < partitionCount; ++partition) {
+        workers.emplace_back(runPartition, partition);
+    }
+    runPartition(0);
+    for (thread &worker : workers) {
+        worker.join();
+    }
+}
+
+// CLASS: KEYCOLUMN
+// Where a group key's code of a row comes from: a row column, through a lookup by trip or day code when set
+struct KEYCOLUMN {
+    const uint32_t *codes = nullptr;
+    const uint8_t *smallCodes = nullptr;
+    const uint32_t *lookup = nullptr;
+    uint64_t cardinality = 1;
+
+    uint32_t codeOf(size_t row) const {
+        uint32_t code = this->codes ? this->codes[row] : this->smallCodes[row];
+        return this->lookup ? this->lookup[code] : code;
+    }
+};
+
+KEYCOLUMN keyColumnOf(const EXPENSECOLUMNS &columns, GROUPKEY key) {
+    KEYCOLUMN column;
+    switch (key) {
+        case GROUPKEY::Trip:
+            column.codes = columns.trips.data();
+            column.cardinality = columns.tripIDs.size();
+            break;
+        case GROUPKEY::Destination:
+            column.codes = columns.trips.data();
+            column.lookup = columns.tripDestinations.data();
+            column.cardinality = columns.destinations.size();
+            break;
+        case GROUPKEY::Host:
+            column.codes = columns.trips.data();
+            column.lookup = columns.tripHosts.data();
+            column.cardinality = columns.hostIDs.size();
+            break;
+        case GROUPKEY::Status:
+            column.codes = columns.trips.data();
+            column.lookup = columns.tripStatuses.data();
+            column.cardinality = columns.statuses.size();
+            break;
+        case GROUPKEY::Member:
+            column.codes = columns.members.data();
+            column.cardinality = columns.memberIDs.size();
+            break;
+        case GROUPKEY::Category:
+            column.smallCodes = columns.categories.data();
+            column.cardinality = CATEGORY_COUNT;
+            break;
+        case GROUPKEY::Day:
+            column.codes = columns.days.data();
+            column.cardinality = columns.dayValues.size();
+            break;
+        case GROUPKEY::Month:
+            column.codes = columns.days.data();
+            column.lookup = columns.dayMonths.data();
+            column.cardinality = columns.monthValues.size();
+            break;
+        case GROUPKEY::Year:
+            column.codes = columns.days.data();
+            column.lookup = columns.dayYears.data();
+            column.cardinality = columns.yearValues.size();
+            break;
+    }
+    column.cardinality = max<uint64_t>(1, column.cardinality);
+    return column;
+}
+
+string keyLabel(const EXPENSECOLUMNS &columns, GROUPKEY key, uint32_t code) {
+    switch (key) {
+        case GROUPKEY::Trip:
+            return columns.tripIDs[code];
+        case GROUPKEY::Destination:
+            return columns.destinations[code];
+        case GROUPKEY::Host:
+            return columns.hostIDs[code].empty() ? "-" : columns.hostIDs[code];
+        case GROUPKEY::Status:
+            return columns.statuses[code];
+        case GROUPKEY::Member:
+            return columns.memberIDs[code];
+        case GROUPKEY::Category:
+            return categoryToString(static_cast<CATEGORY>(code));
+        case GROUPKEY::Day:
+            return dayLabel(columns.dayValues[code]);
+        case GROUPKEY::Month:
+            return monthLabel(columns.monthValues[code]);
+        case GROUPKEY::Year:
+            return to_string(columns.yearValues[code]);
+    }
+    return "";
+}
+
+// FUNC: Kernels
+// NOTE: Appends one key to the combined keys of a range of rows as a mixed-radix digit, so combined keys compare
+// like the key tuples. Straight passes over contiguous arrays the compiler can vectorize.
+template <class CODE>
+void combineKernel(uint64_t *combined, const CODE *codes, const uint32_t *lookup, uint64_t cardinality, size_t begin,
+                   size_t end) {
+    if (lookup) {
+        for (size_t row = begin; row < end; ++row) {
+            combined[row] = combined[row] * cardinality + lookup[codes[row]];
+        }
+    } else {
+        for (size_t row = begin; row < end; ++row) {
+            combined[row] = combined[row] * cardinality + codes[row];
+        }
+    }
+}
+
+void combineKey(vector<uint64_t> &combined, const KEYCOLUMN &column, size_t partitionCount) {
+    runPartitions(combined.size(), partitionCount, [&](size_t, size_t begin, size_t end) {
+        if (column.codes) {
+            combineKernel(combined.data(), column.codes, column.lookup, column.cardinality, begin, end);
+        } else {
+            combineKernel(combined.data(), column.smallCodes, column.lookup, column.cardinality, begin, end);
+        }
+    });
+}
+
+// NOTE: Renumbers the combined keys to 0..n-1 in their order and returns n
+uint64_t renumberCombined(vector<uint64_t> &combined, size_t partitionCount) {
+    vector<uint64_t> distinct(combined);
+    sort(distinct.begin(), distinct.end());
+    distinct.erase(unique(distinct.begin(), distinct.end()), distinct.end());
+    runPartitions(combined.size(), partitionCount, [&](size_t, size_t begin, size_t end) {
+        for (size_t row = begin; row < end; ++row) {
+            combined[row] = lower_bound(distinct.begin(), distinct.end(), combined[row]) - distinct.begin();
+        }
+    });
+    return distinct.size();
+}
+
+// CLASS: PARTIAL
+// Sums, counts, extremes and first row of every group over one partition of the rows
+struct PARTIAL {
+    vector<long long> sums;
+    vector<long long> mins;
+    vector<long long> maxes;
+    vector<uint64_t> counts;
+    vector<size_t> firstRows;
+
+    explicit PARTIAL(size_t groupCount)
+        : sums(groupCount, 0), mins(groupCount, 0), maxes(groupCount, 0), counts(groupCount, 0),
+          firstRows(groupCount, 0) {}
+
+    void accumulate(const uint64_t *groups, const long long *amounts, size_t begin, size_t end) {
+        for (size_t row = begin; row < end; ++row) {
+            size_t group = groups[row];
+            long long amount = amounts[row];
+            this->sums[group] += amount;
+            if (this->counts[group]++ == 0) {
+                this->mins[group] = amount;
+                this->maxes[group] = amount;
+                this->firstRows[group] = row;
+            } else {
+                this->mins[group] = min(this->mins[group], amount);
+                this->maxes[group] = max(this->maxes[group], amount);
+            }
+        }
+    }
+
+    // NOTE: Later partitions hold later rows, so a group's first row stays the one already here
+    void merge(const PARTIAL &other) {
+        for (size_t group = 0; group < this->counts.size(); ++group) {
+            if (other.counts[group] == 0) {
+                continue;
+            }
+            if (this->counts[group] == 0) {
+                this->mins[group] = other.mins[group];
+                this->maxes[group] = other.maxes[group];
+                this->firstRows[group] = other.firstRows[group];
+            } else {
+                this->mins[group] = min(this->mins[group], other.mins[group]);
+                this->maxes[group] = max(this->maxes[group], other.maxes[group]);
+            }
+            this->sums[group] += other.sums[group];
+            this->counts[group] += other.counts[group];
+        }
+    }
+};
+
+// NOTE: The amounts of each group in ascending order, group after group, starting at the returned offsets
+vector<size_t> sortAmountsByGroup(const vector<uint64_t> &groups, const vector<long long> &amounts,
+                                  const vector<uint64_t> &counts, size_t partitionCount, vector<long long> &sorted) {
+    vector<size_t> offsets(counts.size() + 1, 0);
+    for (size_t group = 0; group < counts.size(); ++group) {
+        offsets[group + 1] = offsets[group] + counts[group];
+    }
+
+    vector<size_t> cursors(offsets.begin(), offsets.end() - 1);
+    sorted.resize(amounts.size());
+    for (size_t row = 0; row < amounts.size(); ++row) {
+        sorted[cursors[groups[row]]++] = amounts[row];
+    }
+
+    runPartitions(counts.size(), partitionCount, [&](size_t, size_t begin, size_t end) {
+        for (size_t group = begin; group < end; ++group) {
+            sort(sorted.begin() + offsets[group], sorted.begin() + offsets[group + 1]);
+        }
+    });
+    return offsets;
+}
+
+double percentileOf(const long long *sorted, size_t count, double percentile) {
+    double position = percentile / 100.0 * static_cast<double>(count - 1);
+    size_t lower = static_cast<size_t>(floor(position));
+    size_t upper = min(lower + 1, count - 1);
+    double fraction = position - static_cast<double>(lower);
+    return static_cast<double>(sorted[lower]) + (static_cast<double>(sorted[upper] - sorted[lower])) * fraction;
+}
+}  // namespace
+
+EXPENSECOLUMNS projectExpenses(const TRIPSNAPSHOT &trips) {
+    TRACE_SPAN("projectExpenses", "analytics");
+    EXPENSECOLUMNS columns;
+
+    size_t expenseCount = 0;
+    for (const TRIP &trip : trips) {
+        expenseCount += trip.getExpenseTotals().getTotal().count;
+    }
+    columns.amounts.reserve(expenseCount);
+    columns.trips.reserve(expenseCount);
+    columns.members.reserve(expenseCount);
+    columns.days.reserve(expenseCount);
+    columns.categories.reserve(expenseCount);
+
+    DICTIONARY<IDKEY, IDKEY_HASH> tripIDs;
+    DICTIONARY<IDKEY, IDKEY_HASH> hostIDs;
+    DICTIONARY<IDKEY, IDKEY_HASH> memberIDs;
+    DICTIONARY<string> destinations;
+    DICTIONARY<string> statuses;
+    DICTIONARY<int> days;
+    for (const TRIP &trip : trips) {
+        pair<uint32_t, bool> tripCode = tripIDs.add(trip.getKey());
+        if (!tripCode.second) {
+            continue;
+        }
+        columns.tripDestinations.push_back(destinations.code(trip.getDestination()));
+        columns.tripHosts.push_back(hostIDs.code(trip.getHostKey()));
+        columns.tripStatuses.push_back(statuses.code(trip.getStatusString()));
+
+        for (const EXPENSE &expense : trip.getAllExpenses()) {
+            columns.amounts.push_back(expense.getAmount());
+            columns.trips.push_back(tripCode.first);
+            columns.members.push_back(memberIDs.code(expense.getPICKey()));
+            columns.days.push_back(days.code(dayValue(expense.getDate())));
+            columns.categories.push_back(static_cast<uint8_t>(expense.getCategory()));
+        }
+    }
+
+    // NOTE: Renumber every code in value order
+    auto keyString = [](const IDKEY &key) { return key.str(); };
+    auto same = [](const auto &value) { return value; };
+    vector<uint32_t> tripRemap = tripIDs.sortInto(columns.tripIDs, keyString);
+    renumber(columns.trips, tripRemap);
+    columns.tripDestinations = reorder(columns.tripDestinations, tripRemap);
+    columns.tripHosts = reorder(columns.tripHosts, tripRemap);
+    columns.tripStatuses = reorder(columns.tripStatuses, tripRemap);
+    renumber(columns.tripDestinations, destinations.sortInto(columns.destinations, same));
+    renumber(columns.tripHosts, hostIDs.sortInto(columns.hostIDs, keyString));
+    renumber(columns.tripStatuses, statuses.sortInto(columns.statuses, same));
+    renumber(columns.members, memberIDs.sortInto(columns.memberIDs, keyString));
+    renumber(columns.days, days.sortInto(columns.dayValues, same));
+
+    // NOTE: Days are in calendar order now, so their months and years come in order too
+    for (int day : columns.dayValues) {
+        int month = day / 100;
+        int year = day / 10000;
+        if (columns.monthValues.empty() || columns.monthValues.back() != month) {
+            columns.monthValues.push_back(month);
+        }
+        if (columns.yearValues.empty() || columns.yearValues.back() != year) {
+            columns.yearValues.push_back(year);
+        }
+        columns.dayMonths.push_back(static_cast<uint32_t>(columns.monthValues.size() - 1));
+        columns.dayYears.push_back(static_cast<uint32_t>(columns.yearValues.size() - 1));
+    }
+    return columns;
+}
+
+// NOTE: Groups are numbered by their combined key, aggregated per partition and merged; percentiles then sort each
+// group's amounts on their own
+ANALYTICSRESULT runAnalytics(const EXPENSECOLUMNS &columns, const ANALYTICSQUERY &query, unsigned threadCount) {
+    TRACE_SPAN("runAnalytics", "analytics");
+    if (threadCount == 0) {
+        threadCount = max(1u, thread::hardware_concurrency());
+    }
+
+    ANALYTICSRESULT result;
+    for (GROUPKEY key : query.groupBy) {
+        result.keyNames.push_back(groupKeyName(key));
+    }
+    for (const AGGREGATE &aggregate : query.aggregates) {
+        result.valueNames.push_back(aggregateName(aggregate));
+    }
+
+    size_t rowCount = columns.size();
+    if (rowCount == 0) {
+        return result;
+    }
+    size_t partitionCount = partitionCountFor(rowCount, threadCount);
+
+    vector<KEYCOLUMN> keyColumns;
+    for (GROUPKEY key : query.groupBy) {
+        keyColumns.push_back(keyColumnOf(columns, key));
+    }
+
+    vector<uint64_t> groups(rowCount, 0);
+    uint64_t groupCount = 1;
+    for (const KEYCOLUMN &column : keyColumns) {
+        if (groupCount > numeric_limits<uint64_t>::max() / column.cardinality) {
+            groupCount = renumberCombined(groups, partitionCount);
+        }
+        combineKey(groups, column, partitionCount);
+        groupCount *= column.cardinality;
+    }
+    if (groupCount > DIRECT_GROUP_LIMIT) {
+        groupCount = renumberCombined(groups, partitionCount);
+    }
+
+    // NOTE: Every partition keeps a slot per group, so many groups over few rows use fewer partitions
+    size_t accumulatePartitions = min<size_t>(partitionCount, max<size_t>(1, rowCount / groupCount));
+    vector<PARTIAL> partials(accumulatePartitions, PARTIAL(groupCount));
+    runPartitions(rowCount, accumulatePartitions, [&](size_t partition, size_t begin, size_t end) {
+        partials[partition].accumulate(groups.data(), columns.amounts.data(), begin, end);
+    });
+    PARTIAL &total = partials[0];
+    for (size_t partition = 1; partition < partials.size(); ++partition) {
+        total.merge(partials[partition]);
+    }
+
+    bool needsSorted = any_of(query.aggregates.begin(), query.aggregates.end(),
+                              [](const AGGREGATE &aggregate) { return aggregate.kind == AGGREGATEKIND::Percentile; });
+    vector<long long> sorted;
+    vector<size_t> offsets;
+    if (needsSorted) {
+        offsets = sortAmountsByGroup(groups, columns.amounts, total.counts, partitionCount, sorted);
+    }
+
+    for (size_t group = 0; group < groupCount; ++group) {
+        uint64_t count = total.counts[group];
+        if (count == 0) {
+            continue;
+        }
+        ANALYTICSROW row;
+        size_t firstRow = total.firstRows[group];
+        for (size_t i = 0; i < keyColumns.size(); ++i) {
+            row.keys.push_back(keyLabel(columns, query.groupBy[i], keyColumns[i].codeOf(firstRow)));
+        }
+        for (const AGGREGATE &aggregate : query.aggregates) {
+            switch (aggregate.kind) {
+                case AGGREGATEKIND::Sum:
+                    row.values.push_back(static_cast<double>(total.sums[group]));
+                    break;
+                case AGGREGATEKIND::Count:
+                    row.values.push_back(static_cast<double>(count));
+                    break;
+                case AGGREGATEKIND::Avg:
+                    row.values.push_back(static_cast<double>(total.sums[group]) / static_cast<double>(count));
+                    break;
+                case AGGREGATEKIND::Min:
+                    row.values.push_back(static_cast<double>(total.mins[group]));
+                    break;
+                case AGGREGATEKIND::Max:
+                    row.values.push_back(static_cast<double>(total.maxes[group]));
+                    break;
+                case AGGREGATEKIND::Percentile:
+                    row.values.push_back(percentileOf(sorted.data() + offsets[group], count, aggregate.percentile));
+                    break;
+            }
+        }
+        result.rows.push_back(move(row));
+    }
+    return result;
+}
+
+// FUNC: Names
+const vector<GROUPKEY> &allGroupKeys() {
+    static const vector<GROUPKEY> keys = {GROUPKEY::Trip,     GROUPKEY::Destination, GROUPKEY::Host,
+                                          GROUPKEY::Member,   GROUPKEY::Category,    GROUPKEY::Day,
+                                          GROUPKEY::Month,    GROUPKEY::Year,       GROUPKEY::Status};
+    return keys;
+}
+
+string groupKeyName(GROUPKEY key) {
+    switch (key) {
+        case GROUPKEY::Trip:
+            return "trip";
+        case GROUPKEY::Destination:
+            return "destination";
+        case GROUPKEY::Host:
+            return "host";
+        case GROUPKEY::Member:
+            return "member";
+        case GROUPKEY::Category:
+            return "category";
+        case GROUPKEY::Day:
+            return "day";
+        case GROUPKEY::Month:
+            return "month";
+        case GROUPKEY::Year:
+            return "year";
+        case GROUPKEY::Status:
+            return "status";
+    }
+    return "";
+}
+
+GROUPKEY parseGroupKey(const string &name) {
+    for (GROUPKEY key : allGroupKeys()) {
+        if (groupKeyName(key) == name) {
+            return key;
+        }
+    }
+    throw runtime_error("unknown group key " + name +
+                        " (trip, destination, host, member, category, day, month, year or status)");
+}
+
+AGGREGATE parseAggregate(const string &name) {
+    AGGREGATE aggregate;
+    if (name == "sum") {
+        aggregate.kind = AGGREGATEKIND::Sum;
+    } else if (name == "count") {
+        aggregate.kind = AGGREGATEKIND::Count;
+    } else if (name == "avg") {
+        aggregate.kind = AGGREGATEKIND::Avg;
+    } else if (name == "min") {
+        aggregate.kind = AGGREGATEKIND::Min;
+    } else if (name == "max") {
+        aggregate.kind = AGGREGATEKIND::Max;
+    } else if (name == "median") {
+        aggregate.kind = AGGREGATEKIND::Percentile;
+        aggregate.percentile = 50;
+    } else if (name.size() > 1 && name[0] == 'p') {
+        aggregate.kind = AGGREGATEKIND::Percentile;
+        size_t parsed = 0;
+        try {
+            aggregate.percentile = stod(name.substr(1), &parsed);
+        } catch (const exception &) {
+            parsed = 0;
+        }
+        if (parsed != name.size() - 1 || aggregate.percentile < 0 || aggregate.percentile > 100) {
+            throw runtime_error("bad percentile " + name + " (p0 to p100)");
+        }
+    } else {
+        throw runtime_error("unknown aggregate " + name + " (sum, count, avg, min, max, median or p<0-100>)");
+    }
+    return aggregate;
+}
+
+string aggregateName(const AGGREGATE &aggregate) {
+    switch (aggregate.kind) {
+        case AGGREGATEKIND::Sum:
+            return "sum";
+        case AGGREGATEKIND::Count:
+            return "count";
+        case AGGREGATEKIND::Avg:
+            return "avg";
+        case AGGREGATEKIND::Min:
+            return "min";
+        case AGGREGATEKIND::Max:
+            return "max";
+        case AGGREGATEKIND::Percentile: {
+            ostringstream name;
+            name << 'p' << aggregate.percentile;
+            return name.str();
+        }
+    }
+    return "";
+}
+
+string formatAggregateValue(const AGGREGATE &aggregate, double value) {
+    if (aggregate.kind == AGGREGATEKIND::Avg || aggregate.kind == AGGREGATEKIND::Percentile) {
+        ostringstream text;
+        text << fixed << setprecision(2) << value;
+        return text.str();
+    }
+    return to_string(llround(value));
+}
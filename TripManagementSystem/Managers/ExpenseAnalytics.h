@@ -0,0 +1,103 @@
+#ifndef EXPENSEANALYTICS_H
+#define EXPENSEANALYTICS_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "../Models/header.h"
+#include "TripSnapshot.h"
+
+using namespace std;
+
+// ==================== EXPENSE ANALYTICS ====================
+// Group-by queries over every expense of the store, such as the total spend by destination per month or the average
+// cost per member by category. The trips are projected once into columns; a query then only runs tight loops over
+// those arrays, split into contiguous partitions on separate threads.
+
+// CLASS: GROUPKEY
+// What expenses are grouped by. Member is the person in charge of the expense, the dates are the expense's own.
+enum class GROUPKEY { Trip, Destination, Host, Member, Category, Day, Month, Year, Status };
+
+// CLASS: AGGREGATE
+// One value computed over the amounts of each group. Percentiles interpolate between the two nearest amounts.
+enum class AGGREGATEKIND { Sum, Count, Avg, Min, Max, Percentile };
+
+struct AGGREGATE {
+    AGGREGATEKIND kind = AGGREGATEKIND::Sum;
+    // NOTE: 0 to 100, only read for percentiles
+    double percentile = 50;
+};
+
+// CLASS: EXPENSECOLUMNS
+// Columnar projection of the expenses, one entry per expense in each row column. Trip attributes are stored once per
+// trip and month and year once per day, reached through the row's trip or day code. Every code indexes a sorted list
+// of values, so ordering codes orders the values.
+struct EXPENSECOLUMNS {
+    // NOTE: Row columns
+    vector<long long> amounts;
+    vector<uint32_t> trips;
+    vector<uint32_t> members;
+    vector<uint32_t> days;
+    vector<uint8_t> categories;
+
+    // NOTE: By trip code
+    vector<uint32_t> tripDestinations;
+    vector<uint32_t> tripHosts;
+    vector<uint32_t> tripStatuses;
+    // NOTE: By day code
+    vector<uint32_t> dayMonths;
+    vector<uint32_t> dayYears;
+
+    // NOTE: The values behind the codes, dates as yyyymmdd, yyyymm and yyyy
+    vector<string> tripIDs;
+    vector<string> destinations;
+    vector<string> hostIDs;
+    vector<string> memberIDs;
+    vector<string> statuses;
+    vector<int> dayValues;
+    vector<int> monthValues;
+    vector<int> yearValues;
+
+    size_t size() const { return this->amounts.size(); }
+};
+
+// NOTE: Reads the expenses, so header-only trips add no rows; load their details first. Only the first trip with a
+// given ID is projected, matching TRIPMANAGER::findTripById.
+EXPENSECOLUMNS projectExpenses(const TRIPSNAPSHOT &trips);
+
+// CLASS: ANALYTICSQUERY
+// No group keys gives one row over all expenses
+struct ANALYTICSQUERY {
+    vector<GROUPKEY> groupBy;
+    vector<AGGREGATE> aggregates;
+};
+
+struct ANALYTICSROW {
+    vector<string> keys;
+    vector<double> values;
+};
+
+// CLASS: ANALYTICSRESULT
+// One row per group with expenses, ordered by the keys with the first one varying slowest. Names sort as text, dates
+// in calendar order and categories in the order of CATEGORY.
+struct ANALYTICSRESULT {
+    vector<string> keyNames;
+    vector<string> valueNames;
+    vector<ANALYTICSROW> rows;
+};
+
+// NOTE: threadCount 0 uses every hardware thread, small projections run on the calling thread only
+ANALYTICSRESULT runAnalytics(const EXPENSECOLUMNS &columns, const ANALYTICSQUERY &query, unsigned threadCount = 0);
+
+// FUNC: Names as the CLI and the analytics dialog take them: trip, destination, host, member, category, day, month,
+// year, status and sum, count, avg, min, max, median, p<0-100>. Unknown names throw.
+const vector<GROUPKEY> &allGroupKeys();
+GROUPKEY parseGroupKey(const string &name);
+string groupKeyName(GROUPKEY key);
+AGGREGATE parseAggregate(const string &name);
+string aggregateName(const AGGREGATE &aggregate);
+// NOTE: Sums, counts, minimums and maximums are whole amounts, averages and percentiles keep two decimals
+string formatAggregateValue(const AGGREGATE &aggregate, double value);
+
+#endif  // EXPENSEANALYTICS_H
@@ -1,9 +1,5 @@
 #pragma once
 
-#include <QDebug>
-#include <QDir>
-#include <QFileInfo>
-#include <QMessageBox>
 #include <fstream>
 #include <nlohmann/json.hpp>
 #include <sstream>
@@ -13,6 +9,7 @@
 
 #include "../Managers/PersonFactory.h"
 #include "../Managers/TripFactory.h"
+#include "../Managers/TripSnapshot.h"
 #include "../Models/header.h"
 
 class PERSONMANAGER;
@@ -20,15 +17,29 @@ class PERSONMANAGER;
 using namespace std;
 using json = nlohmann::ordered_json;
 
+// CLASS: PENDINGDETAILS
+// Details of a header-only trip as read from the file: an object of "host_id", "member_ids" and "expenses"
+struct PENDINGDETAILS {
+    json value;
+};
+
+// ==================== CACHE LOCATION ====================
+// NOTE: The cache files live in "cache" under the working directory unless another directory is set
+void setCacheDirectory(const string &directory);
+string getCacheDirectory();
+
 // ==================== TRIP FUNCTIONS (JSON ONLY) ====================
 
 void importTripInfoFromJson(vector<TRIP> &trips, const string &filePath, const PERSONMANAGER *personManager);
+void importTripHeadersFromJson(vector<TRIP> &trips, const string &filePath);
 void exportTripsInfoToJson(const vector<TRIP> &trips, const string &outputFilePath);
+void exportTripsInfoToJson(const TRIPSNAPSHOT &trips, const string &outputFilePath);
 
-void loadTripCacheFile(vector<TRIP> &trips, const PERSONMANAGER *personManager);
+void loadTripCacheFile(vector<TRIP> &trips);
 void updateCacheFile(const vector<TRIP> &trips);
+void updateCacheFile(const TRIPSNAPSHOT &trips);
 bool cacheFileExists();
-QString getCacheFilePath();
+string getCacheFilePath();
 
 void saveTripDataToCache(const vector<TRIP> &trips, const string &filePath);
 void loadTripDataFromCache(vector<TRIP> &trips, const string &filePath, const PERSONMANAGER *personManager);
@@ -36,37 +47,37 @@ void importTripsFromFile(vector<TRIP> &trips, const string &filePath, const PERS
 void exportTripsToFile(const vector<TRIP> &trips, const string &filePath);
 
 void from_json(const json &j, TRIP &trip, const PERSONMANAGER *personManager);
+void tripHeaderFromJson(const json &j, TRIP &trip);
+void tripDetailsFromJson(const json &j, TRIP &trip, const PERSONMANAGER *personManager);
+void tripHeaderWithPendingDetailsFromJson(json &&j, TRIP &trip);
+void loadTripDetails(TRIP &trip, const PERSONMANAGER *personManager);
+bool renamePendingPerson(TRIP &trip, const string &oldID, const string &newID);
 void to_json(json &j, const TRIP &trip);
 
 void importTripFromCache(vector<TRIP> &trips, const string &filePath, const PERSONMANAGER *personManager);
 void saveTripAttendeesToCache(const vector<TRIP> &trips, const string &filePath);
 
 // ==================== PEOPLE FUNCTIONS ====================
-void importPeopleInfoFromJson(vector<MEMBER> &members, vector<HOST> &hosts, const string &filePath,
-                              const PERSONMANAGER *personManager = nullptr);
+void importPeopleInfoFromJson(vector<MEMBER> &members, vector<HOST> &hosts, const string &filePath);
 void exportPeopleInfoToJson(const vector<MEMBER> &members, const vector<HOST> &hosts, const string &outputFilePath);
 
-void loadPeopleCacheFile(vector<MEMBER> &members, vector<HOST> &hosts, const PERSONMANAGER *personManager = nullptr);
+void loadPeopleCacheFile(vector<MEMBER> &members, vector<HOST> &hosts);
 void updatePeopleCacheFile(const vector<MEMBER> &members, const vector<HOST> &hosts);
 bool peopleCacheFileExists();
-QString getPeopleCacheFilePath();
+string getPeopleCacheFilePath();
 
 void savePeopleDataToCache(const vector<MEMBER> &members, const vector<HOST> &hosts, const string &filePath);
-void loadPeopleDataFromCache(vector<MEMBER> &members, vector<HOST> &hosts, const string &filePath,
-                             const PERSONMANAGER *personManager = nullptr);
-void importPeopleFromFile(vector<MEMBER> &members, vector<HOST> &hosts, const string &filePath,
-                          const PERSONMANAGER *personManager = nullptr);
+void loadPeopleDataFromCache(vector<MEMBER> &members, vector<HOST> &hosts, const string &filePath);
+void importPeopleFromFile(vector<MEMBER> &members, vector<HOST> &hosts, const string &filePath);
 void exportPeopleToFile(const vector<MEMBER> &members, const vector<HOST> &hosts, const string &filePath);
 
 void from_json(const json &j, PERSON &person);
-vector<pair<string, EXPENSE>> parseSpendingsFromJson(const json &spendingsJson, const PERSONMANAGER *personManager);
-json spendingsToJson(const vector<pair<string, EXPENSE>> &spendings);
-
-vector<pair<string, EXPENSE>> getSpendingsForMember(const string &memberID, const vector<MEMBER> &members);
-void updateMemberSpending(const string &memberID, const vector<pair<string, EXPENSE>> &newSpendings,
-                          vector<MEMBER> &members);
 
 // ==================== HELPER FUNCTIONS ====================
 DATE extractDate(string _date);
 
+// NOTE: Counts a finished write of the "trip" or "people" cache in cache.<kind>.writes and its size in
+// cache.bytes_written
+void recordCacheWrite(const string &kind, const string &filePath);
+
 string toUpper(const string &str);
\ No newline at end of file
@@ -1,82 +1,19 @@
+#include <filesystem>
+
 #include "FileManager.h"
 #include "PersonFactory.h"
+#include "Metrics.h"
 #include "PersonManager.h"
+#include "Trace.h"
 
 using namespace std;
 
-QString getPeopleCacheFilePath() {
-    QDir currentDir = QDir::current();
-
-    if (currentDir.exists("cache")) {
-        return currentDir.absoluteFilePath("cache/people_cache.json");
-    } else {
-        throw std::runtime_error("Cache folder not found in current directory: " +
-                                 currentDir.absolutePath().toStdString());
-    }
-}
-
-bool peopleCacheFileExists() {
-    QFileInfo cacheFile(getPeopleCacheFilePath());
-    return cacheFile.exists();
-}
-
-vector<pair<string, EXPENSE>> parseSpendingsFromJson(const json &spendingsJson, const PERSONMANAGER *personManager) {
-    vector<pair<string, EXPENSE>> spendings;
-
-    if (!spendingsJson.is_array()) {
-        return spendings;
-    }
-
-    for (const auto &spendingJson : spendingsJson) {
-        try {
-            string tripId = spendingJson.value("trip_id", "");
-            string dateStr = spendingJson.value("date", "");
-            string categoryStr = spendingJson.value("category", "");
-            long long amount = spendingJson.value("amount", 0);
-            string note = spendingJson.value("note", "");
-            string personId = spendingJson.value("personInCharge", "");
-
-            if (tripId.empty() || dateStr.empty() || amount <= 0 || personId.empty()) {
-                continue;
-            }
+string getPeopleCacheFilePath() { return (filesystem::path(getCacheDirectory()) / "people_cache.json").string(); }
 
-            DATE expenseDate = extractDate(dateStr);
-            CATEGORY category = stringToCategory(categoryStr);
-
-            MEMBER pic(personId, "Temporary Name", GENDER::Male, DATE(1, 1, 2000));
-
-            EXPENSE expense(expenseDate, category, amount, note, pic);
-            spendings.push_back(make_pair(tripId, expense));
-
-        } catch (const std::exception &e) {
-            continue;
-        }
-    }
-
-    return spendings;
-}
-
-json spendingsToJson(const vector<pair<string, EXPENSE>> &spendings) {
-    json spendingsJson = json::array();
-
-    for (const auto &spending : spendings) {
-        try {
-            json spendingJson = {{"trip_id", spending.first},
-                                 {"date", spending.second.getDate().toString()},
-                                 {"category", categoryToString(spending.second.getCategory())},
-                                 {"amount", spending.second.getAmount()},
-                                 {"note", spending.second.getNote()},
-                                 {"personInCharge", spending.second.getPIC().getID()}};
-            spendingsJson.push_back(spendingJson);
-        } catch (const std::exception &e) {
-            continue;
-        }
-    }
-
-    return spendingsJson;
-}
+bool peopleCacheFileExists() { return filesystem::exists(getPeopleCacheFilePath()); }
 
 void from_json(const json &j, PERSON &person) {
+    TRACE_SPAN("from_json", "parse");
     try {
         string id = j.value("id", "");
         string fullName = j.value("full_name", "");
@@ -105,8 +42,8 @@ void from_json(const json &j, PERSON &person) {
     }
 }
 
-void importPeopleInfoFromJson(vector<MEMBER> &members, vector<HOST> &hosts, const string &filePath,
-                              const PERSONMANAGER *personManager) {
+void importPeopleInfoFromJson(vector<MEMBER> &members, vector<HOST> &hosts, const string &filePath) {
+    TRACE_SPAN("importPeopleInfoFromJson", "load");
     ifstream file(filePath);
     if (!file.is_open()) {
         throw std::runtime_error("Cannot open JSON file for import: " + filePath);
@@ -123,8 +60,14 @@ void importPeopleInfoFromJson(vector<MEMBER> &members, vector<HOST> &hosts, cons
 
         members.clear();
         hosts.clear();
+        members.reserve(j.size());
+        hosts.reserve(j.size());
 
+        // NOTE: People are built in place so a snapshot arena holds exactly one copy of each
         for (const auto &personJson : j) {
+            size_t memberCount = members.size();
+            size_t hostCount = hosts.size();
+
             try {
                 if (!personJson.contains("role")) {
                     continue;
@@ -147,7 +90,8 @@ void importPeopleInfoFromJson(vector<MEMBER> &members, vector<HOST> &hosts, cons
                 GENDER gender = stringToGender(genderStr);
 
                 if (role == "Member") {
-                    MEMBER member(id, fullName, gender, dob);
+                    MEMBER &member = members.emplace_back(id, fullName, gender, dob);
+                    member.setUpdatedAt(personJson.value("updated_at", 0LL));
                     member.setEmail(email);
                     member.setPhoneNumber(phone);
                     member.setAddress(address);
@@ -163,32 +107,22 @@ void importPeopleInfoFromJson(vector<MEMBER> &members, vector<HOST> &hosts, cons
                         }
                     }
 
-                    if (personJson.contains("spendings") && personJson["spendings"].is_array()) {
-                        vector<pair<string, EXPENSE>> spendings =
-                            parseSpendingsFromJson(personJson["spendings"], nullptr);
-                        member.setSpendings(spendings);
-                    }
-
-                    if (personJson.contains("total_spent") && personJson["total_spent"].is_number()) {
-                        long long totalSpent = personJson["total_spent"].get<long long>();
-                        member.setTotalSpent(totalSpent);
-                    }
-
-                    members.push_back(member);
-
+                    // NOTE: "spendings" and "total_spent" from older files are ignored, they are derived from the
+                    // trip expenses now
                 } else if (role == "Host") {
-                    HOST host(id, fullName, gender, dob);
+                    HOST &host = hosts.emplace_back(id, fullName, gender, dob);
+                    host.setUpdatedAt(personJson.value("updated_at", 0LL));
                     host.setEmail(email);
                     host.setPhoneNumber(phone);
                     host.setAddress(address);
 
                     string emergencyContact = personJson.value("emergency_contact", "");
                     host.setEmergencyContact(emergencyContact);
-
-                    hosts.push_back(host);
                 }
 
             } catch (const std::exception &e) {
+                members.resize(memberCount);
+                hosts.resize(hostCount);
                 continue;
             }
         }
@@ -203,6 +137,7 @@ void importPeopleInfoFromJson(vector<MEMBER> &members, vector<HOST> &hosts, cons
 }
 
 void exportPeopleInfoToJson(const vector<MEMBER> &members, const vector<HOST> &hosts, const string &outputFilePath) {
+    TRACE_SPAN("exportPeopleInfoToJson", "save");
     ofstream output(outputFilePath);
     if (!output.is_open()) {
         throw runtime_error("Cannot open file for writing: " + outputFilePath);
@@ -220,7 +155,8 @@ void exportPeopleInfoToJson(const vector<MEMBER> &members, const vector<HOST> &h
                          {"address", host.getAddress()},
                          {"gender", genderToString(host.getGender())},
                          {"role", "Host"},
-                         {"emergency_contact", host.getEmergencyContact()}};
+                         {"emergency_contact", host.getEmergencyContact()},
+                         {"updated_at", host.getUpdatedAt()}};
         j.push_back(hostJson);
     }
 
@@ -234,7 +170,7 @@ void exportPeopleInfoToJson(const vector<MEMBER> &members, const vector<HOST> &h
                            {"gender", genderToString(member.getGender())},
                            {"role", "Member"},
                            {"emergency_contact", member.getEmergencyContact()},
-                           {"total_spent", member.getTotalSpent()}};
+                           {"updated_at", member.getUpdatedAt()}};
 
         try {
             vector<string> interests = member.getInterests();
@@ -247,13 +183,6 @@ void exportPeopleInfoToJson(const vector<MEMBER> &members, const vector<HOST> &h
             memberJson["interests"] = json::array();
         }
 
-        try {
-            vector<pair<string, EXPENSE>> spendings = member.getSpendings();
-            memberJson["spendings"] = spendingsToJson(spendings);
-        } catch (...) {
-            memberJson["spendings"] = json::array();
-        }
-
         j.push_back(memberJson);
     }
 
@@ -261,29 +190,34 @@ void exportPeopleInfoToJson(const vector<MEMBER> &members, const vector<HOST> &h
     output.close();
 }
 
-void loadPeopleCacheFile(vector<MEMBER> &members, vector<HOST> &hosts, const PERSONMANAGER *personManager) {
-    QString cacheFilePath = getPeopleCacheFilePath();
+void loadPeopleCacheFile(vector<MEMBER> &members, vector<HOST> &hosts) {
+    TRACE_SPAN("loadPeopleCacheFile", "load");
+    static METRICHISTOGRAM &loadTime = metricHistogram("cache.people.load_ns");
+    METRICTIMER timer(loadTime);
+    string cacheFilePath = getPeopleCacheFilePath();
 
-    QFileInfo cacheFile(cacheFilePath);
-    if (!cacheFile.exists()) {
+    if (!filesystem::exists(cacheFilePath)) {
         return;
     }
 
     members.clear();
     hosts.clear();
-    importPeopleInfoFromJson(members, hosts, cacheFilePath.toStdString(), personManager);
+    importPeopleInfoFromJson(members, hosts, cacheFilePath);
 }
 
 void updatePeopleCacheFile(const vector<MEMBER> &members, const vector<HOST> &hosts) {
-    QString cacheFilePath = getPeopleCacheFilePath();
+    TRACE_SPAN("updatePeopleCacheFile", "save");
+    static METRICHISTOGRAM &writeTime = metricHistogram("cache.people.write_ns");
+    METRICTIMER timer(writeTime);
+    string cacheFilePath = getPeopleCacheFilePath();
 
-    exportPeopleInfoToJson(members, hosts, cacheFilePath.toStdString());
+    exportPeopleInfoToJson(members, hosts, cacheFilePath);
+    recordCacheWrite("people", cacheFilePath);
 }
 
-void importPeopleFromFile(vector<MEMBER> &members, vector<HOST> &hosts, const string &filePath,
-                          const PERSONMANAGER *personManager) {
+void importPeopleFromFile(vector<MEMBER> &members, vector<HOST> &hosts, const string &filePath) {
     try {
-        importPeopleInfoFromJson(members, hosts, filePath, personManager);
+        importPeopleInfoFromJson(members, hosts, filePath);
     } catch (const exception &e) {
         throw runtime_error("Failed to import people from file: " + string(e.what()));
     }
@@ -304,36 +238,10 @@ void savePeopleDataToCache(const vector<MEMBER> &members, const vector<HOST> &ho
     }
 }
 
-void loadPeopleDataFromCache(vector<MEMBER> &members, vector<HOST> &hosts, const string &filePath,
-                             const PERSONMANAGER *personManager) {
+void loadPeopleDataFromCache(vector<MEMBER> &members, vector<HOST> &hosts, const string &filePath) {
     try {
-        importPeopleInfoFromJson(members, hosts, filePath, personManager);
+        importPeopleInfoFromJson(members, hosts, filePath);
     } catch (const exception &e) {
         throw runtime_error("Failed to load people data from cache: " + string(e.what()));
     }
 }
-
-vector<pair<string, EXPENSE>> getSpendingsForMember(const string &memberID, const vector<MEMBER> &members) {
-    for (const MEMBER &member : members) {
-        if (member.getID() == memberID) {
-            return member.getSpendings();
-        }
-    }
-    return vector<pair<string, EXPENSE>>();
-}
-
-void updateMemberSpending(const string &memberID, const vector<pair<string, EXPENSE>> &newSpendings,
-                          vector<MEMBER> &members) {
-    for (MEMBER &member : members) {
-        if (member.getID() == memberID) {
-            member.setSpendings(newSpendings);
-
-            long long totalSpent = 0;
-            for (const auto &spending : newSpendings) {
-                totalSpent += spending.second.getAmount();
-            }
-            member.setTotalSpent(totalSpent);
-            break;
-        }
-    }
-}
@@ -1,22 +1,40 @@
+#include <filesystem>
+
 #include "../Models/header.h"
 #include "FileManager.h"
+#include "Log.h"
+#include "Metrics.h"
 #include "PersonManager.h"
+#include "Trace.h"
 
 using namespace std;
 
-QString getCacheFilePath() {
-    QDir currentDir = QDir::current();
-    if (currentDir.exists("cache")) {
-        return currentDir.absoluteFilePath("cache/cache.json");
-    } else {
-        throw std::runtime_error("Cache folder not found in current directory: " +
-                                 currentDir.absolutePath().toStdString());
+namespace {
+string cacheDirectory;
+}  // namespace
+
+void setCacheDirectory(const string &directory) { cacheDirectory = directory; }
+
+string getCacheDirectory() {
+    filesystem::path directory =
+        cacheDirectory.empty() ? filesystem::current_path() / "cache" : filesystem::path(cacheDirectory);
+    if (!filesystem::is_directory(directory)) {
+        throw std::runtime_error("Cache folder not found: " + filesystem::absolute(directory).string());
     }
+    return filesystem::absolute(directory).string();
 }
 
-bool cacheFileExists() {
-    QFileInfo cacheFile(getCacheFilePath());
-    return cacheFile.exists();
+string getCacheFilePath() { return (filesystem::path(getCacheDirectory()) / "cache.json").string(); }
+
+bool cacheFileExists() { return filesystem::exists(getCacheFilePath()); }
+
+void recordCacheWrite(const string &kind, const string &filePath) {
+    metricCounter("cache." + kind + ".writes").add();
+    error_code error;
+    uintmax_t size = filesystem::file_size(filePath, error);
+    if (!error) {
+        metricCounter("cache.bytes_written").add(size);
+    }
 }
 
 DATE extractDate(string _date) {
@@ -35,92 +53,219 @@ DATE extractDate(string _date) {
     return date;
 }
 
-void from_json(const json &j, TRIP &trip, const PERSONMANAGER *personManager) {
-    try {
-        string idStr = j.value("id", "");
-        string destinationStr = j.value("destination", "");
-        string descriptionStr = j.value("description", "");
-        string startDateStr = j.value("start_date", "");
-        string endDateStr = j.value("end_date", "");
-        string statusStr = j.value("status", "Planned");
-
-        if (idStr.empty() || destinationStr.empty() || startDateStr.empty() || endDateStr.empty()) {
-            throw std::runtime_error("Missing required trip fields in JSON");
-        }
+void tripHeaderFromJson(const json &j, TRIP &trip) {
+    string idStr = j.value("id", "");
+    string destinationStr = j.value("destination", "");
+    string descriptionStr = j.value("description", "");
+    string startDateStr = j.value("start_date", "");
+    string endDateStr = j.value("end_date", "");
+    string statusStr = j.value("status", "Planned");
 
-        DATE startDate = extractDate(startDateStr);
-        DATE endDate = extractDate(endDateStr);
-        STATUS status = stringToStatus(statusStr);
+    if (idStr.empty() || destinationStr.empty() || startDateStr.empty() || endDateStr.empty()) {
+        throw std::runtime_error("Missing required trip fields in JSON");
+    }
+
+    DATE startDate = extractDate(startDateStr);
+    DATE endDate = extractDate(endDateStr);
+    STATUS status = stringToStatus(statusStr);
+
+    vector<EXPENSE> expenses;
+    trip = TRIP(idStr, destinationStr, descriptionStr, startDate, endDate, status, expenses);
+    trip.setUpdatedAt(j.value("updated_at", 0LL));
+}
 
-        vector<EXPENSE> expenses;
-        long long totalExpense = 0;
-        trip = TRIP(idStr, toUpper(destinationStr), descriptionStr, startDate, endDate, status, expenses, totalExpense);
+void tripDetailsFromJson(const json &j, TRIP &trip, const PERSONMANAGER *personManager) {
+    if (!personManager) {
+        return;
+    }
 
-        if (personManager) {
-            vector<HOST> hosts = personManager->getAllHosts();
-            vector<MEMBER> members = personManager->getAllMembers();
+    string hostID = j.value("host_id", "");
+    if (!hostID.empty()) {
+        shared_ptr<const HOST> host = personManager->shareHostById(hostID);
+        if (host) {
+            trip.setHost(*host);
+        }
+    }
 
-            string hostID = j.value("host_id", "");
-            if (!hostID.empty()) {
-                auto it = find_if(hosts.begin(), hosts.end(), [&](const HOST &host) { return host.getID() == hostID; });
-                if (it != hosts.end()) {
-                    trip.setHost(*it);
+    if (j.contains("member_ids") && j["member_ids"].is_array()) {
+        for (const auto &memberIdJson : j["member_ids"]) {
+            string memberID = memberIdJson.get<string>();
+            if (!memberID.empty()) {
+                shared_ptr<const MEMBER> member = personManager->shareMemberById(memberID);
+                if (member) {
+                    trip.addMember(*member);
                 }
             }
+        }
+    }
 
-            if (j.contains("member_ids") && j["member_ids"].is_array()) {
-                for (const auto &memberIdJson : j["member_ids"]) {
-                    string memberID = memberIdJson.get<string>();
-                    if (!memberID.empty()) {
-                        auto it = find_if(members.begin(), members.end(),
-                                          [&](const MEMBER &member) { return member.getID() == memberID; });
-                        if (it != members.end()) {
-                            trip.addMember(*it);
-                        }
-                    }
+    if (j.contains("expenses") && j["expenses"].is_array()) {
+        for (const auto &expenseJson : j["expenses"]) {
+            try {
+                string dateStr = expenseJson.value("date", "");
+                string categoryStr = expenseJson.value("category", "");
+                long long amount = expenseJson.value("amount", 0LL);
+                string note = expenseJson.value("note", "");
+                string picID = expenseJson.value("personInCharge", "");
+
+                if (dateStr.empty() || amount <= 0 || picID.empty()) {
+                    continue;
                 }
-            }
 
-            if (j.contains("expenses") && j["expenses"].is_array()) {
-                for (const auto &expenseJson : j["expenses"]) {
-                    try {
-                        string dateStr = expenseJson.value("date", "");
-                        string categoryStr = expenseJson.value("category", "");
-                        long long amount = expenseJson.value("amount", 0);
-                        string note = expenseJson.value("note", "");
-                        string picID = expenseJson.value("personInCharge", "");
-
-                        if (dateStr.empty() || amount <= 0 || picID.empty()) {
-                            continue;
-                        }
-
-                        DATE expenseDate = extractDate(dateStr);
-                        CATEGORY category = stringToCategory(categoryStr);
-
-                        MEMBER pic;
-                        auto memberIt = find_if(members.begin(), members.end(),
-                                                [&](const MEMBER &member) { return member.getID() == picID; });
-                        if (memberIt != members.end()) {
-                            pic = *memberIt;
-                        } else {
-                            continue;
-                        }
-
-                        EXPENSE expense(expenseDate, category, amount, note, pic);
-                        trip.addExpense(expense);
-
-                    } catch (const std::exception &e) {
-                        continue;
-                    }
+                DATE expenseDate = extractDate(dateStr);
+                CATEGORY category = stringToCategory(categoryStr);
+
+                shared_ptr<const MEMBER> pic = personManager->shareMemberById(picID);
+                if (!pic) {
+                    continue;
                 }
+
+                EXPENSE expense(expenseDate, category, amount, note, *pic);
+                // NOTE: Files written before expense IDs existed have none, the trip allocates them
+                expense.setID(expenseJson.value("id", ""));
+                trip.addExpense(expense);
+
+            } catch (const std::exception &e) {
+                continue;
             }
         }
+    }
+}
 
+void from_json(const json &j, TRIP &trip, const PERSONMANAGER *personManager) {
+    TRACE_SPAN("from_json", "parse");
+    try {
+        tripHeaderFromJson(j, trip);
+        tripDetailsFromJson(j, trip, personManager);
     } catch (const std::exception &e) {
         throw std::runtime_error("Error parsing trip from JSON: " + string(e.what()));
     }
 }
 
+// NOTE: Only the columns shown in the main table are materialized, the rest is resolved by loadTripDetails
+namespace {
+void pendingExpenseToTotals(const json &expenseJson, const string &picID, EXPENSETOTALS &totals) {
+    try {
+        string dateStr = expenseJson.value("date", "");
+        long long amount = expenseJson.value("amount", 0LL);
+        if (dateStr.empty() || amount <= 0) {
+            return;
+        }
+        totals.add(amount, stringToCategory(expenseJson.value("category", "")), IDKEY(picID), extractDate(dateStr));
+    } catch (const std::exception &e) {
+        return;
+    }
+}
+
+// NOTE: Keeps the parsed details together with the IDs and totals read from them
+void setPendingDetailsFromJson(json details, TRIP &trip) {
+    trip.setPendingHostID(details["host_id"].is_string() ? details["host_id"].get<string>() : "");
+
+    vector<string> memberIDs;
+    for (const auto &memberIdJson : details["member_ids"]) {
+        if (memberIdJson.is_string() && !memberIdJson.get<string>().empty()) {
+            memberIDs.push_back(memberIdJson.get<string>());
+        }
+    }
+    trip.setPendingMemberIDs(memberIDs);
+
+    // NOTE: The totals take the expenses loading the details would keep, as far as the header can tell
+    vector<string> payerIDs;
+    EXPENSETOTALS totals;
+    for (const auto &expenseJson : details["expenses"]) {
+        string picID = expenseJson.is_object() ? expenseJson.value("personInCharge", "") : "";
+        if (!picID.empty()) {
+            payerIDs.push_back(picID);
+            pendingExpenseToTotals(expenseJson, picID, totals);
+        }
+    }
+    trip.setPendingPayerIDs(payerIDs);
+    trip.setPendingExpenseTotals(totals);
+    trip.setPendingDetails(make_shared<const PENDINGDETAILS>(PENDINGDETAILS{move(details)}));
+}
+}  // namespace
+
+// NOTE: The member and expense lists are moved out of the trip's JSON, not copied
+void tripHeaderWithPendingDetailsFromJson(json &&j, TRIP &trip) {
+    TRACE_SPAN("tripHeaderWithPendingDetailsFromJson", "parse");
+    try {
+        tripHeaderFromJson(j, trip);
+
+        json details = json::object();
+        details["host_id"] = j.value("host_id", "");
+        details["member_ids"] = json::array();
+        details["expenses"] = json::array();
+        if (j.contains("member_ids") && j["member_ids"].is_array()) {
+            details["member_ids"] = move(j["member_ids"]);
+        }
+        if (j.contains("expenses") && j["expenses"].is_array()) {
+            details["expenses"] = move(j["expenses"]);
+        }
+        setPendingDetailsFromJson(move(details), trip);
+    } catch (const std::exception &e) {
+        throw std::runtime_error("Error parsing trip header from JSON: " + string(e.what()));
+    }
+}
+
+// NOTE: Details not loaded yet name people by ID, so a changed ID is rewritten in the pending JSON; loading them
+// later would otherwise drop the person as missing. The shared details are only copied when they name the person.
+bool renamePendingPerson(TRIP &trip, const string &oldID, const string &newID) {
+    if (trip.isDetailsLoaded() || oldID == newID || !trip.getPendingDetails()) {
+        return false;
+    }
+
+    auto forEachID = [](auto &details, auto visit) {
+        if (details.contains("host_id")) {
+            visit(details["host_id"]);
+        }
+        if (details.contains("member_ids")) {
+            for (auto &memberIdJson : details["member_ids"]) {
+                visit(memberIdJson);
+            }
+        }
+        if (details.contains("expenses")) {
+            for (auto &expenseJson : details["expenses"]) {
+                if (expenseJson.is_object() && expenseJson.contains("personInCharge")) {
+                    visit(expenseJson["personInCharge"]);
+                }
+            }
+        }
+    };
+    auto isOld = [&](const json &id) { return id.is_string() && id.get_ref<const string &>() == oldID; };
+
+    const json &stored = trip.getPendingDetails()->value;
+    if (!stored.is_object()) {
+        return false;
+    }
+    bool named = false;
+    forEachID(stored, [&](const json &id) { named = named || isOld(id); });
+    if (!named) {
+        return false;
+    }
+
+    json details = stored;
+    forEachID(details, [&](json &id) {
+        if (isOld(id)) {
+            id = newID;
+        }
+    });
+    setPendingDetailsFromJson(move(details), trip);
+    return true;
+}
+
+void loadTripDetails(TRIP &trip, const PERSONMANAGER *personManager) {
+    TRACE_SPAN("loadTripDetails", "parse");
+    // Without people to resolve against, keep the pending details so nothing is lost on the next save
+    if (trip.isDetailsLoaded() || !personManager) {
+        return;
+    }
+
+    if (trip.getPendingDetails()) {
+        tripDetailsFromJson(trip.getPendingDetails()->value, trip, personManager);
+    }
+    trip.markDetailsLoaded();
+}
+
 void to_json(json &j, const TRIP &trip) {
     j = json{{"id", trip.getID()},
              {"destination", trip.getDestination()},
@@ -128,16 +273,28 @@ void to_json(json &j, const TRIP &trip) {
              {"start_date", trip.getStartDate().toString()},
              {"end_date", trip.getEndDate().toString()},
              {"status", statusToString(trip.getStatus())},
+             {"updated_at", trip.getUpdatedAt()},
              {"host_id", trip.getHost().getID()},
              {"member_ids", json::array()},
              {"expenses", json::array()}};
 
+    if (!trip.isDetailsLoaded()) {
+        if (trip.getPendingDetails()) {
+            const json &details = trip.getPendingDetails()->value;
+            j["host_id"] = details.value("host_id", "");
+            j["member_ids"] = details.value("member_ids", json::array());
+            j["expenses"] = details.value("expenses", json::array());
+        }
+        return;
+    }
+
     for (const MEMBER &member : trip.getMembers()) {
         j["member_ids"].push_back(member.getID());
     }
 
     for (const EXPENSE &expense : trip.getAllExpenses()) {
-        json expenseJson = {{"date", expense.getDate().toString()},
+        json expenseJson = {{"id", expense.getID()},
+                            {"date", expense.getDate().toString()},
                             {"category", categoryToString(expense.getCategory())},
                             {"amount", expense.getAmount()},
                             {"note", expense.getNote()},
@@ -147,6 +304,7 @@ void to_json(json &j, const TRIP &trip) {
 }
 
 void importTripInfoFromJson(vector<TRIP> &trips, const string &filePath, const PERSONMANAGER *personManager) {
+    TRACE_SPAN("importTripInfoFromJson", "load");
     ifstream file(filePath);
     if (!file.is_open()) {
         throw std::runtime_error("Cannot open JSON file for import: " + filePath);
@@ -196,7 +354,86 @@ void importTripInfoFromJson(vector<TRIP> &trips, const string &filePath, const P
     }
 }
 
-void exportTripsInfoToJson(const vector<TRIP> &trips, const string &outputFilePath) {
+namespace {
+// NOTE: TRIP's move may throw, so growing the vector would copy every trip into the snapshot arena; move them instead
+void growByMoving(vector<TRIP> &trips) {
+    vector<TRIP> grown;
+    grown.reserve(max<size_t>(64, trips.size() * 2));
+    for (TRIP &trip : trips) {
+        grown.push_back(move(trip));
+    }
+    trips.swap(grown);
+}
+}  // namespace
+
+void importTripHeadersFromJson(vector<TRIP> &trips, const string &filePath) {
+    TRACE_SPAN("importTripHeadersFromJson", "load");
+    ifstream file(filePath);
+    if (!file.is_open()) {
+        throw std::runtime_error("Cannot open JSON file for import: " + filePath);
+    }
+
+    try {
+        trips.clear();
+
+        int successCount = 0;
+        int errorCount = 0;
+
+        // NOTE: Each trip is taken from the parser as soon as it is complete and dropped from the array. The header
+        // nodes it leaves are reused by the next trip, so the pending details the trips keep lie close together
+        // instead of among the holes of a whole freed document.
+        bool isArray = false;
+        auto takeTrip = [&](int depth, json::parse_event_t event, json &parsed) {
+            if (depth == 0 && event == json::parse_event_t::array_start) {
+                isArray = true;
+            }
+            if (!isArray || depth != 1 || event != json::parse_event_t::object_end) {
+                return true;
+            }
+
+            if (trips.size() == trips.capacity()) {
+                growByMoving(trips);
+            }
+            // NOTE: Parse straight into the vector so a snapshot arena holds a single copy of each trip
+            trips.emplace_back();
+            try {
+                tripHeaderWithPendingDetailsFromJson(move(parsed), trips.back());
+                successCount++;
+
+            } catch (const std::exception &e) {
+                trips.pop_back();
+                errorCount++;
+            }
+            return false;
+        };
+        json j = json::parse(file, takeTrip);
+        file.close();
+
+        if (!j.is_array()) {
+            throw std::runtime_error("Invalid JSON structure: expected array of trips");
+        }
+        // NOTE: What is left in the array are the entries that are not objects
+        errorCount += static_cast<int>(j.size());
+
+        if (successCount == 0 && errorCount > 0) {
+            throw std::runtime_error("Failed to import any trips from JSON file");
+        }
+
+    } catch (const json::parse_error &e) {
+        file.close();
+        throw std::runtime_error("JSON parse error: " + string(e.what()));
+
+    } catch (const json::type_error &e) {
+        file.close();
+        throw std::runtime_error("JSON type error: " + string(e.what()));
+    }
+}
+
+namespace {
+// NOTE: Shared by the vector and snapshot overloads, any range of TRIP works
+template <class TRIPRANGE>
+void writeTripsJson(const TRIPRANGE &trips, const string &outputFilePath) {
+    TRACE_SPAN("exportTripsInfoToJson", "save");
     ofstream output(outputFilePath);
     if (!output.is_open()) {
         throw runtime_error("Cannot open file for writing: " + outputFilePath);
@@ -212,28 +449,61 @@ void exportTripsInfoToJson(const vector<TRIP> &trips, const string &outputFilePa
     output << j.dump(4);
     output.close();
 }
+}  // namespace
+
+void exportTripsInfoToJson(const vector<TRIP> &trips, const string &outputFilePath) {
+    writeTripsJson(trips, outputFilePath);
+}
 
-void loadTripCacheFile(vector<TRIP> &trips, const PERSONMANAGER *personManager) {
-    QString cacheFilePath = getCacheFilePath();
+void exportTripsInfoToJson(const TRIPSNAPSHOT &trips, const string &outputFilePath) {
+    writeTripsJson(trips, outputFilePath);
+}
+
+void loadTripCacheFile(vector<TRIP> &trips) {
+    TRACE_SPAN("loadTripCacheFile", "load");
+    static METRICHISTOGRAM &loadTime = metricHistogram("cache.trip.load_ns");
+    METRICTIMER timer(loadTime);
+    string cacheFilePath = getCacheFilePath();
 
-    QFileInfo cacheFile(cacheFilePath);
-    if (!cacheFile.exists()) {
+    if (!filesystem::exists(cacheFilePath)) {
         return;
     }
 
     try {
         trips.clear();
-        importTripInfoFromJson(trips, cacheFilePath.toStdString(), personManager);
+        importTripHeadersFromJson(trips, cacheFilePath);
     } catch (const exception &e) {
+        logError("Could not read the trip cache: " + string(e.what()));
     }
 }
 
 void updateCacheFile(const vector<TRIP> &trips) {
-    QString cacheFilePath = getCacheFilePath();
+    TRACE_SPAN("updateCacheFile", "save");
+    static METRICHISTOGRAM &writeTime = metricHistogram("cache.trip.write_ns");
+    METRICTIMER timer(writeTime);
+    string cacheFilePath = getCacheFilePath();
+
+    try {
+        exportTripsInfoToJson(trips, cacheFilePath);
+        recordCacheWrite("trip", cacheFilePath);
+    } catch (const exception &e) {
+        metricCounter("cache.write_failures").add();
+        logError("Could not write the trip cache: " + string(e.what()));
+    }
+}
+
+void updateCacheFile(const TRIPSNAPSHOT &trips) {
+    TRACE_SPAN("updateCacheFile", "save");
+    static METRICHISTOGRAM &writeTime = metricHistogram("cache.trip.write_ns");
+    METRICTIMER timer(writeTime);
+    string cacheFilePath = getCacheFilePath();
 
     try {
-        exportTripsInfoToJson(trips, cacheFilePath.toStdString());
+        exportTripsInfoToJson(trips, cacheFilePath);
+        recordCacheWrite("trip", cacheFilePath);
     } catch (const exception &e) {
+        metricCounter("cache.write_failures").add();
+        logError("Could not write the trip cache: " + string(e.what()));
     }
 }
 
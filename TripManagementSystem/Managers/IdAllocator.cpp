@@ -0,0 +1,28 @@
+#include "IdAllocator.h"
+
+using namespace std;
+
+string IDALLOCATOR::allocate(const string &baseID, const TAKENCHECK &isTaken) {
+    IDKEY baseKey(baseID);
+    if (!isTaken(baseKey)) {
+        return baseID;
+    }
+
+    // NOTE: Suffixes start at 2, the bare base ID counts as the first holder
+    uint32_t &lastTaken = lastTakenSuffix[baseKey];
+    if (lastTaken < 1) {
+        lastTaken = 1;
+    }
+
+    for (uint32_t suffix = lastTaken + 1;; ++suffix) {
+        string candidate = baseID + "_" + to_string(suffix);
+        if (!isTaken(IDKEY(candidate))) {
+            lastTaken = suffix - 1;
+            return candidate;
+        }
+    }
+}
+
+void IDALLOCATOR::clear() { lastTakenSuffix.clear(); }
+
+size_t IDALLOCATOR::getTrackedBaseCount() const { return lastTakenSuffix.size(); }
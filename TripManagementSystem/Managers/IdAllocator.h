@@ -0,0 +1,32 @@
+#ifndef IDALLOCATOR_H
+#define IDALLOCATOR_H
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+
+#include "../Models/header.h"
+
+using namespace std;
+
+// CLASS: IDALLOCATOR
+// Turns a generated base ID (e.g. initials_MMDD) into one nobody holds yet by appending _2, _3, ... on collision.
+// Whether an ID is taken is asked through a callback backed by the owner's hash index, so every probe is O(1)
+// expected. The highest suffix seen taken is remembered per base, which keeps a crowded base from re-probing all of
+// its earlier suffixes during bulk imports.
+class IDALLOCATOR {
+   public:
+    using TAKENCHECK = function<bool(const IDKEY &)>;
+
+   private:
+    unordered_map<IDKEY, uint32_t, IDKEY_HASH> lastTakenSuffix;
+
+   public:
+    // NOTE: Does not reserve anything, asking twice without adding the ID returns the same answer
+    string allocate(const string &baseID, const TAKENCHECK &isTaken);
+    void clear();
+    size_t getTrackedBaseCount() const;
+};
+
+#endif  // IDALLOCATOR_H
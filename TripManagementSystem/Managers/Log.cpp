@@ -0,0 +1,151 @@
+#include "Log.h"
+
+#include <array>
+#include <chrono>
+#include <cstring>
+
+using namespace std;
+
+namespace {
+constexpr size_t LOG_MESSAGE_WORDS = (LOG_MESSAGE_LENGTH + 7) / 8;
+
+// CLASS: LOGSLOT
+// One record of the ring. state is 2 * sequence + 2 once the record with that sequence is complete and odd while a
+// writer fills the slot; every field is atomic so a reader racing a writer sees a changed state, never a torn value.
+struct LOGSLOT {
+    atomic<uint64_t> state{0};
+    atomic<long long> unixMillis{0};
+    atomic<int> level{0};
+    atomic<uint32_t> length{0};
+    array<atomic<uint64_t>, LOG_MESSAGE_WORDS> words{};
+};
+
+// NOTE: Debug and Info records counted per second of wall time
+struct RATEWINDOW {
+    atomic<long long> second{0};
+    atomic<uint32_t> count{0};
+};
+
+array<LOGSLOT, LOG_CAPACITY> ring;
+atomic<uint64_t> nextSequence{0};
+atomic<uint64_t> suppressedCount{0};
+array<RATEWINDOW, 2> rateWindows;
+atomic<uint32_t> rateLimit{200};
+atomic<int> echoLevel{static_cast<int>(LOGLEVEL::Warning)};
+
+long long currentUnixMillis() {
+    return chrono::duration_cast<chrono::milliseconds>(chrono::system_clock::now().time_since_epoch()).count();
+}
+
+bool withinRateLimit(LOGLEVEL level, long long unixMillis) {
+    uint32_t limit = rateLimit.load(memory_order_relaxed);
+    if (level >= LOGLEVEL::Warning || limit == 0) {
+        return true;
+    }
+
+    RATEWINDOW &window = rateWindows[static_cast<int>(level)];
+    long long second = unixMillis / 1000;
+    long long windowSecond = window.second.load(memory_order_relaxed);
+    // NOTE: The first record of a new second restarts the count; a racing record may land in either second
+    if (windowSecond != second && window.second.compare_exchange_strong(windowSecond, second)) {
+        window.count.store(0, memory_order_relaxed);
+    }
+    return window.count.fetch_add(1, memory_order_relaxed) < limit;
+}
+}  // namespace
+
+string logLevelToString(LOGLEVEL level) {
+    switch (level) {
+        case LOGLEVEL::Debug:
+            return "Debug";
+        case LOGLEVEL::Info:
+            return "Info";
+        case LOGLEVEL::Warning:
+            return "Warning";
+        case LOGLEVEL::Error:
+            return "Error";
+    }
+    return "Unknown";
+}
+
+void logMessage(LOGLEVEL level, const string &message) {
+    long long unixMillis = currentUnixMillis();
+    if (!withinRateLimit(level, unixMillis)) {
+        suppressedCount.fetch_add(1, memory_order_relaxed);
+        return;
+    }
+
+    if (static_cast<int>(level) >= echoLevel.load(memory_order_relaxed)) {
+        cerr << message + '\n';
+    }
+
+    uint64_t sequence = nextSequence.fetch_add(1, memory_order_relaxed);
+    LOGSLOT &slot = ring[sequence % LOG_CAPACITY];
+
+    // NOTE: A writer a whole ring ahead may already hold the slot, the older record is then the one lost
+    uint64_t state = slot.state.load(memory_order_relaxed);
+    if ((state & 1) || state > 2 * sequence + 2 ||
+        !slot.state.compare_exchange_strong(state, 2 * sequence + 1, memory_order_relaxed)) {
+        return;
+    }
+    atomic_thread_fence(memory_order_release);
+
+    array<uint64_t, LOG_MESSAGE_WORDS> words{};
+    size_t length = min(message.size(), LOG_MESSAGE_LENGTH);
+    memcpy(words.data(), message.data(), length);
+
+    slot.unixMillis.store(unixMillis, memory_order_relaxed);
+    slot.level.store(static_cast<int>(level), memory_order_relaxed);
+    slot.length.store(static_cast<uint32_t>(length), memory_order_relaxed);
+    for (size_t i = 0; i < (length + 7) / 8; ++i) {
+        slot.words[i].store(words[i], memory_order_relaxed);
+    }
+    slot.state.store(2 * sequence + 2, memory_order_release);
+}
+
+vector<LOGRECORD> getRecentLogRecords(size_t maxCount) {
+    uint64_t end = nextSequence.load(memory_order_acquire);
+    uint64_t count = min<uint64_t>({maxCount, LOG_CAPACITY, end});
+
+    vector<LOGRECORD> records;
+    records.reserve(count);
+    for (uint64_t sequence = end - count; sequence < end; ++sequence) {
+        const LOGSLOT &slot = ring[sequence % LOG_CAPACITY];
+        uint64_t state = slot.state.load(memory_order_acquire);
+        if (state != 2 * sequence + 2) {
+            continue;  // Still being written, or already overwritten
+        }
+
+        LOGRECORD record;
+        record.sequence = sequence;
+        record.unixMillis = slot.unixMillis.load(memory_order_relaxed);
+        record.level = static_cast<LOGLEVEL>(slot.level.load(memory_order_relaxed));
+        size_t length = min<size_t>(slot.length.load(memory_order_relaxed), LOG_MESSAGE_LENGTH);
+        array<uint64_t, LOG_MESSAGE_WORDS> words{};
+        for (size_t i = 0; i < (length + 7) / 8; ++i) {
+            words[i] = slot.words[i].load(memory_order_relaxed);
+        }
+
+        atomic_thread_fence(memory_order_acquire);
+        if (slot.state.load(memory_order_relaxed) != state) {
+            continue;
+        }
+        record.message.assign(reinterpret_cast<const char *>(words.data()), length);
+        records.push_back(move(record));
+    }
+    return records;
+}
+
+LOGSTATS getLogStats() {
+    LOGSTATS stats;
+    stats.recorded = nextSequence.load(memory_order_relaxed);
+    stats.suppressed = suppressedCount.load(memory_order_relaxed);
+    return stats;
+}
+
+void setLogEchoLevel(LOGLEVEL level) { echoLevel.store(static_cast<int>(level), memory_order_relaxed); }
+
+void setLogRateLimit(uint32_t recordsPerSecond) { rateLimit.store(recordsPerSecond, memory_order_relaxed); }
+
+// NOTE: Declared in header.h, the models log through the same ring
+void logDebug(const string &message) { logMessage(LOGLEVEL::Debug, message); }
@@ -0,0 +1,59 @@
+#ifndef LOG_H
+#define LOG_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "../Models/header.h"
+
+using namespace std;
+
+// ==================== LOG ====================
+// Diagnostic messages of the whole program go to one ring of the last LOG_CAPACITY records, which the debug panel
+// and "tripcli --metrics" read. Writers never block each other: a record takes a slot with one atomic increment and
+// is copied in under a per-slot sequence number, a reader skips slots that change while it copies them. Messages
+// longer than LOG_MESSAGE_LENGTH bytes are cut.
+//
+// Debug and Info records beyond the rate limit are dropped and counted, so a loop over thousands of records cannot
+// flood the ring. Records at or above the echo level are also written to stderr.
+
+enum class LOGLEVEL { Debug, Info, Warning, Error };
+
+string logLevelToString(LOGLEVEL level);
+
+constexpr size_t LOG_CAPACITY = 1024;
+constexpr size_t LOG_MESSAGE_LENGTH = 240;
+
+// CLASS: LOGRECORD
+struct LOGRECORD {
+    // NOTE: Counts every record taken into the ring, gaps are records overwritten or skipped while read
+    uint64_t sequence = 0;
+    long long unixMillis = 0;
+    LOGLEVEL level = LOGLEVEL::Debug;
+    string message;
+};
+
+// CLASS: LOGSTATS
+struct LOGSTATS {
+    uint64_t recorded = 0;
+    // NOTE: Dropped by the rate limit
+    uint64_t suppressed = 0;
+};
+
+void logMessage(LOGLEVEL level, const string &message);
+inline void logInfo(const string &message) { logMessage(LOGLEVEL::Info, message); }
+inline void logWarning(const string &message) { logMessage(LOGLEVEL::Warning, message); }
+inline void logError(const string &message) { logMessage(LOGLEVEL::Error, message); }
+
+// FUNC: The newest records still in the ring, oldest first
+vector<LOGRECORD> getRecentLogRecords(size_t maxCount = LOG_CAPACITY);
+LOGSTATS getLogStats();
+
+// NOTE: Warning by default, so the command-line tool and the application stay quiet about routine changes
+void setLogEchoLevel(LOGLEVEL level);
+// NOTE: Debug and Info records per second and level, 0 lifts the limit. 200 by default.
+void setLogRateLimit(uint32_t recordsPerSecond);
+
+#endif  // LOG_H
@@ -0,0 +1,190 @@
+#include "MembershipIndex.h"
+
+using namespace std;
+
+namespace {
+const vector<IDKEY> EMPTY_KEYS;
+}
+
+// FUNC: Sorted vector helpers
+bool MEMBERSHIPINDEX::insertSorted(vector<IDKEY> &keys, const IDKEY &key) {
+    auto it = lower_bound(keys.begin(), keys.end(), key);
+    if (it != keys.end() && *it == key) {
+        return false;
+    }
+    keys.insert(it, key);
+    return true;
+}
+
+bool MEMBERSHIPINDEX::eraseSorted(vector<IDKEY> &keys, const IDKEY &key) {
+    auto it = lower_bound(keys.begin(), keys.end(), key);
+    if (it == keys.end() || *it != key) {
+        return false;
+    }
+    keys.erase(it);
+    return true;
+}
+
+// FUNC: Updates
+// NOTE: Replaces the member list of a trip and patches the reverse side only for the members involved
+void MEMBERSHIPINDEX::setTripMembers(const IDKEY &tripID, vector<IDKEY> memberIDs) {
+    removeTrip(tripID);
+
+    sort(memberIDs.begin(), memberIDs.end());
+    memberIDs.erase(unique(memberIDs.begin(), memberIDs.end()), memberIDs.end());
+    if (memberIDs.empty()) {
+        return;
+    }
+
+    for (const IDKEY &memberID : memberIDs) {
+        insertSorted(this->tripsByMember[memberID], tripID);
+    }
+    this->linkCount += memberIDs.size();
+    this->membersByTrip[tripID] = move(memberIDs);
+}
+
+void MEMBERSHIPINDEX::removeTrip(const IDKEY &tripID) {
+    auto it = this->membersByTrip.find(tripID);
+    if (it == this->membersByTrip.end()) {
+        return;
+    }
+
+    for (const IDKEY &memberID : it->second) {
+        auto tripsIt = this->tripsByMember.find(memberID);
+        if (tripsIt != this->tripsByMember.end()) {
+            eraseSorted(tripsIt->second, tripID);
+            if (tripsIt->second.empty()) {
+                this->tripsByMember.erase(tripsIt);
+            }
+        }
+    }
+    this->linkCount -= it->second.size();
+    this->membersByTrip.erase(it);
+}
+
+// NOTE: Bulk load appends both sides unsorted and sorts every list once at the end
+void MEMBERSHIPINDEX::rebuild(const TRIPSNAPSHOT &trips) {
+    clear();
+
+    // NOTE: Only the first trip with a given ID is indexed, matching TRIPMANAGER::findTripById
+    unordered_set<IDKEY, IDKEY_HASH> seenTrips;
+    seenTrips.reserve(trips.size());
+
+    for (const TRIP &trip : trips) {
+        if (!seenTrips.insert(trip.getKey()).second) {
+            continue;
+        }
+
+        vector<IDKEY> memberIDs = trip.getMemberKeys();
+        if (memberIDs.empty()) {
+            continue;
+        }
+
+        vector<IDKEY> &tripMembers = this->membersByTrip[trip.getKey()];
+        tripMembers.insert(tripMembers.end(), memberIDs.begin(), memberIDs.end());
+    }
+
+    for (auto &entry : this->membersByTrip) {
+        vector<IDKEY> &memberIDs = entry.second;
+        sort(memberIDs.begin(), memberIDs.end());
+        memberIDs.erase(unique(memberIDs.begin(), memberIDs.end()), memberIDs.end());
+
+        for (const IDKEY &memberID : memberIDs) {
+            this->tripsByMember[memberID].push_back(entry.first);
+        }
+        this->linkCount += memberIDs.size();
+    }
+
+    for (auto &entry : this->tripsByMember) {
+        sort(entry.second.begin(), entry.second.end());
+    }
+}
+
+void MEMBERSHIPINDEX::clear() {
+    this->membersByTrip.clear();
+    this->tripsByMember.clear();
+    this->linkCount = 0;
+}
+
+// FUNC: Queries
+bool MEMBERSHIPINDEX::contains(const IDKEY &tripID, const IDKEY &memberID) const {
+    const vector<IDKEY> &memberIDs = getMembersOfTrip(tripID);
+    return binary_search(memberIDs.begin(), memberIDs.end(), memberID);
+}
+
+const vector<IDKEY> &MEMBERSHIPINDEX::getMembersOfTrip(const IDKEY &tripID) const {
+    auto it = this->membersByTrip.find(tripID);
+    return (it != this->membersByTrip.end()) ? it->second : EMPTY_KEYS;
+}
+
+const vector<IDKEY> &MEMBERSHIPINDEX::getTripsOfMember(const IDKEY &memberID) const {
+    auto it = this->tripsByMember.find(memberID);
+    return (it != this->tripsByMember.end()) ? it->second : EMPTY_KEYS;
+}
+
+size_t MEMBERSHIPINDEX::getLinkCount() const { return this->linkCount; }
+
+// FUNC: Host index updates
+void HOSTINDEX::setTripHost(const IDKEY &tripID, const IDKEY &hostID) {
+    removeTrip(tripID);
+    if (hostID.empty()) {
+        return;
+    }
+
+    this->hostByTrip[tripID] = hostID;
+    vector<IDKEY> &hostedTrips = this->tripsByHost[hostID];
+    hostedTrips.insert(lower_bound(hostedTrips.begin(), hostedTrips.end(), tripID), tripID);
+}
+
+void HOSTINDEX::removeTrip(const IDKEY &tripID) {
+    auto it = this->hostByTrip.find(tripID);
+    if (it == this->hostByTrip.end()) {
+        return;
+    }
+
+    auto tripsIt = this->tripsByHost.find(it->second);
+    if (tripsIt != this->tripsByHost.end()) {
+        vector<IDKEY> &hostedTrips = tripsIt->second;
+        auto tripIt = lower_bound(hostedTrips.begin(), hostedTrips.end(), tripID);
+        if (tripIt != hostedTrips.end() && *tripIt == tripID) {
+            hostedTrips.erase(tripIt);
+        }
+        if (hostedTrips.empty()) {
+            this->tripsByHost.erase(tripsIt);
+        }
+    }
+    this->hostByTrip.erase(it);
+}
+
+void HOSTINDEX::rebuild(const TRIPSNAPSHOT &trips) {
+    clear();
+    this->hostByTrip.reserve(trips.size());
+
+    for (const TRIP &trip : trips) {
+        IDKEY hostID = trip.getHostKey();
+        // NOTE: emplace keeps the first trip for a duplicated ID, matching TRIPMANAGER::findTripById
+        if (!hostID.empty() && this->hostByTrip.emplace(trip.getKey(), hostID).second) {
+            this->tripsByHost[hostID].push_back(trip.getKey());
+        }
+    }
+
+    for (auto &entry : this->tripsByHost) {
+        sort(entry.second.begin(), entry.second.end());
+    }
+}
+
+void HOSTINDEX::clear() {
+    this->hostByTrip.clear();
+    this->tripsByHost.clear();
+}
+
+// FUNC: Host index queries
+IDKEY HOSTINDEX::getHostOfTrip(const IDKEY &tripID) const {
+    auto it = this->hostByTrip.find(tripID);
+    return (it != this->hostByTrip.end()) ? it->second : IDKEY();
+}
+
+const vector<IDKEY> &HOSTINDEX::getTripsOfHost(const IDKEY &hostID) const {
+    auto it = this->tripsByHost.find(hostID);
+    return (it != this->tripsByHost.end()) ? it->second : EMPTY_KEYS;
+}
@@ -0,0 +1,60 @@
+#ifndef MEMBERSHIPINDEX_H
+#define MEMBERSHIPINDEX_H
+
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "../Models/header.h"
+#include "TripSnapshot.h"
+
+using namespace std;
+
+// CLASS: MEMBERSHIPINDEX
+// Many-to-many trip <-> person relation (trip members, expense payers) kept in both directions. Each side maps a key
+// to a sorted vector of keys, so membership tests are a hash lookup plus a binary search and listing either side is
+// O(k).
+class MEMBERSHIPINDEX {
+   private:
+    unordered_map<IDKEY, vector<IDKEY>, IDKEY_HASH> membersByTrip;
+    unordered_map<IDKEY, vector<IDKEY>, IDKEY_HASH> tripsByMember;
+    size_t linkCount = 0;
+
+    static bool insertSorted(vector<IDKEY> &keys, const IDKEY &key);
+    static bool eraseSorted(vector<IDKEY> &keys, const IDKEY &key);
+
+   public:
+    // FUNC: Updates
+    void setTripMembers(const IDKEY &tripID, vector<IDKEY> memberIDs);
+    void removeTrip(const IDKEY &tripID);
+    void rebuild(const TRIPSNAPSHOT &trips);
+    void clear();
+
+    // FUNC: Queries
+    bool contains(const IDKEY &tripID, const IDKEY &memberID) const;
+    const vector<IDKEY> &getMembersOfTrip(const IDKEY &tripID) const;
+    const vector<IDKEY> &getTripsOfMember(const IDKEY &memberID) const;
+    size_t getLinkCount() const;
+};
+
+// CLASS: HOSTINDEX
+// One host per trip, many trips per host. The reverse side is a sorted vector per host so "trips hosted by X" is
+// O(k) and never rescans the trip list.
+class HOSTINDEX {
+   private:
+    unordered_map<IDKEY, IDKEY, IDKEY_HASH> hostByTrip;
+    unordered_map<IDKEY, vector<IDKEY>, IDKEY_HASH> tripsByHost;
+
+   public:
+    // FUNC: Updates
+    void setTripHost(const IDKEY &tripID, const IDKEY &hostID);
+    void removeTrip(const IDKEY &tripID);
+    void rebuild(const TRIPSNAPSHOT &trips);
+    void clear();
+
+    // FUNC: Queries
+    IDKEY getHostOfTrip(const IDKEY &tripID) const;
+    const vector<IDKEY> &getTripsOfHost(const IDKEY &hostID) const;
+};
+
+#endif  // MEMBERSHIPINDEX_H
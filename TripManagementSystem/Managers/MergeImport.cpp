@@ -0,0 +1,141 @@
+#include "MergeImport.h"
+
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+
+using namespace std;
+
+namespace {
+bool fillIfEmpty(const string &current, const string &incoming, const function<void(const string &)> &setter) {
+    if (!current.empty() || incoming.empty()) {
+        return false;
+    }
+    setter(incoming);
+    return true;
+}
+
+bool mergePersonFields(PERSON &stored, const PERSON &incoming) {
+    bool changed = false;
+    changed = fillIfEmpty(stored.getEmail(), incoming.getEmail(), [&](const string &v) { stored.setEmail(v); }) ||
+              changed;
+    changed = fillIfEmpty(stored.getPhoneNumber(), incoming.getPhoneNumber(),
+                          [&](const string &v) { stored.setPhoneNumber(v); }) ||
+              changed;
+    changed = fillIfEmpty(stored.getAddress(), incoming.getAddress(), [&](const string &v) { stored.setAddress(v); }) ||
+              changed;
+    return changed;
+}
+
+// NOTE: Shared policy handling; the stored record keeps its ID whatever the policy
+template <class T>
+bool mergeWithPolicy(T &stored, const T &incoming, MERGEPOLICY policy, bool (*mergeFields)(T &, const T &)) {
+    if (keepsStoredRecord(stored, incoming, policy)) {
+        return false;
+    }
+
+    if (policy == MERGEPOLICY::FieldMerge) {
+        if (!mergeFields(stored, incoming)) {
+            return false;
+        }
+        stored.setUpdatedAt(max(currentUnixTime(), incoming.getUpdatedAt()));
+        return true;
+    }
+
+    stored = incoming;
+    if (stored.getUpdatedAt() == 0) {
+        stored.setUpdatedAt(currentUnixTime());
+    }
+    return true;
+}
+}  // namespace
+
+const string mergePolicyToString(MERGEPOLICY policy) {
+    switch (policy) {
+        case MERGEPOLICY::Skip:
+            return "Skip existing";
+        case MERGEPOLICY::Overwrite:
+            return "Overwrite existing";
+        case MERGEPOLICY::NewestWins:
+            return "Newest wins";
+        case MERGEPOLICY::FieldMerge:
+            return "Merge fields";
+        default:
+            return "Skip existing";
+    }
+}
+
+MERGEPOLICY stringToMergePolicy(const string &policyStr) {
+    for (MERGEPOLICY policy : getAllMergePolicies()) {
+        if (mergePolicyToString(policy) == policyStr) {
+            return policy;
+        }
+    }
+    throw runtime_error("Unknown merge policy: " + policyStr);
+}
+
+vector<MERGEPOLICY> getAllMergePolicies() {
+    return {MERGEPOLICY::Skip, MERGEPOLICY::Overwrite, MERGEPOLICY::NewestWins, MERGEPOLICY::FieldMerge};
+}
+
+size_t MERGEREPORT::getTotal() const { return added + updated + unchanged + duplicates + rejected; }
+
+string MERGEREPORT::toString() const {
+    return "Added: " + to_string(added) + "\nUpdated: " + to_string(updated) + "\nUnchanged: " + to_string(unchanged) +
+           "\nDuplicates in file: " + to_string(duplicates) + "\nRejected: " + to_string(rejected);
+}
+
+bool mergeRecord(MEMBER &stored, const MEMBER &incoming, MERGEPOLICY policy) {
+    return mergeWithPolicy(stored, incoming, policy, &mergeMemberFields);
+}
+
+bool mergeRecord(HOST &stored, const HOST &incoming, MERGEPOLICY policy) {
+    return mergeWithPolicy(stored, incoming, policy, &mergeHostFields);
+}
+
+bool mergeRecord(TRIP &stored, const TRIP &incoming, MERGEPOLICY policy) {
+    return mergeWithPolicy(stored, incoming, policy, &mergeTripFields);
+}
+
+bool mergeMemberFields(MEMBER &stored, const MEMBER &incoming) {
+    bool changed = mergePersonFields(stored, incoming);
+    changed = fillIfEmpty(stored.getEmergencyContact(), incoming.getEmergencyContact(),
+                          [&](const string &v) { stored.setEmergencyContact(v); }) ||
+              changed;
+
+    size_t interestCount = stored.getInterests().size();
+    for (const string &interest : incoming.getInterests()) {
+        stored.addInterest(interest);
+    }
+    return changed || stored.getInterests().size() != interestCount;
+}
+
+bool mergeHostFields(HOST &stored, const HOST &incoming) {
+    bool changed = mergePersonFields(stored, incoming);
+    changed = fillIfEmpty(stored.getEmergencyContact(), incoming.getEmergencyContact(),
+                          [&](const string &v) { stored.setEmergencyContact(v); }) ||
+              changed;
+    return changed;
+}
+
+// NOTE: Members and expenses are unioned by ID. The stored trip must have its details loaded.
+bool mergeTripFields(TRIP &stored, const TRIP &incoming) {
+    bool changed = fillIfEmpty(stored.getDescription(), incoming.getDescription(),
+                               [&](const string &v) { stored.setDescription(v); });
+
+    if (!stored.hasHost() && incoming.hasHost()) {
+        stored.setHost(incoming.getHost());
+        changed = true;
+    }
+
+    size_t memberCount = stored.getMembers().size();
+    for (const MEMBER &member : incoming.getMembers()) {
+        stored.addMember(member);
+    }
+    changed = changed || stored.getMembers().size() != memberCount;
+
+    for (const EXPENSE &expense : incoming.getAllExpenses()) {
+        changed = stored.addExpense(expense) || changed;
+    }
+    return changed;
+}
@@ -0,0 +1,50 @@
+#ifndef MERGEIMPORT_H
+#define MERGEIMPORT_H
+
+#include <string>
+#include <vector>
+
+#include "../Models/header.h"
+
+using namespace std;
+
+// CLASS: MERGEPOLICY
+// What an import does with a record whose ID is already in the store. NewestWins compares updated_at; records from
+// files written before it existed count as oldest.
+enum class MERGEPOLICY { Skip, Overwrite, NewestWins, FieldMerge };
+const string mergePolicyToString(MERGEPOLICY policy);
+MERGEPOLICY stringToMergePolicy(const string &policyStr);
+vector<MERGEPOLICY> getAllMergePolicies();
+
+// CLASS: MERGEREPORT
+// Outcome of one merge import. Every input record is counted exactly once.
+struct MERGEREPORT {
+    size_t added = 0;
+    size_t updated = 0;
+    size_t unchanged = 0;
+    size_t duplicates = 0;
+    size_t rejected = 0;
+    vector<string> changedIDs;
+
+    size_t getTotal() const;
+    string toString() const;
+};
+
+// FUNC: True when the policy leaves the stored record as it is whatever the fields hold
+template <class T>
+bool keepsStoredRecord(const T &stored, const T &incoming, MERGEPOLICY policy) {
+    return policy == MERGEPOLICY::Skip ||
+           (policy == MERGEPOLICY::NewestWins && incoming.getUpdatedAt() <= stored.getUpdatedAt());
+}
+
+// FUNC: Apply a policy to a stored record that matched an imported one by ID, returns whether it changed
+bool mergeRecord(MEMBER &stored, const MEMBER &incoming, MERGEPOLICY policy);
+bool mergeRecord(HOST &stored, const HOST &incoming, MERGEPOLICY policy);
+bool mergeRecord(TRIP &stored, const TRIP &incoming, MERGEPOLICY policy);
+
+// FUNC: Field merge: the stored record keeps its values and only takes what it is missing from the imported one
+bool mergeMemberFields(MEMBER &stored, const MEMBER &incoming);
+bool mergeHostFields(HOST &stored, const HOST &incoming);
+bool mergeTripFields(TRIP &stored, const TRIP &incoming);
+
+#endif  // MERGEIMPORT_H
@@ -0,0 +1,178 @@
+#include "Metrics.h"
+
+#include <cmath>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <nlohmann/json.hpp>
+
+#include "Log.h"
+
+using namespace std;
+
+namespace {
+struct METRICREGISTRY {
+    mutex registryMutex;
+    map<string, unique_ptr<METRICCOUNTER>> counters;
+    map<string, unique_ptr<METRICHISTOGRAM>> histograms;
+};
+
+METRICREGISTRY &metricRegistry() {
+    static METRICREGISTRY registry;
+    return registry;
+}
+
+size_t bucketOf(uint64_t value) {
+    size_t bucket = 0;
+    while (value > 0) {
+        value >>= 1;
+        ++bucket;
+    }
+    return bucket;
+}
+
+// NOTE: Value at the given fraction of the recorded count, linear inside the bucket that holds it. The bucket is
+// narrowed to the recorded minimum and maximum, which makes a histogram of equal values exact.
+double estimatePercentile(const array<uint64_t, METRICHISTOGRAM::BUCKET_COUNT> &buckets, uint64_t count,
+                          uint64_t minimum, uint64_t maximum, double fraction) {
+    if (count == 0) {
+        return 0;
+    }
+    double rank = fraction * static_cast<double>(count);
+    uint64_t below = 0;
+    for (size_t bucket = 0; bucket < buckets.size(); ++bucket) {
+        if (buckets[bucket] == 0 || static_cast<double>(below + buckets[bucket]) < rank) {
+            below += buckets[bucket];
+            continue;
+        }
+        if (bucket == 0) {
+            return 0;
+        }
+        double low = max(ldexp(1.0, static_cast<int>(bucket) - 1), static_cast<double>(minimum));
+        double high = min(ldexp(1.0, static_cast<int>(bucket)), static_cast<double>(maximum));
+        double within = (rank - static_cast<double>(below)) / static_cast<double>(buckets[bucket]);
+        return low + max(0.0, high - low) * within;
+    }
+    return static_cast<double>(maximum);
+}
+}  // namespace
+
+// FUNC: Histogram
+METRICHISTOGRAM::METRICHISTOGRAM(const string &unit, uint32_t sampleEvery)
+    : unit(unit), sampleEvery(max<uint32_t>(1, sampleEvery)) {}
+
+void METRICHISTOGRAM::record(uint64_t value) {
+    this->buckets[bucketOf(value)].fetch_add(1, memory_order_relaxed);
+    this->sum.fetch_add(value, memory_order_relaxed);
+
+    uint64_t previous = this->minimum.load(memory_order_relaxed);
+    while (value < previous && !this->minimum.compare_exchange_weak(previous, value, memory_order_relaxed)) {
+    }
+    previous = this->maximum.load(memory_order_relaxed);
+    while (value > previous && !this->maximum.compare_exchange_weak(previous, value, memory_order_relaxed)) {
+    }
+}
+
+const string &METRICHISTOGRAM::getUnit() const { return this->unit; }
+
+uint32_t METRICHISTOGRAM::getSampleEvery() const { return this->sampleEvery; }
+
+HISTOGRAMSUMMARY METRICHISTOGRAM::summarize() const {
+    HISTOGRAMSUMMARY summary;
+    summary.unit = this->unit;
+    summary.sampleEvery = this->sampleEvery;
+
+    // NOTE: The count is the sum of the buckets, so the percentiles agree with it while other threads record
+    array<uint64_t, BUCKET_COUNT> counts{};
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        counts[i] = this->buckets[i].load(memory_order_relaxed);
+        summary.count += counts[i];
+    }
+    summary.sum = this->sum.load(memory_order_relaxed);
+    summary.max = this->maximum.load(memory_order_relaxed);
+    if (summary.count > 0) {
+        summary.min = this->minimum.load(memory_order_relaxed);
+        summary.mean = static_cast<double>(summary.sum) / static_cast<double>(summary.count);
+    }
+    summary.p50 = estimatePercentile(counts, summary.count, summary.min, summary.max, 0.50);
+    summary.p90 = estimatePercentile(counts, summary.count, summary.min, summary.max, 0.90);
+    summary.p99 = estimatePercentile(counts, summary.count, summary.min, summary.max, 0.99);
+    return summary;
+}
+
+// FUNC: Registry
+METRICCOUNTER &metricCounter(const string &name) {
+    METRICREGISTRY &registry = metricRegistry();
+    lock_guard<mutex> lock(registry.registryMutex);
+    unique_ptr<METRICCOUNTER> &counter = registry.counters[name];
+    if (!counter) {
+        counter = make_unique<METRICCOUNTER>();
+    }
+    return *counter;
+}
+
+METRICHISTOGRAM &metricHistogram(const string &name, const string &unit, uint32_t sampleEvery) {
+    METRICREGISTRY &registry = metricRegistry();
+    lock_guard<mutex> lock(registry.registryMutex);
+    unique_ptr<METRICHISTOGRAM> &histogram = registry.histograms[name];
+    if (!histogram) {
+        histogram = make_unique<METRICHISTOGRAM>(unit, sampleEvery);
+    }
+    return *histogram;
+}
+
+vector<pair<string, uint64_t>> getCounterValues() {
+    METRICREGISTRY &registry = metricRegistry();
+    lock_guard<mutex> lock(registry.registryMutex);
+    vector<pair<string, uint64_t>> values;
+    for (const auto &entry : registry.counters) {
+        values.emplace_back(entry.first, entry.second->get());
+    }
+    return values;
+}
+
+vector<pair<string, HISTOGRAMSUMMARY>> getHistogramSummaries() {
+    METRICREGISTRY &registry = metricRegistry();
+    lock_guard<mutex> lock(registry.registryMutex);
+    vector<pair<string, HISTOGRAMSUMMARY>> summaries;
+    for (const auto &entry : registry.histograms) {
+        summaries.emplace_back(entry.first, entry.second->summarize());
+    }
+    return summaries;
+}
+
+// FUNC: Dump
+void writeMetricsJson(ostream &out, size_t logRecordCount) {
+    nlohmann::ordered_json j;
+
+    j["counters"] = nlohmann::ordered_json::object();
+    for (const auto &counter : getCounterValues()) {
+        j["counters"][counter.first] = counter.second;
+    }
+
+    j["histograms"] = nlohmann::ordered_json::object();
+    for (const auto &entry : getHistogramSummaries()) {
+        const HISTOGRAMSUMMARY &summary = entry.second;
+        j["histograms"][entry.first] = {{"unit", summary.unit},
+                                        {"sample_every", summary.sampleEvery},
+                                        {"count", summary.count},
+                                        {"min", summary.min},
+                                        {"mean", summary.mean},
+                                        {"p50", summary.p50},
+                                        {"p90", summary.p90},
+                                        {"p99", summary.p99},
+                                        {"max", summary.max}};
+    }
+
+    LOGSTATS stats = getLogStats();
+    j["log"] = {{"recorded", stats.recorded}, {"suppressed", stats.suppressed}};
+    j["log"]["records"] = nlohmann::ordered_json::array();
+    for (const LOGRECORD &record : getRecentLogRecords(logRecordCount)) {
+        j["log"]["records"].push_back({{"sequence", record.sequence},
+                                       {"unix_ms", record.unixMillis},
+                                       {"level", logLevelToString(record.level)},
+                                       {"message", record.message}});
+    }
+
+    out << j.dump(2) << '\n';
+}
@@ -0,0 +1,111 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+// ==================== METRICS ====================
+// Named counters and histograms shared by the whole program, shown in the debug panel and written by
+// "tripcli --metrics". A metric is registered on first use and lives until exit, so call sites keep the reference:
+//
+//     static METRICCOUNTER &writes = metricCounter("cache.trip.writes");
+//     writes.add();
+//
+// Updates are relaxed atomic additions, safe from any thread.
+
+// CLASS: METRICCOUNTER
+class METRICCOUNTER {
+   private:
+    atomic<uint64_t> value{0};
+
+   public:
+    void add(uint64_t amount = 1) { this->value.fetch_add(amount, memory_order_relaxed); }
+    uint64_t get() const { return this->value.load(memory_order_relaxed); }
+};
+
+// CLASS: HISTOGRAMSUMMARY
+// Percentiles are interpolated inside power-of-two buckets, so they are estimates within a factor of two
+struct HISTOGRAMSUMMARY {
+    string unit;
+    uint32_t sampleEvery = 1;
+    uint64_t count = 0;
+    uint64_t sum = 0;
+    uint64_t min = 0;
+    uint64_t max = 0;
+    double mean = 0;
+    double p50 = 0;
+    double p90 = 0;
+    double p99 = 0;
+};
+
+// CLASS: METRICHISTOGRAM
+// Distribution of non-negative values. Bucket 0 holds 0 and bucket b holds [2^(b-1), 2^b).
+class METRICHISTOGRAM {
+   public:
+    static constexpr size_t BUCKET_COUNT = 65;
+
+   private:
+    string unit;
+    uint32_t sampleEvery;
+    array<atomic<uint64_t>, BUCKET_COUNT> buckets{};
+    atomic<uint64_t> sum{0};
+    atomic<uint64_t> minimum{UINT64_MAX};
+    atomic<uint64_t> maximum{0};
+
+   public:
+    METRICHISTOGRAM(const string &unit, uint32_t sampleEvery);
+
+    void record(uint64_t value);
+    const string &getUnit() const;
+    // NOTE: Timers record one scope in this many, for calls too short and frequent to time every one of
+    uint32_t getSampleEvery() const;
+    HISTOGRAMSUMMARY summarize() const;
+};
+
+METRICCOUNTER &metricCounter(const string &name);
+// NOTE: unit and sampleEvery are taken from the first registration of the name
+METRICHISTOGRAM &metricHistogram(const string &name, const string &unit = "ns", uint32_t sampleEvery = 1);
+
+// FUNC: All metrics by name
+vector<pair<string, uint64_t>> getCounterValues();
+vector<pair<string, HISTOGRAMSUMMARY>> getHistogramSummaries();
+
+// FUNC: Counters, histograms, log statistics and the newest log records as one JSON object
+void writeMetricsJson(ostream &out, size_t logRecordCount = 100);
+
+// CLASS: METRICTIMER
+// Records the nanoseconds from its construction to its destruction into a histogram. On a sampled histogram only one
+// in getSampleEvery() timers of a thread reads the clock, the others cost a thread-local increment.
+class METRICTIMER {
+   private:
+    METRICHISTOGRAM *histogram;
+    chrono::steady_clock::time_point start;
+
+    static bool takeSample(uint32_t sampleEvery) {
+        thread_local uint32_t tick = 0;
+        return sampleEvery <= 1 || ++tick % sampleEvery == 0;
+    }
+
+   public:
+    explicit METRICTIMER(METRICHISTOGRAM &histogram)
+        : histogram(takeSample(histogram.getSampleEvery()) ? &histogram : nullptr),
+          start(this->histogram ? chrono::steady_clock::now() : chrono::steady_clock::time_point()) {}
+    ~METRICTIMER() {
+        if (this->histogram) {
+            auto elapsed = chrono::steady_clock::now() - this->start;
+            this->histogram->record(chrono::duration_cast<chrono::nanoseconds>(elapsed).count());
+        }
+    }
+    METRICTIMER(const METRICTIMER &) = delete;
+    METRICTIMER &operator=(const METRICTIMER &) = delete;
+};
+
+#endif  // METRICS_H
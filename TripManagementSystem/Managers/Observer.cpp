@@ -1,7 +1,18 @@
 #include "Observer.h"
 
+#include "Metrics.h"
+#include "Trace.h"
+
 using namespace std;
 
+namespace {
+// NOTE: Its count is the number of notifications sent
+METRICHISTOGRAM &dispatchTime() {
+    static METRICHISTOGRAM &histogram = metricHistogram("observer.dispatch_ns");
+    return histogram;
+}
+}  // namespace
+
 void SUBJECT::addObserver(OBSERVER *observer) { observers.push_back(observer); }
 
 void SUBJECT::removeObserver(OBSERVER *observer) {
@@ -14,37 +25,73 @@ void SUBJECT::removeObserver(OBSERVER *observer) {
 }
 
 void SUBJECT::notifyTripAdded(const string &tripID) {
+    TRACE_SPAN("notifyTripAdded", "observer");
+    METRICTIMER timer(dispatchTime());
     for (size_t i = 0; i < observers.size(); ++i) {
         observers[i]->onTripAdded(tripID);
     }
 }
 
 void SUBJECT::notifyTripRemoved(const string &tripID) {
+    TRACE_SPAN("notifyTripRemoved", "observer");
+    METRICTIMER timer(dispatchTime());
     for (size_t i = 0; i < observers.size(); ++i) {
         observers[i]->onTripRemoved(tripID);
     }
 }
 
 void SUBJECT::notifyTripUpdated(const string &tripID) {
+    TRACE_SPAN("notifyTripUpdated", "observer");
+    METRICTIMER timer(dispatchTime());
     for (size_t i = 0; i < observers.size(); ++i) {
         observers[i]->onTripUpdated(tripID);
     }
 }
 
 void SUBJECT::notifyPersonAdded(const string &personID) {
+    TRACE_SPAN("notifyPersonAdded", "observer");
+    METRICTIMER timer(dispatchTime());
     for (size_t i = 0; i < observers.size(); ++i) {
         observers[i]->onPersonAdded(personID);
     }
 }
 
 void SUBJECT::notifyPersonRemoved(const string &personID) {
+    TRACE_SPAN("notifyPersonRemoved", "observer");
+    METRICTIMER timer(dispatchTime());
     for (size_t i = 0; i < observers.size(); ++i) {
         observers[i]->onPersonRemoved(personID);
     }
 }
 
-void SUBJECT::notifyPersonUpdated(const string &personID) {
+void SUBJECT::notifyPersonUpdated(const string &oldID, const string &newID) {
+    TRACE_SPAN("notifyPersonUpdated", "observer");
+    METRICTIMER timer(dispatchTime());
+    for (size_t i = 0; i < observers.size(); ++i) {
+        observers[i]->onPersonUpdated(oldID, newID);
+    }
+}
+
+void SUBJECT::notifyTripsMerged(const vector<string> &tripIDs) {
+    TRACE_SPAN("notifyTripsMerged", "observer");
+    METRICTIMER timer(dispatchTime());
+    for (size_t i = 0; i < observers.size(); ++i) {
+        observers[i]->onTripsMerged(tripIDs);
+    }
+}
+
+void SUBJECT::notifyPeopleMerged(const vector<string> &personIDs) {
+    TRACE_SPAN("notifyPeopleMerged", "observer");
+    METRICTIMER timer(dispatchTime());
+    for (size_t i = 0; i < observers.size(); ++i) {
+        observers[i]->onPeopleMerged(personIDs);
+    }
+}
+
+void SUBJECT::notifyTripsRestored() {
+    TRACE_SPAN("notifyTripsRestored", "observer");
+    METRICTIMER timer(dispatchTime());
     for (size_t i = 0; i < observers.size(); ++i) {
-        observers[i]->onPersonUpdated(personID);
+        observers[i]->onTripsRestored();
     }
 }
\ No newline at end of file
@@ -16,7 +16,14 @@ class OBSERVER {
 
     virtual void onPersonAdded(const string &personID) = 0;
     virtual void onPersonRemoved(const string &personID) = 0;
-    virtual void onPersonUpdated(const string &personID) = 0;
+    // NOTE: An edit may change the person's ID, oldID is the one trips still refer to
+    virtual void onPersonUpdated(const string &oldID, const string &newID) = 0;
+
+    // NOTE: Batch changes from a merge import, reported once per batch instead of once per record
+    virtual void onTripsMerged(const vector<string> & /* tripIDs */) {}
+    virtual void onPeopleMerged(const vector<string> & /* personIDs */) {}
+    // NOTE: The whole trip list was swapped for another version (undo / redo)
+    virtual void onTripsRestored() {}
 };
 
 class SUBJECT {
@@ -33,7 +40,11 @@ class SUBJECT {
 
     void notifyPersonAdded(const string &personID);
     void notifyPersonRemoved(const string &personID);
-    void notifyPersonUpdated(const string &personID);
+    void notifyPersonUpdated(const string &oldID, const string &newID);
+
+    void notifyTripsMerged(const vector<string> &tripIDs);
+    void notifyPeopleMerged(const vector<string> &personIDs);
+    void notifyTripsRestored();
 };
 
 #endif  // OBSERVER_H
\ No newline at end of file
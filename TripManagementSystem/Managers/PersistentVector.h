@@ -0,0 +1,238 @@
+#ifndef PERSISTENTVECTOR_H
+#define PERSISTENTVECTOR_H
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+// CLASS: PERSISTENTVECTOR
+// Vector whose copies share structure: a 32-way tree with the elements in its leaves. Copying one is O(1), it only
+// shares the root. Reading, replacing, appending and removing the last element are O(log32 n) and copy only the nodes
+// on their path that another copy still shares, nodes held by this copy alone are changed in place. Copies may be read
+// on any thread; a copy is changed by one thread at a time.
+template <class T>
+class PERSISTENTVECTOR {
+   private:
+    static constexpr unsigned BITS = 5;
+    static constexpr size_t WIDTH = size_t(1) << BITS;
+    static constexpr size_t MASK = WIDTH - 1;
+
+    // NOTE: A branch uses children, a leaf uses values
+    struct NODE {
+        vector<shared_ptr<NODE>> children;
+        vector<T> values;
+    };
+
+    shared_ptr<NODE> root;
+    size_t count = 0;
+    // NOTE: Index bits above the leaf level, 0 while the root is a leaf
+    unsigned shift = 0;
+
+    static NODE *makeUnique(shared_ptr<NODE> &node) {
+        if (!node) {
+            node = make_shared<NODE>();
+        } else if (node.use_count() > 1) {
+            node = make_shared<NODE>(*node);
+        }
+        return node.get();
+    }
+
+    static NODE *makeLeaf(shared_ptr<NODE> &node) {
+        bool created = !node;
+        NODE *leaf = makeUnique(node);
+        if (created) {
+            leaf->values.reserve(WIDTH);
+        }
+        return leaf;
+    }
+
+    const NODE *leafOf(size_t index) const {
+        const NODE *node = this->root.get();
+        for (unsigned level = this->shift; level > 0; level -= BITS) {
+            node = node->children[(index >> level) & MASK].get();
+        }
+        return node;
+    }
+
+    // NOTE: Returns true when the node is left empty, so the caller drops it
+    static bool popFrom(shared_ptr<NODE> &node, unsigned level, size_t index) {
+        NODE *unique = makeUnique(node);
+        if (level == 0) {
+            unique->values.pop_back();
+            return unique->values.empty();
+        }
+        if (popFrom(unique->children[(index >> level) & MASK], level - BITS, index)) {
+            unique->children.pop_back();
+        }
+        return unique->children.empty();
+    }
+
+    // NOTE: A node above its own height stands for a chain of branches with it as the first child, so trees of
+    // different heights are compared level by level
+    struct SIDE {
+        const NODE *node;
+        unsigned height;
+    };
+
+    static size_t childCount(SIDE side, unsigned level) {
+        if (!side.node) {
+            return 0;
+        }
+        return (side.height < level) ? 1 : side.node->children.size();
+    }
+
+    static SIDE childOf(SIDE side, unsigned level, size_t index) {
+        if (side.node && side.height < level) {
+            return (index == 0) ? side : SIDE{nullptr, level - BITS};
+        }
+        bool present = side.node && index < side.node->children.size();
+        return SIDE{present ? side.node->children[index].get() : nullptr, level - BITS};
+    }
+
+    template <class VISIT>
+    static void diffNodes(SIDE a, SIDE b, unsigned level, size_t base, VISIT &visit) {
+        if (a.node == b.node && a.height == b.height) {
+            return;
+        }
+        if (level == 0) {
+            size_t aCount = a.node ? a.node->values.size() : 0;
+            size_t bCount = b.node ? b.node->values.size() : 0;
+            for (size_t i = 0; i < max(aCount, bCount); ++i) {
+                if (i >= aCount || i >= bCount || !(a.node->values[i] == b.node->values[i])) {
+                    visit(base + i);
+                }
+            }
+            return;
+        }
+        size_t width = max(childCount(a, level), childCount(b, level));
+        for (size_t i = 0; i < width; ++i) {
+            diffNodes(childOf(a, level, i), childOf(b, level, i), level - BITS, base + (i << level), visit);
+        }
+    }
+
+   public:
+    class ITERATOR {
+       private:
+        const PERSISTENTVECTOR *owner;
+        size_t index;
+        // NOTE: The leaf holding the last element read, stepping through a leaf does not walk the tree again
+        mutable const T *leaf = nullptr;
+        mutable size_t leafStart = 0;
+
+       public:
+        using iterator_category = random_access_iterator_tag;
+        using value_type = T;
+        using difference_type = ptrdiff_t;
+        using pointer = const T *;
+        using reference = const T &;
+
+        ITERATOR(const PERSISTENTVECTOR *_owner, size_t _index) : owner(_owner), index(_index) {}
+
+        reference operator*() const {
+            size_t start = this->index & ~MASK;
+            if (!this->leaf || start != this->leafStart) {
+                this->leaf = this->owner->leafOf(this->index)->values.data();
+                this->leafStart = start;
+            }
+            return this->leaf[this->index & MASK];
+        }
+        pointer operator->() const { return &**this; }
+
+        ITERATOR &operator++() {
+            ++this->index;
+            return *this;
+        }
+        ITERATOR operator++(int) {
+            ITERATOR previous = *this;
+            ++this->index;
+            return previous;
+        }
+        ITERATOR operator+(difference_type n) const { return ITERATOR(this->owner, this->index + n); }
+        difference_type operator-(const ITERATOR &other) const {
+            return difference_type(this->index) - difference_type(other.index);
+        }
+        reference operator[](difference_type n) const { return (*this->owner)[this->index + n]; }
+
+        bool operator==(const ITERATOR &other) const { return this->index == other.index; }
+        bool operator!=(const ITERATOR &other) const { return this->index != other.index; }
+        bool operator<(const ITERATOR &other) const { return this->index < other.index; }
+    };
+
+    PERSISTENTVECTOR() = default;
+
+    // FUNC: Reading
+    size_t size() const { return this->count; }
+    bool empty() const { return this->count == 0; }
+    const T &operator[](size_t index) const { return leafOf(index)->values[index & MASK]; }
+    const T &back() const { return (*this)[this->count - 1]; }
+    ITERATOR begin() const { return ITERATOR(this, 0); }
+    ITERATOR end() const { return ITERATOR(this, this->count); }
+
+    // FUNC: Writing
+    // NOTE: The reference stays valid until the next change to this copy
+    T &mutableAt(size_t index) {
+        NODE *node = makeUnique(this->root);
+        for (unsigned level = this->shift; level > 0; level -= BITS) {
+            node = makeUnique(node->children[(index >> level) & MASK]);
+        }
+        return node->values[index & MASK];
+    }
+
+    void set(size_t index, T value) { mutableAt(index) = move(value); }
+
+    void push_back(T value) {
+        if (this->root && this->count == (WIDTH << this->shift)) {
+            shared_ptr<NODE> grown = make_shared<NODE>();
+            grown->children.push_back(move(this->root));
+            this->root = move(grown);
+            this->shift += BITS;
+        }
+
+        shared_ptr<NODE> *slot = &this->root;
+        for (unsigned level = this->shift; level > 0; level -= BITS) {
+            NODE *branch = makeUnique(*slot);
+            size_t child = (this->count >> level) & MASK;
+            if (child == branch->children.size()) {
+                branch->children.emplace_back();
+            }
+            slot = &branch->children[child];
+        }
+        makeLeaf(*slot)->values.push_back(move(value));
+        ++this->count;
+    }
+
+    void pop_back() {
+        popFrom(this->root, this->shift, this->count - 1);
+        if (--this->count == 0) {
+            clear();
+            return;
+        }
+        while (this->shift > 0 && this->root->children.size() == 1) {
+            shared_ptr<NODE> child = this->root->children[0];
+            this->root = move(child);
+            this->shift -= BITS;
+        }
+    }
+
+    void clear() {
+        this->root.reset();
+        this->count = 0;
+        this->shift = 0;
+    }
+
+    // FUNC: diff
+    // NOTE: Calls visit(index) for every index whose element differs between the two copies or exists in only one.
+    // Subtrees both copies share are skipped, so the cost follows the number of changed leaves, not the size.
+    template <class VISIT>
+    static void diff(const PERSISTENTVECTOR &a, const PERSISTENTVECTOR &b, VISIT visit) {
+        unsigned level = max(a.shift, b.shift);
+        diffNodes(SIDE{a.root.get(), a.shift}, SIDE{b.root.get(), b.shift}, level, 0, visit);
+    }
+};
+
+#endif  // PERSISTENTVECTOR_H
@@ -16,6 +16,7 @@ class PERSONFACTORY {
     static MEMBER createMember(const string &fullName, const GENDER &gender, const DATE &dob);
     static HOST createHost(const string &fullName, const GENDER &gender, const DATE &dob);
 
+    // NOTE: Base ID only, it can collide; PERSONMANAGER::allocatePersonID makes it unique
     static string generatePersonID(const string &fullName, const DATE &dob);
 };
 #endif  // PERSONFACTORY_H
\ No newline at end of file
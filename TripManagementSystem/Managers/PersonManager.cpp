@@ -1,56 +1,127 @@
 #include "PersonManager.h"
 
-#include <QDebug>
 #include <algorithm>
+#include <unordered_set>
+
+#include "Log.h"
+#include "Metrics.h"
 
 using namespace std;
 
-PERSONMANAGER::PERSONMANAGER() : peopleNeedsUpdate(true) {
+namespace {
+// NOTE: Swap-and-pop, like TRIP::removeExpense: the last person takes the removed one's slot, so only their index
+// entry moves instead of the whole index being rebuilt. The list order changes.
+template <class PERSONTYPE>
+void removeSlot(vector<PERSONTYPE> &stored, unordered_map<IDKEY, size_t, IDKEY_HASH> &index, size_t slot) {
+    size_t last = stored.size() - 1;
+    if (slot != last) {
+        stored[slot] = move(stored[last]);
+        auto moved = index.find(stored[slot].getKey());
+        if (moved != index.end() && moved->second == last) {
+            moved->second = slot;
+        }
+    }
+    stored.pop_back();
+}
+}  // namespace
+
+PERSONMANAGER::PERSONMANAGER()
+    : snapshotArena(make_shared<SNAPSHOTARENA>()),
+      members(make_shared<vector<MEMBER>>()),
+      hosts(make_shared<vector<HOST>>()) {
     if (peopleCacheFileExists()) {
         vector<HOST> cachedHosts;
         vector<MEMBER> cachedMembers;
+        {
+            ARENASCOPE scope(*this->snapshotArena);
+            loadPeopleCacheFile(cachedMembers, cachedHosts);
+        }
 
-        loadPeopleCacheFile(cachedMembers, cachedHosts);
-
+        // NOTE: Move the loaded people in as-is; nobody observes yet and the cache already holds this data
         if (!cachedHosts.empty() || !cachedMembers.empty()) {
-            addMultipleHosts(cachedHosts);
-            addMultipleMembers(cachedMembers);
+            *this->hosts = move(cachedHosts);
+            *this->members = move(cachedMembers);
+            this->listsInArena = true;
+            rebuildIndexes();
         } else {
-            QMessageBox::warning(
-                nullptr, "Cache Load Error",
-                "Failed to load people cache. Starting with empty person list. Please check the cache file.");
+            this->loadWarning =
+                "Failed to load people cache. Starting with empty person list. Please check the cache file.";
+            logWarning(this->loadWarning);
         }
     }
-    refreshPeopleVector();
 }
 
-PERSONMANAGER::~PERSONMANAGER() { updatePeopleCacheFile(this->members, this->hosts); }
+// NOTE: Every change already writes the cache, so it is only written again if something changed since
+PERSONMANAGER::~PERSONMANAGER() {
+    if (this->epoch != this->savedEpoch) {
+        updatePeopleCacheFile(*this->members, *this->hosts);
+    }
+}
 
-void PERSONMANAGER::addPerson(const PERSON &person) {
+string PERSONMANAGER::addPerson(const PERSON &person) {
     if (person.getRole() == "Member") {
         const MEMBER &member = static_cast<const MEMBER &>(person);
-        addMember(member);
+        return addMember(member);
     } else if (person.getRole() == "Host") {
         const HOST &host = static_cast<const HOST &>(person);
-        addHost(host);
+        return addHost(host);
     }
+    return "";
 }
 
-void PERSONMANAGER::addMember(const MEMBER &member) {
-    members.push_back(member);
-    peopleNeedsUpdate = true;
+// NOTE: Writers change the store under the exclusive lock and release it before notifying, observers read back
+string PERSONMANAGER::addMember(const MEMBER &member) {
+    string id;
+    {
+        unique_lock<shared_mutex> lock(this->storeMutex);
+        id = appendMember(member);
+        ++this->epoch;
+    }
 
-    notifyPersonAdded(member.getID());
-    updatePeopleCacheFile(members, hosts);
+    notifyPersonAdded(id);
+    saveCache();
+    return id;
 }
 
-void PERSONMANAGER::addHost(const HOST &host) {
-    hosts.push_back(host);
-    peopleNeedsUpdate = true;
+string PERSONMANAGER::addHost(const HOST &host) {
+    string id;
+    {
+        unique_lock<shared_mutex> lock(this->storeMutex);
+        id = appendHost(host);
+        ++this->epoch;
+    }
+
+    notifyPersonAdded(id);
+    saveCache();
+    logDebug("Added host: " + host.getFullName());
+    return id;
+}
+
+// NOTE: Store a copy under a free ID and index it. Callers notify and write the cache, so batches can do it once.
+string PERSONMANAGER::appendMember(const MEMBER &member) {
+    string id = allocateFreeID(member.getID());
+    vector<MEMBER> &stored = writableMembers();
+    stored.push_back(member);
+    MEMBER &added = stored.back();
+    added.setID(id);
+    if (added.getUpdatedAt() == 0) {
+        added.setUpdatedAt(currentUnixTime());
+    }
+    memberIndex.emplace(added.getKey(), stored.size() - 1);
+    return id;
+}
 
-    notifyPersonAdded(host.getID());
-    updatePeopleCacheFile(members, hosts);
-    qDebug() << "Added host:" << QString::fromStdString(host.getFullName());
+string PERSONMANAGER::appendHost(const HOST &host) {
+    string id = allocateFreeID(host.getID());
+    vector<HOST> &stored = writableHosts();
+    stored.push_back(host);
+    HOST &added = stored.back();
+    added.setID(id);
+    if (added.getUpdatedAt() == 0) {
+        added.setUpdatedAt(currentUnixTime());
+    }
+    hostIndex.emplace(added.getKey(), stored.size() - 1);
+    return id;
 }
 
 bool PERSONMANAGER::removePerson(const string &personID) {
@@ -61,33 +132,48 @@ bool PERSONMANAGER::removePerson(const string &personID) {
 }
 
 bool PERSONMANAGER::removeMember(const string &memberID) {
-    auto it = find_if(members.begin(), members.end(),
-                      [&memberID](const MEMBER &member) { return member.getID() == memberID; });
-
-    if (it != members.end()) {
-        members.erase(it);
-        peopleNeedsUpdate = true;
+    {
+        unique_lock<shared_mutex> lock(this->storeMutex);
+        auto it = memberIndex.find(IDKEY(memberID));
+        if (it == memberIndex.end()) {
+            return false;
+        }
 
-        notifyPersonRemoved(memberID);
-        updatePeopleCacheFile(members, hosts);
-        qDebug() << "Removed member:" << QString::fromStdString(memberID);
-        return true;
+        size_t slot = it->second;
+        memberIndex.erase(it);
+        removeSlot(writableMembers(), memberIndex, slot);
+        if (this->duplicatePersonCount > 0) {
+            rebuildIndexes();
+        }
+        ++this->epoch;
     }
-    return false;
+
+    notifyPersonRemoved(memberID);
+    saveCache();
+    logDebug("Removed member: " + memberID);
+    return true;
 }
 
 bool PERSONMANAGER::removeHost(const string &hostID) {
-    auto it = find_if(hosts.begin(), hosts.end(), [&hostID](const HOST &host) { return host.getID() == hostID; });
-
-    if (it != hosts.end()) {
-        hosts.erase(it);
-        peopleNeedsUpdate = true;
+    {
+        unique_lock<shared_mutex> lock(this->storeMutex);
+        auto it = hostIndex.find(IDKEY(hostID));
+        if (it == hostIndex.end()) {
+            return false;
+        }
 
-        notifyPersonRemoved(hostID);
-        updatePeopleCacheFile(members, hosts);
-        return true;
+        size_t slot = it->second;
+        hostIndex.erase(it);
+        removeSlot(writableHosts(), hostIndex, slot);
+        if (this->duplicatePersonCount > 0) {
+            rebuildIndexes();
+        }
+        ++this->epoch;
     }
-    return false;
+
+    notifyPersonRemoved(hostID);
+    saveCache();
+    return true;
 }
 
 bool PERSONMANAGER::updatePerson(const PERSON &originalPerson, const PERSON &updatedPerson) {
@@ -105,61 +191,110 @@ bool PERSONMANAGER::updatePerson(const PERSON &originalPerson, const PERSON &upd
 }
 
 bool PERSONMANAGER::updateMember(const MEMBER &originalMember, const MEMBER &updatedMember) {
-    auto it = find_if(members.begin(), members.end(),
-                      [&originalMember](const MEMBER &member) { return member.getID() == originalMember.getID(); });
-
-    if (it != members.end()) {
-        *it = updatedMember;
-        peopleNeedsUpdate = true;
+    string id, oldID;
+    {
+        unique_lock<shared_mutex> lock(this->storeMutex);
+        auto it = memberIndex.find(originalMember.getKey());
+        if (it == memberIndex.end()) {
+            return false;
+        }
 
-        notifyPersonUpdated(updatedMember.getID());
-        updatePeopleCacheFile(members, hosts);
-        qDebug() << "Updated member:" << QString::fromStdString(updatedMember.getID());
-        return true;
+        // NOTE: Callers may pass the stored member itself as the original, so its key is kept before overwriting it
+        IDKEY originalKey = originalMember.getKey();
+        MEMBER &stored = writableMembers()[it->second];
+        stored = updatedMember;
+        stored.setUpdatedAt(currentUnixTime());
+        if (originalKey != updatedMember.getKey()) {
+            // NOTE: A changed ID must not land on someone else's, the old one is released first
+            size_t slot = it->second;
+            memberIndex.erase(it);
+            stored.setID(allocateFreeID(updatedMember.getID()));
+            memberIndex.emplace(stored.getKey(), slot);
+            if (this->duplicatePersonCount > 0) {
+                rebuildIndexes();
+            }
+        }
+        id = stored.getID();
+        oldID = originalKey.str();
+        ++this->epoch;
     }
-    return false;
+
+    notifyPersonUpdated(oldID, id);
+    saveCache();
+    logDebug("Updated member: " + id);
+    return true;
 }
 
 bool PERSONMANAGER::updateHost(const HOST &originalHost, const HOST &updatedHost) {
-    auto it = find_if(hosts.begin(), hosts.end(),
-                      [&originalHost](const HOST &host) { return host.getID() == originalHost.getID(); });
-
-    if (it != hosts.end()) {
-        *it = updatedHost;
-        peopleNeedsUpdate = true;
+    string id, oldID;
+    {
+        unique_lock<shared_mutex> lock(this->storeMutex);
+        auto it = hostIndex.find(originalHost.getKey());
+        if (it == hostIndex.end()) {
+            return false;
+        }
 
-        notifyPersonUpdated(updatedHost.getID());
-        updatePeopleCacheFile(members, hosts);
-        qDebug() << "Updated host:" << QString::fromStdString(updatedHost.getID());
-        return true;
+        // NOTE: Callers may pass the stored host itself as the original, so its key is kept before overwriting it
+        IDKEY originalKey = originalHost.getKey();
+        HOST &stored = writableHosts()[it->second];
+        stored = updatedHost;
+        stored.setUpdatedAt(currentUnixTime());
+        if (originalKey != updatedHost.getKey()) {
+            // NOTE: A changed ID must not land on someone else's, the old one is released first
+            size_t slot = it->second;
+            hostIndex.erase(it);
+            stored.setID(allocateFreeID(updatedHost.getID()));
+            hostIndex.emplace(stored.getKey(), slot);
+            if (this->duplicatePersonCount > 0) {
+                rebuildIndexes();
+            }
+        }
+        id = stored.getID();
+        oldID = originalKey.str();
+        ++this->epoch;
     }
-    return false;
+
+    notifyPersonUpdated(oldID, id);
+    saveCache();
+    logDebug("Updated host: " + id);
+    return true;
 }
 
 bool PERSONMANAGER::updatePeople(const vector<PERSON> &updatedPeople) {
-    members.clear();
-    hosts.clear();
+    // NOTE: A whole new list replaces the current one, snapshots keep the lists they already share
+    shared_ptr<vector<MEMBER>> newMembers = make_shared<vector<MEMBER>>();
+    shared_ptr<vector<HOST>> newHosts = make_shared<vector<HOST>>();
 
     for (const PERSON &person : updatedPeople) {
         if (person.getRole() == "Member") {
-            members.push_back(static_cast<const MEMBER &>(person));
+            newMembers->push_back(static_cast<const MEMBER &>(person));
         } else if (person.getRole() == "Host") {
-            hosts.push_back(static_cast<const HOST &>(person));
+            newHosts->push_back(static_cast<const HOST &>(person));
         }
     }
 
-    peopleNeedsUpdate = true;
-    updatePeopleCacheFile(members, hosts);
+    {
+        unique_lock<shared_mutex> lock(this->storeMutex);
+        this->members = move(newMembers);
+        this->hosts = move(newHosts);
+        if (this->listsInArena) {
+            this->snapshotArena = make_shared<SNAPSHOTARENA>();
+            this->listsInArena = false;
+        }
+        rebuildIndexes();
+        ++this->epoch;
+    }
+    saveCache();
     return true;
 }
 
-PERSON *PERSONMANAGER::findPersonById(const string &id) {
-    MEMBER *member = findMemberById(id);
+const PERSON *PERSONMANAGER::findPersonById(const string &id) const {
+    const MEMBER *member = findMemberById(id);
     if (member) {
         return member;
     }
 
-    HOST *host = findHostById(id);
+    const HOST *host = findHostById(id);
     if (host) {
         return host;
     }
@@ -167,117 +302,327 @@ PERSON *PERSONMANAGER::findPersonById(const string &id) {
     return nullptr;
 }
 
-MEMBER *PERSONMANAGER::findMemberById(const string &id) {
-    auto it = find_if(members.begin(), members.end(), [&id](const MEMBER &member) { return member.getID() == id; });
-    return (it != members.end()) ? &(*it) : nullptr;
+const MEMBER *PERSONMANAGER::findMemberById(const string &id) const { return findMemberByKey(IDKEY(id)); }
+
+const HOST *PERSONMANAGER::findHostById(const string &id) const { return findHostByKey(IDKEY(id)); }
+
+const MEMBER *PERSONMANAGER::findMemberByKey(const IDKEY &key) const {
+    static METRICHISTOGRAM &lookupTime = metricHistogram("lookup.person_ns", "ns", 64);
+    METRICTIMER timer(lookupTime);
+    shared_lock<shared_mutex> lock(this->storeMutex);
+    return lookupMember(key);
 }
 
-HOST *PERSONMANAGER::findHostById(const string &id) {
-    auto it = find_if(hosts.begin(), hosts.end(), [&id](const HOST &host) { return host.getID() == id; });
-    return (it != hosts.end()) ? &(*it) : nullptr;
+const HOST *PERSONMANAGER::findHostByKey(const IDKEY &key) const {
+    static METRICHISTOGRAM &lookupTime = metricHistogram("lookup.person_ns", "ns", 64);
+    METRICTIMER timer(lookupTime);
+    shared_lock<shared_mutex> lock(this->storeMutex);
+    return lookupHost(key);
 }
 
-const vector<PERSON> &PERSONMANAGER::getAllPeople() const {
-    if (peopleNeedsUpdate) {
-        refreshPeopleVector();
-    }
-    return people;
+const MEMBER *PERSONMANAGER::lookupMember(const IDKEY &key) const {
+    auto it = memberIndex.find(key);
+    return (it != memberIndex.end()) ? &(*members)[it->second] : nullptr;
 }
 
-const vector<MEMBER> &PERSONMANAGER::getAllMembers() const { return members; }
+const HOST *PERSONMANAGER::lookupHost(const IDKEY &key) const {
+    auto it = hostIndex.find(key);
+    return (it != hostIndex.end()) ? &(*hosts)[it->second] : nullptr;
+}
 
-const vector<HOST> &PERSONMANAGER::getAllHosts() const { return hosts; }
+shared_ptr<const MEMBER> PERSONMANAGER::shareMemberById(const string &id) const { return shareMemberByKey(IDKEY(id)); }
 
-vector<MEMBER> PERSONMANAGER::getAllMembersLegacy() const { return members; }
+shared_ptr<const HOST> PERSONMANAGER::shareHostById(const string &id) const { return shareHostByKey(IDKEY(id)); }
 
-vector<HOST> PERSONMANAGER::getAllHostsLegacy() const { return hosts; }
+// NOTE: The handle aliases the list it points into, so a writer copies that list before changing it
+shared_ptr<const MEMBER> PERSONMANAGER::shareMemberByKey(const IDKEY &key) const {
+    shared_lock<shared_mutex> lock(this->storeMutex);
+    const MEMBER *member = lookupMember(key);
+    return member ? shared_ptr<const MEMBER>(this->members, member) : nullptr;
+}
 
-void PERSONMANAGER::refreshPeopleVector() const {
-    people.clear();
-    people.reserve(members.size() + hosts.size());
+shared_ptr<const HOST> PERSONMANAGER::shareHostByKey(const IDKEY &key) const {
+    shared_lock<shared_mutex> lock(this->storeMutex);
+    const HOST *host = lookupHost(key);
+    return host ? shared_ptr<const HOST>(this->hosts, host) : nullptr;
+}
 
-    for (const MEMBER &member : members) {
-        people.push_back(member);
+// NOTE: emplace keeps the first person for a duplicated ID, same as the old linear search
+void PERSONMANAGER::rebuildIndexes() {
+    this->duplicatePersonCount = 0;
+    memberIndex.clear();
+    memberIndex.reserve(members->size());
+    for (size_t i = 0; i < members->size(); ++i) {
+        this->duplicatePersonCount += memberIndex.emplace((*members)[i].getKey(), i).second ? 0 : 1;
     }
 
-    for (const HOST &host : hosts) {
-        people.push_back(host);
+    hostIndex.clear();
+    hostIndex.reserve(hosts->size());
+    for (size_t i = 0; i < hosts->size(); ++i) {
+        this->duplicatePersonCount += hostIndex.emplace((*hosts)[i].getKey(), i).second ? 0 : 1;
     }
+}
+
+PEOPLEVIEW PERSONMANAGER::getAllPeople() const { return PEOPLEVIEW(*members, *hosts); }
+
+PEOPLESNAPSHOT PERSONMANAGER::getSnapshot() const {
+    shared_lock<shared_mutex> lock(this->storeMutex);
+    return PEOPLESNAPSHOT(this->snapshotArena, this->members, this->hosts, this->epoch);
+}
 
-    peopleNeedsUpdate = false;
-    qDebug() << "Refreshed people vector:" << people.size() << "total people";
+const vector<MEMBER> &PERSONMANAGER::getAllMembers() const { return *members; }
+
+const vector<HOST> &PERSONMANAGER::getAllHosts() const { return *hosts; }
+
+vector<MEMBER> PERSONMANAGER::getAllMembersLegacy() const {
+    shared_lock<shared_mutex> lock(this->storeMutex);
+    return *members;
+}
+
+vector<HOST> PERSONMANAGER::getAllHostsLegacy() const {
+    shared_lock<shared_mutex> lock(this->storeMutex);
+    return *hosts;
 }
 
 size_t PERSONMANAGER::getPersonCount() const {
-    if (peopleNeedsUpdate) {
-        refreshPeopleVector();
-    }
-    return people.size();
+    shared_lock<shared_mutex> lock(this->storeMutex);
+    return members->size() + hosts->size();
 }
 
-size_t PERSONMANAGER::getMemberCount() const { return members.size(); }
+size_t PERSONMANAGER::getMemberCount() const {
+    shared_lock<shared_mutex> lock(this->storeMutex);
+    return members->size();
+}
 
-size_t PERSONMANAGER::getHostCount() const { return hosts.size(); }
+size_t PERSONMANAGER::getHostCount() const {
+    shared_lock<shared_mutex> lock(this->storeMutex);
+    return hosts->size();
+}
 
+// NOTE: Lookups by value only read, the copy is taken under the lock and no shared list is copied
 HOST PERSONMANAGER::getHostByID(const string &hostID) {
-    HOST *host = findHostById(hostID);
+    shared_lock<shared_mutex> lock(this->storeMutex);
+    const HOST *host = lookupHost(IDKEY(hostID));
     return host ? *host : HOST();
 }
 
 MEMBER PERSONMANAGER::getMemberByID(const string &memberID) {
-    MEMBER *member = findMemberById(memberID);
+    shared_lock<shared_mutex> lock(this->storeMutex);
+    const MEMBER *member = lookupMember(IDKEY(memberID));
     return member ? *member : MEMBER();
 }
 
 void PERSONMANAGER::debugPrintCounts() const {
-    qDebug() << "PersonManager Debug Counts:";
-    qDebug() << "  Members:" << members.size();
-    qDebug() << "  Hosts:" << hosts.size();
-    qDebug() << "  Total People:" << getPersonCount();
-    qDebug() << "  People needs update:" << peopleNeedsUpdate;
+    shared_lock<shared_mutex> lock(this->storeMutex);
+    logDebug("PersonManager Debug Counts:");
+    logDebug("  Members: " + to_string(members->size()));
+    logDebug("  Hosts: " + to_string(hosts->size()));
+    logDebug("  Total People: " + to_string(members->size() + hosts->size()));
+    logDebug("  Snapshot arena bytes: " + to_string(snapshotArena->getBytesReserved()));
 }
 
 bool PERSONMANAGER::validateDataIntegrity() const {
+    shared_lock<shared_mutex> lock(this->storeMutex);
     bool valid = true;
 
-    for (size_t i = 0; i < members.size(); ++i) {
-        for (size_t j = i + 1; j < members.size(); ++j) {
-            if (members[i].getID() == members[j].getID()) {
-                qDebug() << "Duplicate member ID found:" << QString::fromStdString(members[i].getID());
-                valid = false;
-            }
+    unordered_set<IDKEY, IDKEY_HASH> memberIDs;
+    memberIDs.reserve(members->size());
+    for (const MEMBER &member : *members) {
+        if (!memberIDs.insert(member.getKey()).second) {
+            logWarning("Duplicate member ID found: " + member.getID());
+            valid = false;
         }
     }
 
-    for (size_t i = 0; i < hosts.size(); ++i) {
-        for (size_t j = i + 1; j < hosts.size(); ++j) {
-            if (hosts[i].getID() == hosts[j].getID()) {
-                qDebug() << "Duplicate host ID found:" << QString::fromStdString(hosts[i].getID());
-                valid = false;
-            }
+    unordered_set<IDKEY, IDKEY_HASH> hostIDs;
+    hostIDs.reserve(hosts->size());
+    for (const HOST &host : *hosts) {
+        if (!hostIDs.insert(host.getKey()).second) {
+            logWarning("Duplicate host ID found: " + host.getID());
+            valid = false;
         }
     }
 
-    for (const MEMBER &member : members) {
-        for (const HOST &host : hosts) {
-            if (member.getID() == host.getID()) {
-                qDebug() << "ID exists in both vectors:" << QString::fromStdString(member.getID());
-                valid = false;
-            }
+    for (const MEMBER &member : *members) {
+        if (hostIDs.count(member.getKey())) {
+            logWarning("ID exists in both vectors: " + member.getID());
+            valid = false;
         }
     }
 
     return valid;
 }
 
+// NOTE: Bulk adds allocate IDs against the live indexes one by one, then write the cache once for the whole batch
 void PERSONMANAGER::addMultipleMembers(const vector<MEMBER> &newMembers) {
-    for (const MEMBER &mem : newMembers) {
-        addMember(mem);
+    vector<string> addedIDs;
+    addedIDs.reserve(newMembers.size());
+    {
+        unique_lock<shared_mutex> lock(this->storeMutex);
+        writableMembers().reserve(members->size() + newMembers.size());
+        memberIndex.reserve(members->size() + newMembers.size());
+        for (const MEMBER &member : newMembers) {
+            addedIDs.push_back(appendMember(member));
+        }
+        if (!newMembers.empty()) {
+            ++this->epoch;
+        }
+    }
+
+    for (const string &id : addedIDs) {
+        notifyPersonAdded(id);
+    }
+    if (!newMembers.empty()) {
+        saveCache();
     }
 }
 
 void PERSONMANAGER::addMultipleHosts(const vector<HOST> &newHosts) {
-    for (const HOST &host : newHosts) {
-        addHost(host);
+    vector<string> addedIDs;
+    addedIDs.reserve(newHosts.size());
+    {
+        unique_lock<shared_mutex> lock(this->storeMutex);
+        writableHosts().reserve(hosts->size() + newHosts.size());
+        hostIndex.reserve(hosts->size() + newHosts.size());
+        for (const HOST &host : newHosts) {
+            addedIDs.push_back(appendHost(host));
+        }
+        if (!newHosts.empty()) {
+            ++this->epoch;
+        }
+    }
+
+    for (const string &id : addedIDs) {
+        notifyPersonAdded(id);
     }
-}
\ No newline at end of file
+    if (!newHosts.empty()) {
+        saveCache();
+    }
+}
+
+MERGEREPORT PERSONMANAGER::mergePeople(const vector<MEMBER> &incomingMembers, const vector<HOST> &incomingHosts,
+                                        MERGEPOLICY policy) {
+    MERGEREPORT report;
+    unordered_set<IDKEY, IDKEY_HASH> seen;
+    seen.reserve(incomingMembers.size() + incomingHosts.size());
+
+    unique_lock<shared_mutex> lock(this->storeMutex);
+    // NOTE: Both lists are taken writable up front, a merge usually touches them anyway and copies each once at most
+    writableMembers().reserve(members->size() + incomingMembers.size());
+    writableHosts().reserve(hosts->size() + incomingHosts.size());
+
+    for (const MEMBER &incoming : incomingMembers) {
+        // NOTE: The first occurrence of an ID in the file wins
+        if (!seen.insert(incoming.getKey()).second) {
+            report.duplicates++;
+            continue;
+        }
+
+        auto it = memberIndex.find(incoming.getKey());
+        if (it == memberIndex.end()) {
+            if (hostIndex.count(incoming.getKey())) {
+                report.rejected++;
+                continue;
+            }
+            report.changedIDs.push_back(appendMember(incoming));
+            report.added++;
+        } else if (mergeRecord((*members)[it->second], incoming, policy)) {
+            report.changedIDs.push_back(incoming.getID());
+            report.updated++;
+        } else {
+            report.unchanged++;
+        }
+    }
+
+    for (const HOST &incoming : incomingHosts) {
+        if (!seen.insert(incoming.getKey()).second) {
+            report.duplicates++;
+            continue;
+        }
+
+        auto it = hostIndex.find(incoming.getKey());
+        if (it == hostIndex.end()) {
+            if (memberIndex.count(incoming.getKey())) {
+                report.rejected++;
+                continue;
+            }
+            report.changedIDs.push_back(appendHost(incoming));
+            report.added++;
+        } else if (mergeRecord((*hosts)[it->second], incoming, policy)) {
+            report.changedIDs.push_back(incoming.getID());
+            report.updated++;
+        } else {
+            report.unchanged++;
+        }
+    }
+
+    if (!report.changedIDs.empty()) {
+        ++this->epoch;
+        lock.unlock();
+        saveCache();
+        notifyPeopleMerged(report.changedIDs);
+    }
+    return report;
+}
+
+const string &PERSONMANAGER::getLoadWarning() const { return this->loadWarning; }
+
+uint64_t PERSONMANAGER::getEpoch() const {
+    shared_lock<shared_mutex> lock(this->storeMutex);
+    return this->epoch;
+}
+
+// NOTE: Written from a snapshot outside the store lock so readers are not held up by the file write. Saves are
+// serialized, a later save always writes a later snapshot.
+void PERSONMANAGER::saveCache() {
+    lock_guard<mutex> saving(this->saveMutex);
+    PEOPLESNAPSHOT people = getSnapshot();
+    updatePeopleCacheFile(people.getMembers(), people.getHosts());
+
+    unique_lock<shared_mutex> lock(this->storeMutex);
+    this->savedEpoch = people.getEpoch();
+}
+
+// NOTE: A list still shared with a snapshot is copied before its first change; later changes reuse the copy
+vector<MEMBER> &PERSONMANAGER::writableMembers() {
+    if (this->listsInArena) {
+        leaveArena();
+    } else if (this->members.use_count() > 1) {
+        this->members = make_shared<vector<MEMBER>>(*this->members);
+    }
+    return *this->members;
+}
+
+vector<HOST> &PERSONMANAGER::writableHosts() {
+    if (this->listsInArena) {
+        leaveArena();
+    } else if (this->hosts.use_count() > 1) {
+        this->hosts = make_shared<vector<HOST>>(*this->hosts);
+    }
+    return *this->hosts;
+}
+
+// NOTE: Both lists are copied at once, the loaded arena is only released when neither still uses it. The copies are
+// built on the heap since writers never run in an ARENASCOPE. Snapshots taken before keep the old lists and arena.
+void PERSONMANAGER::leaveArena() {
+    this->members = make_shared<vector<MEMBER>>(*this->members);
+    this->hosts = make_shared<vector<HOST>>(*this->hosts);
+    this->snapshotArena = make_shared<SNAPSHOTARENA>();
+    this->listsInArena = false;
+}
+
+bool PERSONMANAGER::isPersonKeyTaken(const IDKEY &key) const { return memberIndex.count(key) || hostIndex.count(key); }
+
+bool PERSONMANAGER::isPersonIDTaken(const string &id) const {
+    shared_lock<shared_mutex> lock(this->storeMutex);
+    return isPersonKeyTaken(IDKEY(id));
+}
+
+string PERSONMANAGER::allocatePersonID(const string &baseID) {
+    unique_lock<shared_mutex> lock(this->storeMutex);
+    return allocateFreeID(baseID);
+}
+
+string PERSONMANAGER::allocateFreeID(const string &baseID) {
+    return personIDs.allocate(baseID, [this](const IDKEY &key) { return isPersonKeyTaken(key); });
+}
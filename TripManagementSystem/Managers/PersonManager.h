@@ -1,32 +1,167 @@
 #ifndef PERSONMANAGER_H
 #define PERSONMANAGER_H
 
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "../Models/header.h"
 #include "FileManager.h"
+#include "IdAllocator.h"
+#include "MergeImport.h"
 #include "Observer.h"
+#include "SnapshotArena.h"
 
 using namespace std;
 
 class OBSERVER;
 
-class PERSONMANAGER : public SUBJECT {
+// CLASS: PEOPLEVIEW
+// Read-only range over all members followed by all hosts, yielding them as PERSON references without copying or
+// slicing. It only points at the manager's vectors, so it is cheap to return by value and always up to date;
+// iterators are invalidated whenever the underlying vectors are.
+class PEOPLEVIEW {
    private:
-    vector<MEMBER> members;
-    vector<HOST> hosts;
+    const vector<MEMBER> *members;
+    const vector<HOST> *hosts;
+
+   public:
+    class ITERATOR {
+       private:
+        const vector<MEMBER> *members;
+        const vector<HOST> *hosts;
+        size_t index;
+
+       public:
+        using iterator_category = random_access_iterator_tag;
+        using value_type = PERSON;
+        using difference_type = ptrdiff_t;
+        using pointer = const PERSON *;
+        using reference = const PERSON &;
+
+        ITERATOR(const vector<MEMBER> *_members, const vector<HOST> *_hosts, size_t _index)
+            : members(_members), hosts(_hosts), index(_index) {}
+
+        reference operator*() const {
+            if (index < members->size()) {
+                return (*members)[index];
+            }
+            return (*hosts)[index - members->size()];
+        }
+        pointer operator->() const { return &**this; }
+
+        ITERATOR &operator++() {
+            ++index;
+            return *this;
+        }
+        ITERATOR operator++(int) {
+            ITERATOR previous = *this;
+            ++index;
+            return previous;
+        }
+        ITERATOR &operator+=(difference_type n) {
+            index += n;
+            return *this;
+        }
+        ITERATOR operator+(difference_type n) const { return ITERATOR(members, hosts, index + n); }
+        difference_type operator-(const ITERATOR &other) const {
+            return static_cast<difference_type>(index) - static_cast<difference_type>(other.index);
+        }
+        reference operator[](difference_type n) const { return *(*this + n); }
+
+        bool operator==(const ITERATOR &other) const { return index == other.index; }
+        bool operator!=(const ITERATOR &other) const { return index != other.index; }
+        bool operator<(const ITERATOR &other) const { return index < other.index; }
+    };
+
+    PEOPLEVIEW(const vector<MEMBER> &_members, const vector<HOST> &_hosts) : members(&_members), hosts(&_hosts) {}
+
+    ITERATOR begin() const { return ITERATOR(members, hosts, 0); }
+    ITERATOR end() const { return ITERATOR(members, hosts, size()); }
+    size_t size() const { return members->size() + hosts->size(); }
+    bool empty() const { return members->empty() && hosts->empty(); }
+    const PERSON &operator[](size_t index) const { return begin()[index]; }
+};
+
+// CLASS: PEOPLESNAPSHOT
+// Immutable view of the people store at one epoch. It shares the member and host lists the store had when it was
+// taken; the store copies a list before changing it while a snapshot still holds it, so the view never moves.
+class PEOPLESNAPSHOT {
+   private:
+    // NOTE: Declared first so the arena outlives the lists allocated from it
+    shared_ptr<SNAPSHOTARENA> arena;
+    shared_ptr<const vector<MEMBER>> members;
+    shared_ptr<const vector<HOST>> hosts;
+    uint64_t epoch;
+
+   public:
+    PEOPLESNAPSHOT(shared_ptr<SNAPSHOTARENA> _arena, shared_ptr<const vector<MEMBER>> _members,
+                   shared_ptr<const vector<HOST>> _hosts, uint64_t _epoch)
+        : arena(move(_arena)), members(move(_members)), hosts(move(_hosts)), epoch(_epoch) {}
+
+    const vector<MEMBER> &getMembers() const { return *members; }
+    const vector<HOST> &getHosts() const { return *hosts; }
+    PEOPLEVIEW getAllPeople() const { return PEOPLEVIEW(*members, *hosts); }
+    uint64_t getEpoch() const { return epoch; }
+};
 
-    mutable vector<PERSON> people;
-    mutable bool peopleNeedsUpdate;
+// CLASS: PERSONMANAGER
+// Owns the people store. Lookups, snapshots and share handles may run on any thread alongside the writer: they take
+// the lock shared, writers take it exclusively and notify observers only after releasing it. Raw pointers, views and
+// references into the live lists are for the writing (UI) thread; other threads use getSnapshot() or the share
+// handles, which stay valid and unchanged however the store grows.
+class PERSONMANAGER : public SUBJECT {
+   private:
+    mutable shared_mutex storeMutex;
+    // NOTE: Serializes cache writes, which run outside the store lock
+    mutex saveMutex;
+    // NOTE: Declared before members and hosts so the arena outlives everything allocated from it. The arena and the
+    // lists are shared with snapshots, a list is copied on its first change while a snapshot holds it.
+    shared_ptr<SNAPSHOTARENA> snapshotArena;
+    shared_ptr<vector<MEMBER>> members;
+    shared_ptr<vector<HOST>> hosts;
+    // NOTE: Set while the lists are the ones loaded into snapshotArena. The first change moves them to the heap and
+    // starts a new arena, an edit in place would grow the loaded one, which never frees.
+    bool listsInArena = false;
+    unordered_map<IDKEY, size_t, IDKEY_HASH> memberIndex;
+    unordered_map<IDKEY, size_t, IDKEY_HASH> hostIndex;
+    // NOTE: People left out of the indexes because an earlier one has their ID (a damaged cache). While there are
+    // any, a removal or an ID change reindexes everyone so the next one with that ID takes over.
+    size_t duplicatePersonCount = 0;
+    IDALLOCATOR personIDs;
+    // NOTE: Bumped by every change to the people lists; savedEpoch is the epoch last written to the cache
+    uint64_t epoch = 0;
+    uint64_t savedEpoch = 0;
+    // NOTE: Set when the cache could not be loaded, the caller decides how to tell the user
+    string loadWarning;
+
+    // NOTE: Helpers below expect the caller to hold the lock
+    void rebuildIndexes();
+    vector<MEMBER> &writableMembers();
+    vector<HOST> &writableHosts();
+    void leaveArena();
+    const MEMBER *lookupMember(const IDKEY &key) const;
+    const HOST *lookupHost(const IDKEY &key) const;
+    bool isPersonKeyTaken(const IDKEY &key) const;
+    string allocateFreeID(const string &baseID);
+    string appendMember(const MEMBER &member);
+    string appendHost(const HOST &host);
+
+    void saveCache();
 
    public:
     PERSONMANAGER();
     ~PERSONMANAGER();
 
-    void addPerson(const PERSON &person);
-    void addMember(const MEMBER &member);
-    void addHost(const HOST &host);
+    // NOTE: Adding never creates a duplicate ID, a taken ID is suffixed and the ID actually stored is returned
+    string addPerson(const PERSON &person);
+    string addMember(const MEMBER &member);
+    string addHost(const HOST &host);
 
     bool removePerson(const string &personID);
     bool removeMember(const string &memberID);
@@ -37,11 +172,22 @@ class PERSONMANAGER : public SUBJECT {
     bool updateHost(const HOST &originalHost, const HOST &updatedHost);
     bool updatePeople(const vector<PERSON> &updatedPeople);
 
-    PERSON *findPersonById(const string &id);
-    MEMBER *findMemberById(const string &id);
-    HOST *findHostById(const string &id);
-
-    const vector<PERSON> &getAllPeople() const;
+    // NOTE: Lookups only read, changes go through updatePerson. The pointer stays valid until the next write.
+    const PERSON *findPersonById(const string &id) const;
+    const MEMBER *findMemberById(const string &id) const;
+    const HOST *findHostById(const string &id) const;
+    const MEMBER *findMemberByKey(const IDKEY &key) const;
+    const HOST *findHostByKey(const IDKEY &key) const;
+
+    // NOTE: Thread-safe handles, they keep the list they point into alive and unchanged
+    shared_ptr<const MEMBER> shareMemberById(const string &id) const;
+    shared_ptr<const HOST> shareHostById(const string &id) const;
+    shared_ptr<const MEMBER> shareMemberByKey(const IDKEY &key) const;
+    shared_ptr<const HOST> shareHostByKey(const IDKEY &key) const;
+
+    PEOPLEVIEW getAllPeople() const;
+    // NOTE: O(1), the snapshot stays valid and unchanged however the store changes afterwards
+    PEOPLESNAPSHOT getSnapshot() const;
     const vector<MEMBER> &getAllMembers() const;
     const vector<HOST> &getAllHosts() const;
 
@@ -51,6 +197,8 @@ class PERSONMANAGER : public SUBJECT {
     size_t getPersonCount() const;
     size_t getMemberCount() const;
     size_t getHostCount() const;
+    uint64_t getEpoch() const;
+    const string &getLoadWarning() const;
 
     HOST getHostByID(const string &hostID);
     MEMBER getMemberByID(const string &memberID);
@@ -58,7 +206,15 @@ class PERSONMANAGER : public SUBJECT {
     void addMultipleMembers(const vector<MEMBER> &newMembers);
     void addMultipleHosts(const vector<HOST> &newHosts);
 
-    void refreshPeopleVector() const;
+    // NOTE: Joins imported people to the store by ID and applies the policy to matches, as one batch. An ID held by
+    // a person of the other role is rejected rather than merged.
+    MERGEREPORT mergePeople(const vector<MEMBER> &incomingMembers, const vector<HOST> &incomingHosts,
+                            MERGEPOLICY policy);
+
+    // Unique IDs across members and hosts, checked against the hash indexes
+    bool isPersonIDTaken(const string &id) const;
+    string allocatePersonID(const string &baseID);
+
     bool validateDataIntegrity() const;
     void debugPrintCounts() const;
 };
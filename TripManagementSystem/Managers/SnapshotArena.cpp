@@ -0,0 +1,38 @@
+#include "SnapshotArena.h"
+
+using namespace std;
+
+// FUNC: Upstream resource
+void *SNAPSHOTARENA::COUNTINGRESOURCE::do_allocate(size_t bytes, size_t alignment) {
+    void *p = pmr::new_delete_resource()->allocate(bytes, alignment);
+    this->bytesReserved += bytes;
+    this->blockCount++;
+    return p;
+}
+
+void SNAPSHOTARENA::COUNTINGRESOURCE::do_deallocate(void *p, size_t bytes, size_t alignment) {
+    pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    this->bytesReserved -= bytes;
+    this->blockCount--;
+}
+
+bool SNAPSHOTARENA::COUNTINGRESOURCE::do_is_equal(const pmr::memory_resource &other) const noexcept {
+    return this == &other;
+}
+
+// FUNC: Constructor
+SNAPSHOTARENA::SNAPSHOTARENA(size_t initialSize) : upstream(), buffer(initialSize, &upstream) {}
+
+// FUNC: Getters
+pmr::memory_resource *SNAPSHOTARENA::getResource() { return &this->buffer; }
+
+size_t SNAPSHOTARENA::getBytesReserved() const { return this->upstream.bytesReserved; }
+
+size_t SNAPSHOTARENA::getBlockCount() const { return this->upstream.blockCount; }
+
+// FUNC: Scope guard
+ARENASCOPE::ARENASCOPE(SNAPSHOTARENA &arena) : previous(modelArenaResource) {
+    modelArenaResource = arena.getResource();
+}
+
+ARENASCOPE::~ARENASCOPE() { modelArenaResource = this->previous; }
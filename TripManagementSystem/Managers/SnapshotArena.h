@@ -0,0 +1,59 @@
+#ifndef SNAPSHOTARENA_H
+#define SNAPSHOTARENA_H
+
+#include <cstddef>
+#include <memory_resource>
+
+#include "../Models/header.h"
+
+using namespace std;
+
+// CLASS: SNAPSHOTARENA
+// Monotonic memory for everything built by one cache load. Models constructed while an ARENASCOPE is active on the
+// constructing thread allocate from here; individual frees are no-ops and the whole block list is returned when the
+// arena is destroyed together with the snapshot that replaced it.
+class SNAPSHOTARENA {
+   private:
+    // Forwards to the global heap and records how much the arena asked for
+    class COUNTINGRESOURCE : public pmr::memory_resource {
+       public:
+        size_t bytesReserved = 0;
+        size_t blockCount = 0;
+
+       protected:
+        void *do_allocate(size_t bytes, size_t alignment) override;
+        void do_deallocate(void *p, size_t bytes, size_t alignment) override;
+        bool do_is_equal(const pmr::memory_resource &other) const noexcept override;
+    };
+
+    COUNTINGRESOURCE upstream;
+    pmr::monotonic_buffer_resource buffer;
+
+   public:
+    static constexpr size_t DEFAULT_INITIAL_SIZE = 64 * 1024;
+
+    explicit SNAPSHOTARENA(size_t initialSize = DEFAULT_INITIAL_SIZE);
+    SNAPSHOTARENA(const SNAPSHOTARENA &) = delete;
+    SNAPSHOTARENA &operator=(const SNAPSHOTARENA &) = delete;
+
+    pmr::memory_resource *getResource();
+    size_t getBytesReserved() const;
+    size_t getBlockCount() const;
+};
+
+// CLASS: ARENASCOPE
+// Makes an arena the model resource of the calling thread until the scope ends (see modelResource). Other threads
+// keep building models on the heap meanwhile.
+class ARENASCOPE {
+   private:
+    pmr::memory_resource *previous;
+
+   public:
+    explicit ARENASCOPE(SNAPSHOTARENA &arena);
+    ~ARENASCOPE();
+
+    ARENASCOPE(const ARENASCOPE &) = delete;
+    ARENASCOPE &operator=(const ARENASCOPE &) = delete;
+};
+
+#endif  // SNAPSHOTARENA_H
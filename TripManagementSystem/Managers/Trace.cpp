@@ -0,0 +1,180 @@
+#include "Trace.h"
+
+#include <array>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <nlohmann/json.hpp>
+#include <stdexcept>
+#include <vector>
+
+#include "Log.h"
+
+using namespace std;
+
+namespace {
+struct TRACEEVENT {
+    const char *name;
+    const char *category;
+    int64_t start;
+    int64_t end;
+};
+
+// NOTE: Chunks of 256 KB are added as a thread needs them, up to 4M spans per thread and recording
+constexpr size_t TRACE_CHUNK_EVENTS = 8192;
+constexpr size_t TRACE_MAX_CHUNKS = 512;
+
+// CLASS: TRACEBUFFER
+// Spans of one thread. Only that thread writes; an event is visible to readers once count has moved past it. A
+// buffer whose generation is behind the recording's still holds the previous recording, its thread clears it on the
+// next span.
+struct TRACEBUFFER {
+    uint32_t threadNumber = 0;
+    atomic<uint64_t> generation{0};
+    atomic<size_t> count{0};
+    atomic<size_t> dropped{0};
+    array<atomic<TRACEEVENT *>, TRACE_MAX_CHUNKS> chunks{};
+
+    ~TRACEBUFFER() {
+        for (auto &chunk : this->chunks) {
+            delete[] chunk.load();
+        }
+    }
+};
+
+// NOTE: Buffers stay registered after their thread ended, its spans are part of the recording
+struct TRACEREGISTRY {
+    mutex registryMutex;
+    vector<shared_ptr<TRACEBUFFER>> buffers;
+    atomic<uint64_t> generation{0};
+};
+
+TRACEREGISTRY &traceRegistry() {
+    static TRACEREGISTRY registry;
+    return registry;
+}
+
+TRACEBUFFER &threadBuffer() {
+    thread_local shared_ptr<TRACEBUFFER> buffer;
+    if (!buffer) {
+        TRACEREGISTRY &registry = traceRegistry();
+        lock_guard<mutex> lock(registry.registryMutex);
+        buffer = make_shared<TRACEBUFFER>();
+        buffer->threadNumber = static_cast<uint32_t>(registry.buffers.size() + 1);
+        registry.buffers.push_back(buffer);
+    }
+    return *buffer;
+}
+
+// NOTE: Trace-event timestamps are microseconds, written with the nanoseconds as decimals
+void writeMicroseconds(ostream &out, int64_t nanoseconds) {
+    out << nanoseconds / 1000 << '.';
+    int64_t fraction = nanoseconds % 1000;
+    out << static_cast<char>('0' + fraction / 100) << static_cast<char>('0' + fraction / 10 % 10)
+        << static_cast<char>('0' + fraction % 10);
+}
+}  // namespace
+
+// FUNC: Recording
+void startTracing() {
+    // NOTE: Moving the generation on makes every thread drop its old spans before it records a new one
+    traceRegistry().generation.fetch_add(1, memory_order_acq_rel);
+    traceClockNanoseconds();
+    traceRecording.store(true, memory_order_release);
+}
+
+void stopTracing() { traceRecording.store(false, memory_order_release); }
+
+bool tracingCompiledIn() {
+#ifdef TRIP_TRACING
+    return true;
+#else
+    return false;
+#endif
+}
+
+int64_t traceClockNanoseconds() {
+    static const chrono::steady_clock::time_point origin = chrono::steady_clock::now();
+    return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - origin).count();
+}
+
+void recordTraceSpan(const char *name, const char *category, int64_t start, int64_t end) {
+    TRACEBUFFER &buffer = threadBuffer();
+    uint64_t generation = traceRegistry().generation.load(memory_order_acquire);
+    if (buffer.generation.load(memory_order_relaxed) != generation) {
+        buffer.count.store(0, memory_order_relaxed);
+        buffer.dropped.store(0, memory_order_relaxed);
+        buffer.generation.store(generation, memory_order_release);
+    }
+
+    size_t index = buffer.count.load(memory_order_relaxed);
+    size_t chunkIndex = index / TRACE_CHUNK_EVENTS;
+    if (chunkIndex >= TRACE_MAX_CHUNKS) {
+        buffer.dropped.fetch_add(1, memory_order_relaxed);
+        return;
+    }
+
+    TRACEEVENT *chunk = buffer.chunks[chunkIndex].load(memory_order_relaxed);
+    if (!chunk) {
+        chunk = new TRACEEVENT[TRACE_CHUNK_EVENTS];
+        buffer.chunks[chunkIndex].store(chunk, memory_order_release);
+    }
+    chunk[index % TRACE_CHUNK_EVENTS] = {name, category, start, end};
+    buffer.count.store(index + 1, memory_order_release);
+}
+
+// FUNC: Export
+void writeChromeTrace(ostream &out) {
+    TRACEREGISTRY &registry = traceRegistry();
+    vector<shared_ptr<TRACEBUFFER>> buffers;
+    {
+        lock_guard<mutex> lock(registry.registryMutex);
+        buffers = registry.buffers;
+    }
+    uint64_t generation = registry.generation.load(memory_order_acquire);
+
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    size_t dropped = 0;
+    for (const auto &buffer : buffers) {
+        // NOTE: A thread that has not recorded since the start still holds the previous recording
+        if (buffer->generation.load(memory_order_acquire) != generation) {
+            continue;
+        }
+
+        out << (first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"
+            << buffer->threadNumber << ",\"args\":{\"name\":\"thread " << buffer->threadNumber << "\"}}";
+        first = false;
+
+        size_t count = buffer->count.load(memory_order_acquire);
+        for (size_t i = 0; i < count; ++i) {
+            const TRACEEVENT &event =
+                buffer->chunks[i / TRACE_CHUNK_EVENTS].load(memory_order_acquire)[i % TRACE_CHUNK_EVENTS];
+            out << ",\n{\"name\":" << nlohmann::json(event.name).dump()
+                << ",\"cat\":" << nlohmann::json(event.category).dump() << ",\"ph\":\"X\",\"pid\":1,\"tid\":"
+                << buffer->threadNumber << ",\"ts\":";
+            writeMicroseconds(out, event.start);
+            out << ",\"dur\":";
+            writeMicroseconds(out, event.end - event.start);
+            out << '}';
+        }
+        dropped += buffer->dropped.load(memory_order_relaxed);
+    }
+    out << "\n]}\n";
+
+    if (dropped > 0) {
+        logWarning("Trace buffers were full, " + to_string(dropped) + " spans are missing from the trace");
+    }
+}
+
+void writeChromeTraceFile(const string &filePath) {
+    ofstream file(filePath);
+    if (!file.is_open()) {
+        throw runtime_error("Could not open trace file: " + filePath);
+    }
+    writeChromeTrace(file);
+    if (!file) {
+        throw runtime_error("Could not write trace file: " + filePath);
+    }
+}
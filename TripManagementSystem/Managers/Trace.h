@@ -0,0 +1,68 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+using namespace std;
+
+// ==================== TRACE SPANS ====================
+// Timed scopes recorded as Chrome trace events, for opening in Perfetto (ui.perfetto.dev) or chrome://tracing.
+// TRACE_SPAN compiles to nothing unless the build defines TRIP_TRACING (qmake CONFIG+=tracing). In a tracing build a
+// span costs one relaxed load while nothing is being recorded.
+//
+// Each thread appends to a buffer of its own without locking, only its first span registers the buffer under a mutex.
+// Names and categories have to be string literals, the buffers keep the pointers.
+
+#ifdef TRIP_TRACING
+#define TRACE_SPAN_CONCAT_(a, b) a##b
+#define TRACE_SPAN_CONCAT(a, b) TRACE_SPAN_CONCAT_(a, b)
+#define TRACE_SPAN(name, category) TRACESPAN TRACE_SPAN_CONCAT(traceSpan, __LINE__)(name, category)
+#else
+#define TRACE_SPAN(name, category) ((void)0)
+#endif
+
+// NOTE: Set while a recording is running, read by every span
+inline atomic<bool> traceRecording{false};
+
+// FUNC: Start a recording, dropping what an earlier one left. Must not be called while writeChromeTrace runs.
+void startTracing();
+void stopTracing();
+// NOTE: False when the build left the spans out, a recording then stays empty
+bool tracingCompiledIn();
+
+// FUNC: The current recording as trace-event JSON, safe while other threads are still recording
+void writeChromeTrace(ostream &out);
+// NOTE: Throws runtime_error when the file cannot be written
+void writeChromeTraceFile(const string &filePath);
+
+// FUNC: Nanoseconds on a steady clock since the first trace call of the process
+int64_t traceClockNanoseconds();
+void recordTraceSpan(const char *name, const char *category, int64_t start, int64_t end);
+
+// CLASS: TRACESPAN
+// Records the time from its construction to its destruction, use it through TRACE_SPAN
+class TRACESPAN {
+   private:
+    const char *name;
+    const char *category;
+    // NOTE: -1 when nothing was being recorded at construction
+    int64_t start;
+
+   public:
+    TRACESPAN(const char *name, const char *category)
+        : name(name),
+          category(category),
+          start(traceRecording.load(memory_order_relaxed) ? traceClockNanoseconds() : -1) {}
+    ~TRACESPAN() {
+        if (this->start >= 0) {
+            recordTraceSpan(this->name, this->category, this->start, traceClockNanoseconds());
+        }
+    }
+    TRACESPAN(const TRACESPAN &) = delete;
+    TRACESPAN &operator=(const TRACESPAN &) = delete;
+};
+
+#endif  // TRACE_H
@@ -25,8 +25,7 @@ string TRIPFACTORY::generateTripID(const string& destination, const DATE& startD
 }
 
 TRIP TRIPFACTORY::createTrip(const string& destination, const string& description, const DATE& startDate,
-                             const DATE& endDate, STATUS status, const vector<EXPENSE>& expenses,
-                             long long totalExpense) {
+                             const DATE& endDate, STATUS status, const vector<EXPENSE>& expenses) {
     string tripID = generateTripID(destination, startDate);
-    return TRIP(tripID, destination, description, startDate, endDate, status, expenses, totalExpense);
+    return TRIP(tripID, destination, description, startDate, endDate, status, expenses);
 }
@@ -11,8 +11,9 @@ class TRIPFACTORY {
 
    public:
     static TRIP createTrip(const string& destination, const string& description, const DATE& startDate,
-                           const DATE& endDate, STATUS status, const vector<EXPENSE>& expenses, long long totalExpense);
+                           const DATE& endDate, STATUS status, const vector<EXPENSE>& expenses);
 
+    // NOTE: Base ID only, it can collide; TRIPMANAGER::allocateTripID makes it unique
     static string generateTripID(const string& destination, const DATE& startDate);
 };
 
@@ -0,0 +1,118 @@
+#include "TripFilter.h"
+
+#include <algorithm>
+
+using namespace std;
+
+namespace {
+bool equalsIgnoringCase(const string &text, const string &other) {
+    return text.size() == other.size() && equal(text.begin(), text.end(), other.begin(), [](char a, char b) {
+               return toupper(static_cast<unsigned char>(a)) == toupper(static_cast<unsigned char>(b));
+           });
+}
+
+// NOTE: Compares in place, no upper-cased copies of the text per trip
+bool containsIgnoringCase(const string &text, const string &part) {
+    return search(text.begin(), text.end(), part.begin(), part.end(), [](char a, char b) {
+               return toupper(static_cast<unsigned char>(a)) == toupper(static_cast<unsigned char>(b));
+           }) != text.end();
+}
+
+// NOTE: Position of the status name in alphabetical order, which is how the dialog has always sorted statuses
+int statusSortRank(STATUS status) {
+    switch (status) {
+        case STATUS::Cancelled:
+            return 0;
+        case STATUS::Completed:
+            return 1;
+        case STATUS::Ongoing:
+            return 2;
+        default:
+            return 3;
+    }
+}
+
+bool isBefore(const TRIP &a, const TRIP &b, TRIPSORTKEY key) {
+    switch (key) {
+        case TRIPSORTKEY::EndDate:
+            return a.getEndDate() < b.getEndDate();
+        case TRIPSORTKEY::Destination:
+            return a.getDestination() < b.getDestination();
+        case TRIPSORTKEY::ID:
+            return a.getKey() < b.getKey();
+        case TRIPSORTKEY::Status:
+            return statusSortRank(a.getStatus()) < statusSortRank(b.getStatus());
+        case TRIPSORTKEY::DescriptionLength:
+            return a.getDescription().length() < b.getDescription().length();
+        default:
+            return a.getStartDate() < b.getStartDate();
+    }
+}
+}  // namespace
+
+bool TRIPFILTER::matches(const TRIP &trip) const {
+    if (!this->destinationText.empty()) {
+        bool found = this->exactDestination ? equalsIgnoringCase(trip.getDestination(), this->destinationText)
+                                            : containsIgnoringCase(trip.getDestination(), this->destinationText);
+        if (!found) {
+            return false;
+        }
+    }
+
+    if (!this->destination.empty() && trip.getDestination() != this->destination) {
+        return false;
+    }
+
+    if (find(this->statuses.begin(), this->statuses.end(), trip.getStatus()) == this->statuses.end()) {
+        return false;
+    }
+
+    if (!this->keywords.empty()) {
+        string description = trip.getDescription();
+        bool keywordMatches = any_of(this->keywords.begin(), this->keywords.end(), [&](const string &keyword) {
+            return this->caseSensitiveKeywords ? description.find(keyword) != string::npos
+                                               : containsIgnoringCase(description, keyword);
+        });
+        if (!keywordMatches) {
+            return false;
+        }
+    }
+
+    if (this->filterDates) {
+        DATE startDate = trip.getStartDate();
+        DATE endDate = trip.getEndDate();
+        if (startDate < this->startFrom || this->startTo < startDate) {
+            return false;
+        }
+        if (endDate < this->endFrom || this->endTo < endDate) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+string trimWhitespace(const string &text) {
+    auto isBlank = [](unsigned char c) { return isspace(c) != 0; };
+    auto first = find_if_not(text.begin(), text.end(), isBlank);
+    auto last = find_if_not(text.rbegin(), text.rend(), isBlank).base();
+    return (first < last) ? string(first, last) : string();
+}
+
+vector<string> splitKeywords(const string &text) {
+    vector<string> keywords;
+    string part;
+    stringstream stream(text);
+    while (getline(stream, part, ',')) {
+        if (!part.empty()) {
+            keywords.push_back(trimWhitespace(part));
+        }
+    }
+    return keywords;
+}
+
+TRIPSNAPSHOT sortTrips(const TRIPSNAPSHOT &trips, TRIPSORTKEY key, bool ascending) {
+    return trips.sorted([key, ascending](const TRIP &a, const TRIP &b) {
+        return ascending ? isBefore(a, b, key) : isBefore(b, a, key);
+    });
+}
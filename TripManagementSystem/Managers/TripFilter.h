@@ -0,0 +1,42 @@
+#ifndef TRIPFILTER_H
+#define TRIPFILTER_H
+
+#include <string>
+#include <vector>
+
+#include "../Models/header.h"
+#include "TripSnapshot.h"
+
+using namespace std;
+
+// CLASS: TRIPFILTER
+// Criteria of the trip filter dialog, read from its widgets once per refresh instead of once per trip. Text matches
+// ignore ASCII case. An empty criterion accepts every trip, date ranges are inclusive.
+struct TRIPFILTER {
+    // NOTE: Part of the destination, or all of it when exactDestination is set
+    string destinationText;
+    bool exactDestination = false;
+    // NOTE: Destination picked from the list, compared as is
+    string destination;
+    vector<STATUS> statuses = {STATUS::Planned, STATUS::Ongoing, STATUS::Completed, STATUS::Cancelled};
+    // NOTE: A trip matches when its description contains any keyword, see splitKeywords
+    vector<string> keywords;
+    bool caseSensitiveKeywords = false;
+    bool filterDates = false;
+    DATE startFrom, startTo, endFrom, endTo;
+
+    bool matches(const TRIP &trip) const;
+};
+
+// FUNC: Comma separated keywords, each trimmed; a part of blanks only becomes an empty keyword that matches anything
+vector<string> splitKeywords(const string &text);
+string trimWhitespace(const string &text);
+
+// CLASS: TRIPSORTKEY
+// Columns the filter dialog sorts by, in the order of its sort combo box
+enum class TRIPSORTKEY { StartDate, EndDate, Destination, ID, Status, DescriptionLength };
+
+// FUNC: Descending swaps the operands instead of negating the comparison, which would not be a strict weak order
+TRIPSNAPSHOT sortTrips(const TRIPSNAPSHOT &trips, TRIPSORTKEY key, bool ascending);
+
+#endif  // TRIPFILTER_H
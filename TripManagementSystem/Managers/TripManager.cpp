@@ -1,43 +1,762 @@
 #include "TripManager.h"
 
+#include <algorithm>
+#include <iterator>
+#include <thread>
+#include <unordered_set>
+
+#include "FileManager.h"
+#include "Log.h"
+#include "Metrics.h"
+#include "PersonManager.h"
+#include "Trace.h"
+
 using namespace std;
 
-void TRIPMANAGER::addTrip(const TRIP &trip) {
-    trips.push_back(trip);
-    notifyTripAdded(trip.getID());
+namespace {
+bool samePersonData(const PERSON &embedded, const PERSON &current) {
+    return embedded.getFullName() == current.getFullName() && embedded.getEmail() == current.getEmail() &&
+           embedded.getPhoneNumber() == current.getPhoneNumber() && embedded.getAddress() == current.getAddress() &&
+           embedded.getGender() == current.getGender() && embedded.getDateOfBirth() == current.getDateOfBirth();
+}
+
+vector<IDKEY> sortedUnique(vector<IDKEY> keys) {
+    sort(keys.begin(), keys.end());
+    keys.erase(unique(keys.begin(), keys.end()), keys.end());
+    return keys;
+}
+}  // namespace
+
+TRIPMANAGER::TRIPMANAGER() : current(make_shared<TRIPLIST>()) { this->current->arena = make_shared<SNAPSHOTARENA>(); }
+
+// NOTE: Writers change the store under the exclusive lock and release it before notifying, observers read back
+string TRIPMANAGER::addTrip(const TRIP &trip) {
+    unique_lock<shared_mutex> lock(this->storeMutex);
+    shared_ptr<TRIPLIST> previous = this->current;
+    TRIPLIST &list = writableList();
+
+    string id = allocateFreeID(trip.getID());
+    list.trips.push_back(make_shared<TRIP>(trip));
+    TRIP &added = *list.trips.back();
+    added.setID(id);
+    if (added.getUpdatedAt() == 0) {
+        added.setUpdatedAt(currentUnixTime());
+    }
+
+    tripIndex.emplace(added.getKey(), list.trips.size() - 1);
+    indexReferences(added);
+    recordUndoStep(move(previous));
+    ++this->epoch;
+    lock.unlock();
+    notifyTripAdded(id);
+    return id;
+}
+
+MERGEREPORT TRIPMANAGER::mergeTrips(const vector<TRIP> &incomingTrips, MERGEPOLICY policy,
+                                    const PERSONMANAGER *personManager) {
+    unique_lock<shared_mutex> lock(this->storeMutex);
+    shared_ptr<TRIPLIST> previous = this->current;
+    MERGEREPORT report;
+    unordered_set<IDKEY, IDKEY_HASH> seen;
+    seen.reserve(incomingTrips.size());
+
+    for (const TRIP &incoming : incomingTrips) {
+        // NOTE: The first occurrence of an ID in the file wins
+        if (!seen.insert(incoming.getKey()).second) {
+            report.duplicates++;
+            continue;
+        }
+
+        auto it = tripIndex.find(incoming.getKey());
+        if (it == tripIndex.end()) {
+            TRIPLIST &list = writableList();
+            list.trips.push_back(make_shared<TRIP>(incoming));
+            if (list.trips.back()->getUpdatedAt() == 0) {
+                list.trips.back()->setUpdatedAt(currentUnixTime());
+            }
+            tripIndex.emplace(incoming.getKey(), list.trips.size() - 1);
+            indexReferences(*list.trips.back());
+            report.added++;
+            report.changedIDs.push_back(incoming.getID());
+            continue;
+        }
+
+        // NOTE: Checked before taking a writable copy, so skipped trips stay shared with snapshots and history
+        if (keepsStoredRecord(*this->current->trips[it->second], incoming, policy)) {
+            report.unchanged++;
+            continue;
+        }
+
+        TRIP &stored = writableTrip(it->second);
+        bool resolved = policy == MERGEPOLICY::FieldMerge && !stored.isDetailsLoaded();
+        if (resolved) {
+            ::loadTripDetails(stored, personManager);
+        }
+
+        bool merged = mergeRecord(stored, incoming, policy);
+        // NOTE: Resolving the details drops people missing from the people list, so that refreshes the entries too
+        if (merged || resolved) {
+            indexReferences(stored);
+        }
+        if (merged) {
+            report.updated++;
+            report.changedIDs.push_back(incoming.getID());
+        } else {
+            report.unchanged++;
+        }
+    }
+
+    if (!report.changedIDs.empty()) {
+        recordUndoStep(move(previous));
+        ++this->epoch;
+        lock.unlock();
+        notifyTripsMerged(report.changedIDs);
+    }
+    return report;
 }
 
 bool TRIPMANAGER::removeTrip(const string &tripID) {
-    for (size_t i = 0; i < trips.size(); ++i) {
-        if (this->trips[i].getID() == tripID) {
-            this->trips.erase(this->trips.begin() + i);
-            notifyTripRemoved(tripID);
-            return true;
+    unique_lock<shared_mutex> lock(this->storeMutex);
+    auto it = tripIndex.find(IDKEY(tripID));
+    if (it == tripIndex.end()) {
+        return false;
+    }
+
+    // NOTE: Swap-and-pop, like TRIP::removeExpense: the last trip takes the removed one's slot, so only its index
+    // entry moves. The list order changes.
+    shared_ptr<TRIPLIST> previous = this->current;
+    TRIPLIST &list = writableList();
+    IDKEY key = it->first;
+    size_t slot = it->second;
+    size_t last = list.trips.size() - 1;
+    tripIndex.erase(it);
+    if (slot != last) {
+        list.trips.set(slot, list.trips[last]);
+        auto moved = tripIndex.find(list.trips[slot]->getKey());
+        if (moved != tripIndex.end() && moved->second == last) {
+            moved->second = slot;
         }
     }
-    return false;
+    list.trips.pop_back();
+
+    unindexReferences(key);
+    if (this->duplicateTripCount > 0) {
+        rebuildIndex();
+        const TRIP *duplicate = findStoredTrip(key);
+        if (duplicate) {
+            indexReferences(*duplicate);
+        }
+    }
+    recordUndoStep(move(previous));
+    ++this->epoch;
+    lock.unlock();
+    notifyTripRemoved(tripID);
+    return true;
 }
 
 bool TRIPMANAGER::updateTrip(const TRIP &originalTrip, const TRIP &updatedTrip) {
-    for (size_t i = 0; i < this->trips.size(); ++i) {
-        if (this->trips[i].getID() == originalTrip.getID()) {
-            this->trips[i] = updatedTrip;
-            notifyTripUpdated(updatedTrip.getID());
-            return true;
+    unique_lock<shared_mutex> lock(this->storeMutex);
+    auto it = tripIndex.find(originalTrip.getKey());
+    if (it == tripIndex.end()) {
+        return false;
+    }
+
+    // NOTE: The stored trip is replaced rather than overwritten, snapshots holding the old one keep it
+    shared_ptr<TRIPLIST> previous = this->current;
+    shared_ptr<TRIP> stored = make_shared<TRIP>(updatedTrip);
+    writableList().trips.set(it->second, stored);
+    stored->setUpdatedAt(currentUnixTime());
+    if (originalTrip.getKey() != updatedTrip.getKey()) {
+        // NOTE: A regenerated ID (new destination or start date) must not land on another trip's; the old ID is
+        // released first so the trip does not collide with itself
+        size_t slot = it->second;
+        tripIndex.erase(it);
+        stored->setID(allocateFreeID(updatedTrip.getID()));
+        tripIndex.emplace(stored->getKey(), slot);
+        if (this->duplicateTripCount > 0) {
+            rebuildIndex();
+        }
+        unindexReferences(originalTrip.getKey());
+    }
+    indexReferences(*stored);
+    recordUndoStep(move(previous));
+    ++this->epoch;
+    lock.unlock();
+    notifyTripUpdated(stored->getID());
+    return true;
+}
+
+// NOTE: O(1), the snapshot shares the current trip list instead of copying it
+TRIPSNAPSHOT TRIPMANAGER::getAllTrips() const {
+    shared_lock<shared_mutex> lock(this->storeMutex);
+    return currentSnapshot();
+}
+
+TRIPSNAPSHOT TRIPMANAGER::currentSnapshot() const { return TRIPSNAPSHOT(this->current, this->epoch); }
+
+shared_ptr<const TRIP> TRIPMANAGER::shareTripById(const string &id) const {
+    shared_lock<shared_mutex> lock(this->storeMutex);
+    auto it = tripIndex.find(IDKEY(id));
+    return (it != tripIndex.end()) ? shareTrip(*this->current, it->second) : nullptr;
+}
+
+// FUNC: Undo / redo
+// NOTE: Each step keeps the previous version of the list, which shares everything but the tree path and the trips
+// the write changed
+bool TRIPMANAGER::canUndo() const {
+    shared_lock<shared_mutex> lock(this->storeMutex);
+    return !this->undoHistory.empty();
+}
+
+bool TRIPMANAGER::canRedo() const {
+    shared_lock<shared_mutex> lock(this->storeMutex);
+    return !this->redoHistory.empty();
+}
+
+bool TRIPMANAGER::undo() {
+    unique_lock<shared_mutex> lock(this->storeMutex);
+    if (this->undoHistory.empty()) {
+        return false;
+    }
+
+    this->redoHistory.push_back(this->current);
+    shared_ptr<TRIPLIST> restored = move(this->undoHistory.back());
+    this->undoHistory.pop_back();
+    restoreList(move(restored));
+    lock.unlock();
+    notifyTripsRestored();
+    return true;
+}
+
+bool TRIPMANAGER::redo() {
+    unique_lock<shared_mutex> lock(this->storeMutex);
+    if (this->redoHistory.empty()) {
+        return false;
+    }
+
+    this->undoHistory.push_back(this->current);
+    shared_ptr<TRIPLIST> restored = move(this->redoHistory.back());
+    this->redoHistory.pop_back();
+    restoreList(move(restored));
+    lock.unlock();
+    notifyTripsRestored();
+    return true;
+}
+
+void TRIPMANAGER::clearHistory() {
+    unique_lock<shared_mutex> lock(this->storeMutex);
+    resetHistory();
+}
+
+void TRIPMANAGER::resetHistory() {
+    this->undoHistory.clear();
+    this->redoHistory.clear();
+}
+
+void TRIPMANAGER::recordUndoStep(shared_ptr<TRIPLIST> previous) {
+    this->undoHistory.push_back(move(previous));
+    if (this->undoHistory.size() > MAX_UNDO_STEPS) {
+        this->undoHistory.erase(this->undoHistory.begin());
+    }
+    this->redoHistory.clear();
+}
+
+// NOTE: Only the slots where the two versions differ are reindexed, found by comparing the lists' trees. Steps next
+// to each other in the history share all but what one write touched, so this costs about as much as that write.
+void TRIPMANAGER::restoreList(shared_ptr<TRIPLIST> list) {
+    vector<size_t> changedSlots;
+    PERSISTENTVECTOR<shared_ptr<TRIP>>::diff(this->current->trips, list->trips,
+                                             [&changedSlots](size_t slot) { changedSlots.push_back(slot); });
+
+    for (size_t slot : changedSlots) {
+        if (slot >= this->current->trips.size()) {
+            continue;
+        }
+        IDKEY key = this->current->trips[slot]->getKey();
+        auto it = tripIndex.find(key);
+        if (it != tripIndex.end() && it->second == slot) {
+            tripIndex.erase(it);
+            unindexReferences(key);
+        }
+    }
+
+    this->current = move(list);
+    for (size_t slot : changedSlots) {
+        if (slot >= this->current->trips.size()) {
+            continue;
+        }
+        const TRIP &trip = *this->current->trips[slot];
+        if (tripIndex.emplace(trip.getKey(), slot).second) {
+            indexReferences(trip);
+        } else {
+            this->duplicateTripCount++;
+        }
+    }
+    if (this->duplicateTripCount > 0) {
+        rebuildIndex();
+        rebuildReferenceIndexes();
+    }
+    ++this->epoch;
+}
+
+// FUNC: Copy on write
+// NOTE: Anything still holding the list or the trip (a snapshot, the undo history) keeps the old one. A trip still in
+// the load arena is copied to the heap before its first change too: the arena only frees when the next load replaces
+// it, so changes made in place, detail loads included, would grow it for the rest of the session. Writers never run
+// in an ARENASCOPE, so modelResource() is the heap here.
+TRIPLIST &TRIPMANAGER::writableList() {
+    if (this->current.use_count() > 1) {
+        this->current = make_shared<TRIPLIST>(*this->current);
+    }
+    return *this->current;
+}
+
+TRIP &TRIPMANAGER::writableTrip(size_t index) {
+    shared_ptr<TRIP> &trip = writableList().trips.mutableAt(index);
+    if (trip.use_count() > 1 || trip->getResource() != modelResource()) {
+        trip = make_shared<TRIP>(*trip);
+    }
+    return *trip;
+}
+
+TRIP *TRIPMANAGER::findWritableTrip(const IDKEY &key) {
+    auto it = tripIndex.find(key);
+    return (it != tripIndex.end()) ? &writableTrip(it->second) : nullptr;
+}
+
+const TRIP *TRIPMANAGER::findStoredTrip(const IDKEY &key) const {
+    auto it = tripIndex.find(key);
+    return (it != tripIndex.end()) ? this->current->trips[it->second].get() : nullptr;
+}
+
+// NOTE: The pointer stays valid until the next write, other threads use shareTripById instead
+const TRIP *TRIPMANAGER::findTripById(const string &id) const {
+    static METRICHISTOGRAM &lookupTime = metricHistogram("lookup.trip_ns", "ns", 64);
+    METRICTIMER timer(lookupTime);
+    shared_lock<shared_mutex> lock(this->storeMutex);
+    return findStoredTrip(IDKEY(id));
+}
+
+size_t TRIPMANAGER::getTripCount() const {
+    shared_lock<shared_mutex> lock(this->storeMutex);
+    return this->current->trips.size();
+}
+
+uint64_t TRIPMANAGER::getEpoch() const {
+    shared_lock<shared_mutex> lock(this->storeMutex);
+    return this->epoch;
+}
+
+size_t TRIPMANAGER::getSnapshotBytes() const {
+    shared_lock<shared_mutex> lock(this->storeMutex);
+    return this->current->arena->getBytesReserved();
+}
+
+string TRIPMANAGER::allocateTripID(const string &baseID) {
+    unique_lock<shared_mutex> lock(this->storeMutex);
+    return allocateFreeID(baseID);
+}
+
+string TRIPMANAGER::allocateFreeID(const string &baseID) {
+    return tripIDs.allocate(baseID, [this](const IDKEY &key) { return tripIndex.count(key) > 0; });
+}
+
+// NOTE: Replace all trips with the cache content. The new trips are built in a fresh arena; the old arena is
+// released in one go once no snapshot holds a list built on it. A reload cannot be undone. The file is read before
+// taking the lock, readers keep working on the old list meanwhile.
+size_t TRIPMANAGER::loadSnapshot() {
+    TRACE_SPAN("TRIPMANAGER::loadSnapshot", "load");
+    shared_ptr<TRIPLIST> loaded = make_shared<TRIPLIST>();
+    loaded->arena = make_shared<SNAPSHOTARENA>();
+    {
+        ARENASCOPE scope(*loaded->arena);
+        vector<TRIP> loadedTrips;
+        loadTripCacheFile(loadedTrips);
+
+        for (TRIP &trip : loadedTrips) {
+            loaded->trips.push_back(make_shared<TRIP>(move(trip)));
+        }
+    }
+
+    unique_lock<shared_mutex> lock(this->storeMutex);
+    TRACE_SPAN("rebuildIndexes", "load");
+    this->current = move(loaded);
+    resetHistory();
+    rebuildIndex();
+    rebuildReferenceIndexes();
+    ++this->epoch;
+    return this->current->trips.size();
+}
+
+bool TRIPMANAGER::isMemberOfTrip(const string &tripID, const string &memberID) const {
+    shared_lock<shared_mutex> lock(this->storeMutex);
+    return membership.contains(IDKEY(tripID), IDKEY(memberID));
+}
+
+vector<IDKEY> TRIPMANAGER::getMemberKeysOfTrip(const string &tripID) const {
+    shared_lock<shared_mutex> lock(this->storeMutex);
+    return membership.getMembersOfTrip(IDKEY(tripID));
+}
+
+vector<IDKEY> TRIPMANAGER::getTripKeysOfMember(const string &memberID) const {
+    shared_lock<shared_mutex> lock(this->storeMutex);
+    return membership.getTripsOfMember(IDKEY(memberID));
+}
+
+vector<IDKEY> TRIPMANAGER::getTripKeysOfHost(const string &hostID) const {
+    shared_lock<shared_mutex> lock(this->storeMutex);
+    return hosting.getTripsOfHost(IDKEY(hostID));
+}
+
+void TRIPMANAGER::rebuildIndex() {
+    const PERSISTENTVECTOR<shared_ptr<TRIP>> &trips = this->current->trips;
+    this->duplicateTripCount = 0;
+    tripIndex.clear();
+    tripIndex.reserve(trips.size());
+    for (size_t i = 0; i < trips.size(); ++i) {
+        this->duplicateTripCount += tripIndex.emplace(trips[i]->getKey(), i).second ? 0 : 1;
+    }
+}
+
+// NOTE: Reverse references from people to trips: membership, hosting and expense payers, along with the expense
+// totals, which change with the same writes
+void TRIPMANAGER::indexReferences(const TRIP &trip) {
+    membership.setTripMembers(trip.getKey(), trip.getMemberKeys());
+    hosting.setTripHost(trip.getKey(), trip.getHostKey());
+    payers.setTripMembers(trip.getKey(), trip.getPayerKeys());
+    expenseTotals.setTrip(trip);
+}
+
+void TRIPMANAGER::unindexReferences(const IDKEY &tripKey) {
+    membership.removeTrip(tripKey);
+    hosting.removeTrip(tripKey);
+    payers.removeTrip(tripKey);
+    expenseTotals.removeTrip(tripKey);
+}
+
+void TRIPMANAGER::rebuildReferenceIndexes() {
+    TRIPSNAPSHOT trips = currentSnapshot();
+    membership.rebuild(trips);
+    hosting.rebuild(trips);
+    payers.clear();
+    expenseTotals.clear();
+    for (size_t i = 0; i < trips.size(); ++i) {
+        if (tripIndex.at(trips[i].getKey()) == i) {
+            payers.setTripMembers(trips[i].getKey(), trips[i].getPayerKeys());
+            expenseTotals.setTrip(trips[i]);
         }
     }
-    return false;
 }
 
-const vector<TRIP> &TRIPMANAGER::getAllTrips() const { return this->trips; }
+// NOTE: Every trip that mentions a person as member, host or expense PIC, in key order
+vector<IDKEY> TRIPMANAGER::getReferencingTripKeys(const string &personID) const {
+    shared_lock<shared_mutex> lock(this->storeMutex);
+    return collectReferencingTripKeys(IDKEY(personID));
+}
 
-TRIP *TRIPMANAGER::findTripById(const string &id) {
-    for (size_t i = 0; i < this->trips.size(); ++i) {
-        if (this->trips[i].getID() == id) {
-            return &this->trips[i];
+vector<IDKEY> TRIPMANAGER::collectReferencingTripKeys(const IDKEY &key) const {
+    const vector<IDKEY> &joined = membership.getTripsOfMember(key);
+    const vector<IDKEY> &hosted = hosting.getTripsOfHost(key);
+    const vector<IDKEY> &paid = payers.getTripsOfMember(key);
+
+    vector<IDKEY> merged;
+    merged.reserve(joined.size() + hosted.size() + paid.size());
+    set_union(joined.begin(), joined.end(), hosted.begin(), hosted.end(), back_inserter(merged));
+
+    vector<IDKEY> result;
+    result.reserve(merged.size() + paid.size());
+    set_union(merged.begin(), merged.end(), paid.begin(), paid.end(), back_inserter(result));
+    return result;
+}
+
+// NOTE: Header-only trips know their payers by ID only, so their expenses are resolved before reading them
+vector<pair<string, EXPENSE>> TRIPMANAGER::getSpendingsOfMember(const string &memberID,
+                                                               const PERSONMANAGER *personManager) {
+    unique_lock<shared_mutex> lock(this->storeMutex);
+    IDKEY key(memberID);
+    // NOTE: Copy the keys, resolving a trip refreshes its index entries
+    vector<IDKEY> tripKeys = payers.getTripsOfMember(key);
+
+    vector<pair<string, EXPENSE>> spendings;
+    for (const IDKEY &tripKey : tripKeys) {
+        if (!loadStoredTripDetails(tripKey, personManager)) {
+            continue;
+        }
+        const TRIP *trip = findStoredTrip(tripKey);
+        for (const EXPENSE &expense : trip->getExpensesPaidBy(key)) {
+            spendings.emplace_back(trip->getID(), expense);
         }
     }
-    return nullptr;
+    return spendings;
 }
 
-size_t TRIPMANAGER::getTripCount() const { return this->trips.size(); }
\ No newline at end of file
+EXPENSESUM TRIPMANAGER::getExpenseTotal() const {
+    shared_lock<shared_mutex> lock(this->storeMutex);
+    return expenseTotals.getTotal();
+}
+
+EXPENSESUM TRIPMANAGER::getExpenseTotalOfTrip(const string &tripID) const {
+    shared_lock<shared_mutex> lock(this->storeMutex);
+    return expenseTotals.getTripTotal(IDKEY(tripID));
+}
+
+// NOTE: What the member paid as person in charge, over all trips
+EXPENSESUM TRIPMANAGER::getExpenseTotalOfMember(const string &memberID) const {
+    shared_lock<shared_mutex> lock(this->storeMutex);
+    return expenseTotals.getMemberTotal(IDKEY(memberID));
+}
+
+EXPENSESUM TRIPMANAGER::getExpenseTotalOfCategory(CATEGORY category) const {
+    shared_lock<shared_mutex> lock(this->storeMutex);
+    return expenseTotals.getCategoryTotal(category);
+}
+
+EXPENSESUM TRIPMANAGER::getExpenseTotalOfDestination(const string &destination) const {
+    shared_lock<shared_mutex> lock(this->storeMutex);
+    return expenseTotals.getDestinationTotal(destination);
+}
+
+vector<pair<int, EXPENSESUM>> TRIPMANAGER::getMonthlyExpenseTotals() const {
+    shared_lock<shared_mutex> lock(this->storeMutex);
+    return expenseTotals.getMonthTotals();
+}
+
+// NOTE: Push a person's current data into the copies embedded in trips. Only the trips referencing the old ID are
+// visited. An edit may change the ID: loaded trips then point their copies at the new ID and header-only trips have it
+// rewritten in their pending details, and the indexes are moved to the new ID. Otherwise header-only trips are skipped
+// because they resolve fresh copies when their details are loaded. The undo history is dropped, undoing past a person
+// change would bring back stale or dangling references to them.
+size_t TRIPMANAGER::cascadePersonUpdated(const string &oldID, const string &newID, const PERSONMANAGER *personManager) {
+    if (!personManager) {
+        return 0;
+    }
+
+    IDKEY oldKey(oldID);
+    bool idChanged = oldID != newID;
+    shared_ptr<const MEMBER> member = personManager->shareMemberById(newID);
+    shared_ptr<const HOST> host = personManager->shareHostById(newID);
+    unique_lock<shared_mutex> lock(this->storeMutex);
+    resetHistory();
+
+    size_t updatedCount = 0;
+    for (const IDKEY &tripKey : collectReferencingTripKeys(oldKey)) {
+        const TRIP *shared = findStoredTrip(tripKey);
+        if (!shared || (!shared->isDetailsLoaded() && !idChanged)) {
+            continue;
+        }
+
+        TRIP *trip = findWritableTrip(tripKey);
+        bool changed = false;
+        if (!trip->isDetailsLoaded()) {
+            changed = renamePendingPerson(*trip, oldID, newID);
+        } else {
+            if (member) {
+                changed = trip->refreshMember(oldKey, *member) || changed;
+            }
+            if (host) {
+                changed = trip->refreshHost(oldKey, *host) || changed;
+            }
+        }
+        if (changed) {
+            if (idChanged) {
+                indexReferences(*trip);
+            }
+            updatedCount++;
+        }
+    }
+    if (updatedCount > 0) {
+        ++this->epoch;
+    }
+    return updatedCount;
+}
+
+// NOTE: Remove a deleted person from every trip referencing them. Call after the person is gone from the
+// PERSONMANAGER so header-only trips drop them while their details are resolved.
+size_t TRIPMANAGER::cascadePersonRemoved(const string &personID, const PERSONMANAGER *personManager) {
+    IDKEY key(personID);
+    unique_lock<shared_mutex> lock(this->storeMutex);
+    resetHistory();
+
+    size_t updatedCount = 0;
+    for (const IDKEY &tripKey : collectReferencingTripKeys(key)) {
+        TRIP *trip = findWritableTrip(tripKey);
+        if (!trip) {
+            continue;
+        }
+
+        bool changed = false;
+        if (!trip->isDetailsLoaded()) {
+            ::loadTripDetails(*trip, personManager);
+            changed = trip->isDetailsLoaded();
+        }
+        if (trip->isDetailsLoaded()) {
+            changed = trip->removePerson(key) || changed;
+        }
+
+        if (changed) {
+            indexReferences(*trip);
+            updatedCount++;
+        }
+    }
+    if (updatedCount > 0) {
+        ++this->epoch;
+    }
+    return updatedCount;
+}
+
+// NOTE: Resolve members, host and expenses of a trip that was loaded header-only
+bool TRIPMANAGER::loadTripDetails(const string &tripID, const PERSONMANAGER *personManager) {
+    unique_lock<shared_mutex> lock(this->storeMutex);
+    return loadStoredTripDetails(IDKEY(tripID), personManager);
+}
+
+bool TRIPMANAGER::loadStoredTripDetails(const IDKEY &key, const PERSONMANAGER *personManager) {
+    const TRIP *shared = findStoredTrip(key);
+    if (!shared) {
+        return false;
+    }
+    if (shared->isDetailsLoaded()) {
+        return true;
+    }
+
+    TRIP *trip = findWritableTrip(key);
+    ::loadTripDetails(*trip, personManager);
+    // NOTE: People missing from the people list are dropped while resolving, so refresh the trip's entries
+    indexReferences(*trip);
+    return true;
+}
+
+void TRIPMANAGER::loadAllTripDetails(const PERSONMANAGER *personManager) {
+    unique_lock<shared_mutex> lock(this->storeMutex);
+    for (size_t i = 0; i < this->current->trips.size(); ++i) {
+        if (!this->current->trips[i]->isDetailsLoaded()) {
+            ::loadTripDetails(writableTrip(i), personManager);
+        }
+    }
+    rebuildReferenceIndexes();
+}
+// NOTE: Checks one trip against the people list and the reverse indexes. Only reads shared state, so several trips
+// can be checked at once.
+void TRIPMANAGER::checkTripIntegrity(size_t index, const PERSONMANAGER *personManager, vector<string> &problems) const {
+    const TRIP &trip = *this->current->trips[index];
+    string prefix = "Trip " + trip.getID() + ": ";
+
+    auto indexIt = tripIndex.find(trip.getKey());
+    if (indexIt == tripIndex.end() || indexIt->second != index) {
+        problems.push_back(prefix + "duplicate trip ID");
+        return;
+    }
+
+    IDKEY hostKey = trip.getHostKey();
+    vector<IDKEY> memberKeys = sortedUnique(trip.getMemberKeys());
+    vector<IDKEY> payerKeys = sortedUnique(trip.getPayerKeys());
+
+    if (hostKey != hosting.getHostOfTrip(trip.getKey())) {
+        problems.push_back(prefix + "host index is out of date");
+    }
+    if (memberKeys != membership.getMembersOfTrip(trip.getKey())) {
+        problems.push_back(prefix + "membership index is out of date");
+    }
+    if (payerKeys != payers.getMembersOfTrip(trip.getKey())) {
+        problems.push_back(prefix + "expense payer index is out of date");
+    }
+    if (!expenseTotals.isUpToDate(trip)) {
+        problems.push_back(prefix + "expense totals are out of date");
+    }
+
+    if (!personManager) {
+        return;
+    }
+
+    if (!hostKey.empty()) {
+        shared_ptr<const HOST> host = personManager->shareHostByKey(hostKey);
+        if (!host) {
+            problems.push_back(prefix + "unknown host " + hostKey.str());
+        } else if (trip.isDetailsLoaded() && !samePersonData(trip.getHost(), *host)) {
+            problems.push_back(prefix + "stale copy of host " + hostKey.str());
+        }
+    }
+    for (const IDKEY &memberKey : memberKeys) {
+        if (!personManager->shareMemberByKey(memberKey)) {
+            problems.push_back(prefix + "unknown member " + memberKey.str());
+        }
+    }
+    for (const IDKEY &payerKey : payerKeys) {
+        if (!personManager->shareMemberByKey(payerKey)) {
+            problems.push_back(prefix + "unknown person in charge " + payerKey.str());
+        }
+    }
+
+    if (!trip.isDetailsLoaded()) {
+        return;
+    }
+
+    vector<MEMBER> members = trip.getMembers();
+    if (members.size() != memberKeys.size()) {
+        problems.push_back(prefix + "duplicated members");
+    }
+    for (const MEMBER &member : members) {
+        shared_ptr<const MEMBER> current = personManager->shareMemberByKey(member.getKey());
+        if (current && !samePersonData(member, *current)) {
+            problems.push_back(prefix + "stale copy of member " + member.getID());
+        }
+    }
+
+    long long expenseSum = 0;
+    unordered_set<IDKEY, IDKEY_HASH> expenseIDs;
+    for (const EXPENSE &expense : trip.getAllExpenses()) {
+        expenseSum += expense.getAmount();
+        if (!expenseIDs.insert(expense.getKey()).second || expense.getKey().empty()) {
+            problems.push_back(prefix + "expense without a unique ID " + expense.getID());
+        }
+    }
+    if (expenseSum != trip.getTotalExpense()) {
+        problems.push_back(prefix + "total expense " + to_string(trip.getTotalExpense()) +
+                           " does not match the expenses (" + to_string(expenseSum) + ")");
+    }
+}
+
+// NOTE: Full consistency check, trips are split into contiguous chunks checked on separate threads. The workers
+// read under the shared lock held here for the whole check.
+vector<string> TRIPMANAGER::findIntegrityProblems(const PERSONMANAGER *personManager, unsigned threadCount) const {
+    shared_lock<shared_mutex> lock(this->storeMutex);
+    if (threadCount == 0) {
+        threadCount = max(1u, thread::hardware_concurrency());
+    }
+    size_t tripCount = this->current->trips.size();
+    size_t chunkCount = (tripCount + MIN_TRIPS_PER_WORKER - 1) / MIN_TRIPS_PER_WORKER;
+    chunkCount = max<size_t>(1, min<size_t>(threadCount, chunkCount));
+
+    vector<vector<string>> chunkProblems(chunkCount);
+    auto checkChunk = [&](size_t chunk) {
+        size_t begin = tripCount * chunk / chunkCount;
+        size_t end = tripCount * (chunk + 1) / chunkCount;
+        for (size_t i = begin; i < end; ++i) {
+            checkTripIntegrity(i, personManager, chunkProblems[chunk]);
+        }
+    };
+
+    vector<thread> workers;
+    workers.reserve(chunkCount - 1);
+    for (size_t chunk = 1; chunk < chunkCount; ++chunk) {
+        workers.emplace_back(checkChunk, chunk);
+    }
+    checkChunk(0);
+    for (thread &worker : workers) {
+        worker.join();
+    }
+
+    vector<string> problems;
+    for (vector<string> &chunk : chunkProblems) {
+        problems.insert(problems.end(), make_move_iterator(chunk.begin()), make_move_iterator(chunk.end()));
+    }
+    return problems;
+}
+
+bool TRIPMANAGER::validateDataIntegrity(const PERSONMANAGER *personManager) const {
+    vector<string> problems = findIntegrityProblems(personManager);
+    for (const string &problem : problems) {
+        logWarning(problem);
+    }
+    return problems.empty();
+}
@@ -1,25 +1,125 @@
 #ifndef TRIPMANAGER_H
 #define TRIPMANAGER_H
 
+#include <memory>
+#include <shared_mutex>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "../Models/header.h"
+#include "ExpenseAggregates.h"
+#include "IdAllocator.h"
+#include "MembershipIndex.h"
+#include "MergeImport.h"
 #include "Observer.h"
+#include "SnapshotArena.h"
+#include "TripSnapshot.h"
 
 using namespace std;
 
+class PERSONMANAGER;
+
+// CLASS: TRIPMANAGER
+// Owns the trip store. Snapshots, share handles and index queries may run on any thread alongside the writer: they
+// take the lock shared, writers take it exclusively and notify observers only after releasing it. A writer may read
+// the PERSONMANAGER while holding this lock, never the other way round. findTripById is for the writing (UI) thread.
 class TRIPMANAGER : public SUBJECT {
    private:
-    vector<TRIP> trips;
+    mutable shared_mutex storeMutex;
+    // NOTE: The live version of the trip list. Snapshots and the undo history may share it, its tree nodes and its
+    // trips, so whatever a change touches is copied first while shared (see TRIPSNAPSHOT and PERSISTENTVECTOR)
+    shared_ptr<TRIPLIST> current;
+    vector<shared_ptr<TRIPLIST>> undoHistory;
+    vector<shared_ptr<TRIPLIST>> redoHistory;
+    unordered_map<IDKEY, size_t, IDKEY_HASH> tripIndex;
+    // NOTE: Trips left out of tripIndex because an earlier trip has their ID (a damaged cache). While there are any,
+    // a removal or an ID change reindexes the list so the next trip with that ID takes over.
+    size_t duplicateTripCount = 0;
+    MEMBERSHIPINDEX membership;
+    HOSTINDEX hosting;
+    MEMBERSHIPINDEX payers;
+    EXPENSEAGGREGATES expenseTotals;
+    IDALLOCATOR tripIDs;
+    // NOTE: Bumped by every change to the trip list or a stored trip, equal epochs mean nothing changed in between
+    uint64_t epoch = 0;
+
+    static constexpr size_t MIN_TRIPS_PER_WORKER = 256;
+    static constexpr size_t MAX_UNDO_STEPS = 50;
+
+    // NOTE: Helpers below expect the caller to hold the lock
+    TRIPSNAPSHOT currentSnapshot() const;
+    TRIPLIST &writableList();
+    TRIP &writableTrip(size_t index);
+    TRIP *findWritableTrip(const IDKEY &key);
+    void recordUndoStep(shared_ptr<TRIPLIST> previous);
+    void restoreList(shared_ptr<TRIPLIST> list);
+    void resetHistory();
+    const TRIP *findStoredTrip(const IDKEY &key) const;
+    bool loadStoredTripDetails(const IDKEY &key, const PERSONMANAGER *personManager);
+    vector<IDKEY> collectReferencingTripKeys(const IDKEY &personKey) const;
+    string allocateFreeID(const string &baseID);
+
+    void rebuildIndex();
+    void indexReferences(const TRIP &trip);
+    void unindexReferences(const IDKEY &tripKey);
+    void rebuildReferenceIndexes();
+    void checkTripIntegrity(size_t index, const PERSONMANAGER *personManager, vector<string> &problems) const;
 
    public:
-    void addTrip(const TRIP &trip);
+    TRIPMANAGER();
+
+    // NOTE: A trip whose ID is taken is stored under a suffixed ID; the ID actually stored is returned
+    string addTrip(const TRIP &trip);
     bool removeTrip(const string &tripID);
     bool updateTrip(const TRIP &originalTrip, const TRIP &updatedTrip);
-    const vector<TRIP> &getAllTrips() const;
-    TRIP *findTripById(const string &id);
+    TRIPSNAPSHOT getAllTrips() const;
+    const TRIP *findTripById(const string &id) const;
+    shared_ptr<const TRIP> shareTripById(const string &id) const;
     size_t getTripCount() const;
+    uint64_t getEpoch() const;
+    size_t getSnapshotBytes() const;
+    string allocateTripID(const string &baseID);
+
+    // NOTE: Joins imported trips to the store by ID and applies the policy to matches, as one batch
+    MERGEREPORT mergeTrips(const vector<TRIP> &incomingTrips, MERGEPOLICY policy, const PERSONMANAGER *personManager);
+
+    size_t loadSnapshot();
+
+    // Undo / redo of adds, removes, updates and merges. Reloads and person cascades clear the history.
+    bool canUndo() const;
+    bool canRedo() const;
+    bool undo();
+    bool redo();
+    void clearHistory();
+
+    // Membership and hosting queries answered from the indexes, without loading trip details. The keys are copied
+    // out under the lock, the indexes change with every write.
+    bool isMemberOfTrip(const string &tripID, const string &memberID) const;
+    vector<IDKEY> getMemberKeysOfTrip(const string &tripID) const;
+    vector<IDKEY> getTripKeysOfMember(const string &memberID) const;
+    vector<IDKEY> getTripKeysOfHost(const string &hostID) const;
+    vector<IDKEY> getReferencingTripKeys(const string &personID) const;
+
+    // Member spendings are not stored, they are derived from the trip expenses the member is in charge of
+    vector<pair<string, EXPENSE>> getSpendingsOfMember(const string &memberID, const PERSONMANAGER *personManager);
+
+    // Expense totals kept up to date by every write, header-only trips included, so none of these loads details
+    EXPENSESUM getExpenseTotal() const;
+    EXPENSESUM getExpenseTotalOfTrip(const string &tripID) const;
+    EXPENSESUM getExpenseTotalOfMember(const string &memberID) const;
+    EXPENSESUM getExpenseTotalOfCategory(CATEGORY category) const;
+    EXPENSESUM getExpenseTotalOfDestination(const string &destination) const;
+    vector<pair<int, EXPENSESUM>> getMonthlyExpenseTotals() const;
+
+    // Referential integrity: cascade person changes into trips and check the whole store
+    size_t cascadePersonUpdated(const string &oldID, const string &newID, const PERSONMANAGER *personManager);
+    size_t cascadePersonRemoved(const string &personID, const PERSONMANAGER *personManager);
+    vector<string> findIntegrityProblems(const PERSONMANAGER *personManager, unsigned threadCount = 0) const;
+    bool validateDataIntegrity(const PERSONMANAGER *personManager) const;
+
+    bool loadTripDetails(const string &tripID, const PERSONMANAGER *personManager);
+    void loadAllTripDetails(const PERSONMANAGER *personManager);
 };
 
-#endif  // TRIPMANAGER_H
\ No newline at end of file
+#endif  // TRIPMANAGER_H
@@ -0,0 +1,49 @@
+#include "TripSnapshot.h"
+
+#include <algorithm>
+
+using namespace std;
+
+shared_ptr<const TRIP> shareTrip(const TRIPLIST &list, size_t index) {
+    const shared_ptr<TRIP> &trip = list.trips[index];
+    if (!list.arena) {
+        return trip;
+    }
+    auto owner = make_shared<pair<shared_ptr<SNAPSHOTARENA>, shared_ptr<TRIP>>>(list.arena, trip);
+    return shared_ptr<const TRIP>(owner, trip.get());
+}
+
+TRIPSNAPSHOT::TRIPSNAPSHOT() : list(make_shared<TRIPLIST>()), epoch(0) {}
+
+TRIPSNAPSHOT::TRIPSNAPSHOT(shared_ptr<const TRIPLIST> _list, uint64_t _epoch) : list(move(_list)), epoch(_epoch) {}
+
+uint64_t TRIPSNAPSHOT::getEpoch() const { return this->epoch; }
+
+shared_ptr<const TRIP> TRIPSNAPSHOT::share(size_t index) const { return shareTrip(*this->list, index); }
+
+TRIPSNAPSHOT TRIPSNAPSHOT::filter(const function<bool(const TRIP &)> &predicate) const {
+    shared_ptr<TRIPLIST> selected = make_shared<TRIPLIST>();
+    selected->arena = this->list->arena;
+    for (const shared_ptr<TRIP> &trip : this->list->trips) {
+        if (predicate(*trip)) {
+            selected->trips.push_back(trip);
+        }
+    }
+    return TRIPSNAPSHOT(selected, this->epoch);
+}
+
+TRIPSNAPSHOT TRIPSNAPSHOT::sorted(const function<bool(const TRIP &, const TRIP &)> &less) const {
+    // NOTE: Sorted in a plain vector and rebuilt, the nodes of this snapshot are shared and never changed
+    vector<shared_ptr<TRIP>> trips(this->list->trips.begin(), this->list->trips.end());
+    sort(trips.begin(), trips.end(),
+         [&](const shared_ptr<TRIP> &a, const shared_ptr<TRIP> &b) { return less(*a, *b); });
+
+    shared_ptr<TRIPLIST> ordered = make_shared<TRIPLIST>();
+    ordered->arena = this->list->arena;
+    for (shared_ptr<TRIP> &trip : trips) {
+        ordered->trips.push_back(move(trip));
+    }
+    return TRIPSNAPSHOT(ordered, this->epoch);
+}
+
+vector<TRIP> TRIPSNAPSHOT::toVector() const { return vector<TRIP>(begin(), end()); }
@@ -0,0 +1,93 @@
+#ifndef TRIPSNAPSHOT_H
+#define TRIPSNAPSHOT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <vector>
+
+#include "../Models/header.h"
+#include "PersistentVector.h"
+#include "SnapshotArena.h"
+
+using namespace std;
+
+// CLASS: TRIPLIST
+// One version of the trip list. Versions share the trips they have in common and, through PERSISTENTVECTOR, every
+// part of the list a change did not touch. The arena the trips were loaded into is owned jointly by every version
+// built on that load, so it lives as long as any of them.
+struct TRIPLIST {
+    shared_ptr<SNAPSHOTARENA> arena;
+    PERSISTENTVECTOR<shared_ptr<TRIP>> trips;
+};
+
+// FUNC: shareTrip
+// NOTE: The handle owns the trip and the arena its strings and vectors live in, so it outlives a reload of the store.
+// Holding the trip rather than the whole list keeps a later change to the store copying only this trip.
+shared_ptr<const TRIP> shareTrip(const TRIPLIST &list, size_t index);
+
+// CLASS: TRIPSNAPSHOT
+// Immutable view of the trip store at one epoch. Taking one is O(1), it only shares the current TRIPLIST. The store
+// copies a list or a trip before changing it while a snapshot still shares it, so a snapshot never changes under its
+// reader and each old version is freed when its last holder lets go.
+class TRIPSNAPSHOT {
+   private:
+    shared_ptr<const TRIPLIST> list;
+    uint64_t epoch;
+
+   public:
+    class ITERATOR {
+       private:
+        PERSISTENTVECTOR<shared_ptr<TRIP>>::ITERATOR current;
+
+       public:
+        using iterator_category = random_access_iterator_tag;
+        using value_type = TRIP;
+        using difference_type = ptrdiff_t;
+        using pointer = const TRIP *;
+        using reference = const TRIP &;
+
+        explicit ITERATOR(PERSISTENTVECTOR<shared_ptr<TRIP>>::ITERATOR _current) : current(_current) {}
+
+        reference operator*() const { return **current; }
+        pointer operator->() const { return current->get(); }
+
+        ITERATOR &operator++() {
+            ++current;
+            return *this;
+        }
+        ITERATOR operator++(int) {
+            ITERATOR previous = *this;
+            ++current;
+            return previous;
+        }
+        ITERATOR operator+(difference_type n) const { return ITERATOR(current + n); }
+        difference_type operator-(const ITERATOR &other) const { return current - other.current; }
+        reference operator[](difference_type n) const { return *current[n]; }
+
+        bool operator==(const ITERATOR &other) const { return current == other.current; }
+        bool operator!=(const ITERATOR &other) const { return current != other.current; }
+        bool operator<(const ITERATOR &other) const { return current < other.current; }
+    };
+
+    TRIPSNAPSHOT();
+    TRIPSNAPSHOT(shared_ptr<const TRIPLIST> _list, uint64_t _epoch);
+
+    ITERATOR begin() const { return ITERATOR(list->trips.begin()); }
+    ITERATOR end() const { return ITERATOR(list->trips.end()); }
+    size_t size() const { return list->trips.size(); }
+    bool empty() const { return list->trips.empty(); }
+    const TRIP &operator[](size_t index) const { return *list->trips[index]; }
+
+    uint64_t getEpoch() const;
+    shared_ptr<const TRIP> share(size_t index) const;
+
+    // NOTE: Subsets and orderings share the trips of this snapshot, only the pointers are copied
+    TRIPSNAPSHOT filter(const function<bool(const TRIP &)> &predicate) const;
+    TRIPSNAPSHOT sorted(const function<bool(const TRIP &, const TRIP &)> &less) const;
+    vector<TRIP> toVector() const;
+};
+
+#endif  // TRIPSNAPSHOT_H
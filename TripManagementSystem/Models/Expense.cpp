@@ -3,31 +3,40 @@
 using namespace std;
 
 // Constructors
-EXPENSE::EXPENSE() : date(DATE()), amount(0), category(), note(""), personInCharge() {}
+EXPENSE::EXPENSE() : ID(), date(DATE()), amount(0), category(), note(), personInCharge() {}
 
 EXPENSE::EXPENSE(const DATE &_date, const CATEGORY _category, long long _amount, const string &_note,
                  const MEMBER &_member)
-    : date(_date), amount(_amount), category(_category), note(_note), personInCharge(_member) {}
+    : ID(), date(_date), amount(_amount), category(_category), note(_note), personInCharge(_member) {}
 
 EXPENSE::EXPENSE(const EXPENSE &other)
-    : date(other.date),
+    : ID(other.ID),
+      date(other.date),
       amount(other.amount),
       category(other.category),
       note(other.note),
       personInCharge(other.personInCharge) {}
 
 // Getters
+string EXPENSE::getID() const { return this->ID.str(); }
+
+const IDKEY &EXPENSE::getKey() const { return this->ID; }
+
 long long EXPENSE::getAmount() const { return this->amount; }
 
 CATEGORY EXPENSE::getCategory() const { return this->category; }
 
-string EXPENSE::getNote() const { return this->note; }
+const string &EXPENSE::getNote() const { return this->note.str(); }
 
 MEMBER EXPENSE::getPIC() const { return this->personInCharge; }
 
+const IDKEY &EXPENSE::getPICKey() const { return this->personInCharge.getKey(); }
+
 DATE EXPENSE::getDate() const { return this->date; }
 
 // Setters
+void EXPENSE::setID(const string &_id) { this->ID = IDKEY(_id); }
+
 void EXPENSE::setAmount(long long _amount) { this->amount = _amount; }
 
 void EXPENSE::setCategory(CATEGORY _category) { this->category = _category; }
@@ -62,6 +71,7 @@ string EXPENSE::formatCurrency() const {
 
 // Operator overloading
 EXPENSE &EXPENSE::operator=(const EXPENSE &other) {
+    this->ID = other.ID;
     this->date = other.date;
     this->amount = other.amount;
     this->category = other.category;
@@ -73,5 +83,5 @@ EXPENSE &EXPENSE::operator=(const EXPENSE &other) {
 
 bool EXPENSE::operator==(const EXPENSE &other) const {
     return (this->date == other.date && this->amount == other.amount && this->category == other.category &&
-            this->note == other.note && this->personInCharge.getID() == other.personInCharge.getID());
+            this->note == other.note && this->personInCharge.getKey() == other.personInCharge.getKey());
 }
@@ -0,0 +1,136 @@
+#include "header.h"
+
+using namespace std;
+
+namespace {
+template <class KEY>
+void addToGroup(pmr::vector<pair<KEY, EXPENSESUM>> &groups, const KEY &key, long long amount) {
+    for (auto &group : groups) {
+        if (group.first == key) {
+            group.second.add(amount);
+            return;
+        }
+    }
+    groups.emplace_back(key, EXPENSESUM()).second.add(amount);
+}
+
+// NOTE: The emptied group takes the last one's slot, group order carries no meaning
+template <class KEY>
+void removeFromGroup(pmr::vector<pair<KEY, EXPENSESUM>> &groups, const KEY &key, long long amount) {
+    for (size_t i = 0; i < groups.size(); ++i) {
+        if (groups[i].first != key) {
+            continue;
+        }
+        groups[i].second.remove(amount);
+        if (groups[i].second.count == 0) {
+            groups[i] = groups.back();
+            groups.pop_back();
+        }
+        return;
+    }
+}
+
+template <class KEY>
+bool sameGroups(const pmr::vector<pair<KEY, EXPENSESUM>> &a, const pmr::vector<pair<KEY, EXPENSESUM>> &b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    return all_of(a.begin(), a.end(), [&b](const pair<KEY, EXPENSESUM> &group) {
+        return any_of(b.begin(), b.end(), [&group](const pair<KEY, EXPENSESUM> &other) {
+            return other.first == group.first && other.second == group.second;
+        });
+    });
+}
+}  // namespace
+
+// FUNC: EXPENSESUM
+void EXPENSESUM::add(long long _amount) {
+    this->amount += _amount;
+    this->count++;
+}
+
+void EXPENSESUM::remove(long long _amount) {
+    this->amount -= _amount;
+    this->count--;
+}
+
+bool EXPENSESUM::operator==(const EXPENSESUM &other) const {
+    return this->amount == other.amount && this->count == other.count;
+}
+
+int monthKey(const DATE &date) { return date.getYear() * 100 + date.getMonth(); }
+
+// FUNC: Updates
+// FUNC: Constructors
+EXPENSETOTALS::EXPENSETOTALS() : byPayer(modelResource()), byMonth(modelResource()) {}
+
+EXPENSETOTALS::EXPENSETOTALS(const EXPENSETOTALS &other)
+    : total(other.total),
+      byPayer(other.byPayer, modelResource()),
+      byMonth(other.byMonth, modelResource()) {
+    copy(begin(other.byCategory), end(other.byCategory), begin(this->byCategory));
+}
+
+void EXPENSETOTALS::add(long long amount, CATEGORY category, const IDKEY &payer, const DATE &date) {
+    this->total.add(amount);
+    this->byCategory[static_cast<size_t>(category)].add(amount);
+    addToGroup(this->byPayer, payer, amount);
+    addToGroup(this->byMonth, monthKey(date), amount);
+}
+
+void EXPENSETOTALS::remove(long long amount, CATEGORY category, const IDKEY &payer, const DATE &date) {
+    this->total.remove(amount);
+    this->byCategory[static_cast<size_t>(category)].remove(amount);
+    removeFromGroup(this->byPayer, payer, amount);
+    removeFromGroup(this->byMonth, monthKey(date), amount);
+}
+
+void EXPENSETOTALS::add(const EXPENSE &expense) {
+    this->add(expense.getAmount(), expense.getCategory(), expense.getPICKey(), expense.getDate());
+}
+
+void EXPENSETOTALS::remove(const EXPENSE &expense) {
+    this->remove(expense.getAmount(), expense.getCategory(), expense.getPICKey(), expense.getDate());
+}
+
+void EXPENSETOTALS::clear() {
+    this->total = EXPENSESUM();
+    for (EXPENSESUM &sum : this->byCategory) {
+        sum = EXPENSESUM();
+    }
+    this->byPayer.clear();
+    this->byMonth.clear();
+}
+
+// FUNC: Queries
+const EXPENSESUM &EXPENSETOTALS::getTotal() const { return this->total; }
+
+const EXPENSESUM &EXPENSETOTALS::getByCategory(CATEGORY category) const {
+    return this->byCategory[static_cast<size_t>(category)];
+}
+
+EXPENSESUM EXPENSETOTALS::getPaidBy(const IDKEY &payer) const {
+    for (const auto &group : this->byPayer) {
+        if (group.first == payer) {
+            return group.second;
+        }
+    }
+    return EXPENSESUM();
+}
+
+const pmr::vector<pair<IDKEY, EXPENSESUM>> &EXPENSETOTALS::getByPayer() const { return this->byPayer; }
+
+const pmr::vector<pair<int, EXPENSESUM>> &EXPENSETOTALS::getByMonth() const { return this->byMonth; }
+
+// NOTE: Groups may be listed in any order, the same expenses added in another order give equal totals
+bool EXPENSETOTALS::operator==(const EXPENSETOTALS &other) const {
+    if (!(this->total == other.total)) {
+        return false;
+    }
+    for (size_t i = 0; i < CATEGORY_COUNT; ++i) {
+        if (!(this->byCategory[i] == other.byCategory[i])) {
+            return false;
+        }
+    }
+    return sameGroups(this->byPayer, other.byPayer) && sameGroups(this->byMonth, other.byMonth);
+}
@@ -0,0 +1,68 @@
+#include <cstring>
+
+#include "header.h"
+
+using namespace std;
+
+static_assert(IDKEY::INLINE_CAPACITY == 3 * sizeof(uint64_t), "IDKEY comparison assumes three inline words");
+
+namespace {
+// FNV-1a, 32 bit
+uint32_t hashId(const string &id) {
+    uint32_t hash = 2166136261u;
+    for (unsigned char c : id) {
+        hash ^= c;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+}  // namespace
+
+// FUNC: Constructors
+IDKEY::IDKEY() : words{}, hashValue(hashId("")), length(0) {}
+
+IDKEY::IDKEY(const string &_id) : words{}, hashValue(hashId(_id)), length(static_cast<uint32_t>(_id.size())) {
+    if (_id.size() <= INLINE_CAPACITY) {
+        memcpy(this->words, _id.data(), _id.size());
+    } else {
+        // NOTE: Long legacy IDs fall back to the intern pool, the pooled address is unique per text
+        const string *pooled = &ISTRING(_id).str();
+        this->words[0] = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(pooled));
+    }
+}
+
+IDKEY::IDKEY(const char *_id) : IDKEY(string(_id ? _id : "")) {}
+
+// FUNC: Getters
+string IDKEY::str() const {
+    if (this->isInline()) {
+        return string(reinterpret_cast<const char *>(this->words), this->length);
+    }
+    return *reinterpret_cast<const string *>(static_cast<uintptr_t>(this->words[0]));
+}
+
+size_t IDKEY::size() const { return this->length; }
+
+bool IDKEY::empty() const { return this->length == 0; }
+
+bool IDKEY::isInline() const { return this->length <= INLINE_CAPACITY; }
+
+size_t IDKEY::hash() const { return this->hashValue; }
+
+// Operators overloading
+bool IDKEY::operator==(const IDKEY &other) const {
+    uint64_t diff = (this->words[0] ^ other.words[0]) | (this->words[1] ^ other.words[1]) |
+                    (this->words[2] ^ other.words[2]) | (this->length ^ other.length);
+    return diff == 0;
+}
+
+bool IDKEY::operator!=(const IDKEY &other) const { return !(*this == other); }
+
+// NOTE: Orders like the ID strings. Inline IDs compare their bytes in place, only pooled long IDs build strings.
+bool IDKEY::operator<(const IDKEY &other) const {
+    if (this->isInline() && other.isInline()) {
+        int order = memcmp(this->words, other.words, min(this->length, other.length));
+        return order < 0 || (order == 0 && this->length < other.length);
+    }
+    return this->str() < other.str();
+}
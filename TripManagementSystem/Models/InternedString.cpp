@@ -0,0 +1,127 @@
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+
+#include "header.h"
+
+using namespace std;
+
+namespace {
+// NOTE: unordered_set is node based, so element addresses stay valid across rehashing
+unordered_set<string> &internPool() {
+    static unordered_set<string> pool;
+    return pool;
+}
+
+mutex &poolMutex() {
+    static mutex poolLock;
+    return poolLock;
+}
+
+const string *intern(const string &str) {
+    if (str.empty()) {
+        return nullptr;
+    }
+
+    lock_guard<mutex> lock(poolMutex());
+    return &*internPool().insert(str).first;
+}
+
+const string &emptyString() {
+    static const string empty;
+    return empty;
+}
+
+// NOTE: Keys view the text of the entry's own string, an entry is erased before that string is deleted. The
+// dictionary is never destroyed, so handles in static objects can still let go of their text at exit.
+unordered_map<string_view, weak_ptr<const string>> &sharedDictionary() {
+    static auto *dictionary = new unordered_map<string_view, weak_ptr<const string>>();
+    return *dictionary;
+}
+
+mutex &dictionaryMutex() {
+    static auto *dictionaryLock = new mutex();
+    return *dictionaryLock;
+}
+
+// NOTE: Runs when the last handle lets go. A string with the same text may already have replaced the entry, then
+// the entry is no longer expired and stays.
+void releaseShared(const string *str) {
+    {
+        lock_guard<mutex> lock(dictionaryMutex());
+        auto it = sharedDictionary().find(*str);
+        if (it != sharedDictionary().end() && it->second.expired()) {
+            sharedDictionary().erase(it);
+        }
+    }
+    delete str;
+}
+
+shared_ptr<const string> share(const string &str) {
+    if (str.empty()) {
+        return nullptr;
+    }
+
+    lock_guard<mutex> lock(dictionaryMutex());
+    auto it = sharedDictionary().find(str);
+    if (it != sharedDictionary().end()) {
+        if (shared_ptr<const string> shared = it->second.lock()) {
+            return shared;
+        }
+        // NOTE: The last handle just let go and releaseShared waits for the lock, so the entry is replaced here
+        sharedDictionary().erase(it);
+    }
+    shared_ptr<const string> shared(new string(str), releaseShared);
+    sharedDictionary().emplace(*shared, shared);
+    return shared;
+}
+}  // namespace
+
+// FUNC: Constructors
+ISTRING::ISTRING() : value(nullptr) {}
+
+ISTRING::ISTRING(const string &_str) : value(intern(_str)) {}
+
+ISTRING::ISTRING(const char *_str) : value(_str ? intern(string(_str)) : nullptr) {}
+
+// NOTE: Only the upper-cased spelling goes into the pool, the raw spellings a destination is typed in are not kept
+ISTRING ISTRING::internUpper(const string &_str) { return ISTRING(toUpper(_str)); }
+
+size_t ISTRING::poolSize() {
+    lock_guard<mutex> lock(poolMutex());
+    return internPool().size();
+}
+
+// FUNC: Getters
+const string &ISTRING::str() const { return this->value ? *this->value : emptyString(); }
+
+bool ISTRING::empty() const { return this->value == nullptr; }
+
+// Operators overloading
+bool ISTRING::operator==(const ISTRING &other) const { return this->value == other.value; }
+
+bool ISTRING::operator!=(const ISTRING &other) const { return this->value != other.value; }
+
+bool ISTRING::operator<(const ISTRING &other) const { return this->str() < other.str(); }
+
+size_t ISTRING::hash() const { return std::hash<const string *>()(this->value); }
+
+// FUNC: SHAREDSTRING
+SHAREDSTRING::SHAREDSTRING() {}
+
+SHAREDSTRING::SHAREDSTRING(const string &_str) : value(share(_str)) {}
+
+size_t SHAREDSTRING::dictionarySize() {
+    lock_guard<mutex> lock(dictionaryMutex());
+    return sharedDictionary().size();
+}
+
+const string &SHAREDSTRING::str() const { return this->value ? *this->value : emptyString(); }
+
+bool SHAREDSTRING::empty() const { return this->value == nullptr; }
+
+// NOTE: Live handles with equal text share one string, so the pointers compare like the texts
+bool SHAREDSTRING::operator==(const SHAREDSTRING &other) const { return this->value == other.value; }
+
+bool SHAREDSTRING::operator!=(const SHAREDSTRING &other) const { return this->value != other.value; }
@@ -4,17 +4,45 @@ using namespace std;
 
 // FUNC: Constructors
 PERSON::PERSON()
-    : fullName(""), ID(""), email(""), phoneNumber(""), address(""), gender(GENDER::Male), dateOfBirth(DATE()) {}
+    : fullName(modelResource()),
+      ID(),
+      email(modelResource()),
+      phoneNumber(modelResource()),
+      address(modelResource()),
+      gender(GENDER::Male),
+      dateOfBirth(DATE()),
+      updatedAt(0),
+      version(nextModelVersion()) {}
 
 PERSON::PERSON(const string &_id, const string &_fullName, const GENDER &_gender, const DATE &_dob)
-    : fullName(_fullName), ID(_id), gender(_gender), dateOfBirth(_dob) {}
+    : fullName(_fullName, modelResource()),
+      ID(_id),
+      email(modelResource()),
+      phoneNumber(modelResource()),
+      address(modelResource()),
+      gender(_gender),
+      dateOfBirth(_dob),
+      updatedAt(0),
+      version(nextModelVersion()) {}
+
+PERSON::PERSON(const PERSON &other)
+    : fullName(other.fullName, modelResource()),
+      ID(other.ID),
+      email(other.email, modelResource()),
+      phoneNumber(other.phoneNumber, modelResource()),
+      address(other.address, modelResource()),
+      gender(other.gender),
+      dateOfBirth(other.dateOfBirth),
+      updatedAt(other.updatedAt),
+      version(other.version) {}
 
 // FUNC: Convert PERSON's info to string (Format: ID,Email,Full Name,Date of
 // Birth,Phone Number,Address,Gender,Nationality)
 string PERSON::toString() const {
     string info = "";
-    info = info + this->ID + ',' + this->email + ',' + this->fullName + ',' + this->dateOfBirth.toString() + ',' +
-           this->phoneNumber + ',' + this->address + ',' + genderToString(this->gender);
+    info = info + this->ID.str() + ',' + this->getEmail() + ',' + this->getFullName() + ',' +
+           this->dateOfBirth.toString() + ',' + this->getPhoneNumber() + ',' + this->getAddress() + ',' +
+           genderToString(this->gender);
     return info;
 }
 
@@ -22,28 +50,59 @@ string PERSON::getRole() const { return "Person"; }
 string PERSON::getInfo() const { return this->toString(); }
 
 // FUNC: Getters
-string PERSON::getFullName() const { return this->fullName; }
-string PERSON::getID() const { return this->ID; }
-string PERSON::getEmail() const { return this->email; }
-string PERSON::getPhoneNumber() const { return this->phoneNumber; }
-string PERSON::getAddress() const { return this->address; }
+string PERSON::getFullName() const { return string(this->fullName); }
+string PERSON::getID() const { return this->ID.str(); }
+const IDKEY &PERSON::getKey() const { return this->ID; }
+string PERSON::getEmail() const { return string(this->email); }
+string PERSON::getPhoneNumber() const { return string(this->phoneNumber); }
+string PERSON::getAddress() const { return string(this->address); }
 GENDER PERSON::getGender() const { return this->gender; }
 DATE PERSON::getDateOfBirth() const { return this->dateOfBirth; }
+long long PERSON::getUpdatedAt() const { return this->updatedAt; }
+uint64_t PERSON::getVersion() const { return this->version; }
 
 // FUNC: Setters
-void PERSON::setFullName(const string &_fullName) { this->fullName = _fullName; }
-void PERSON::setGender(const GENDER &_gender) { this->gender = _gender; }
-void PERSON::setDOB(const DATE &_dob) { this->dateOfBirth = _dob; }
-void PERSON::setID(const string &_ID) { this->ID = _ID; }
-void PERSON::setEmail(const string &_email) { this->email = _email; }
-void PERSON::setPhoneNumber(const string &_phoneNumber) { this->phoneNumber = _phoneNumber; }
-void PERSON::setAddress(const string &_address) { this->address = _address; }
-void PERSON::setDateOfBirth(const DATE &_dob) { this->dateOfBirth = _dob; }
+void PERSON::setFullName(const string &_fullName) {
+    this->fullName = _fullName;
+    this->touch();
+}
+void PERSON::setGender(const GENDER &_gender) {
+    this->gender = _gender;
+    this->touch();
+}
+void PERSON::setDOB(const DATE &_dob) {
+    this->dateOfBirth = _dob;
+    this->touch();
+}
+void PERSON::setID(const string &_ID) {
+    this->ID = _ID;
+    this->touch();
+}
+void PERSON::setEmail(const string &_email) {
+    this->email = _email;
+    this->touch();
+}
+void PERSON::setPhoneNumber(const string &_phoneNumber) {
+    this->phoneNumber = _phoneNumber;
+    this->touch();
+}
+void PERSON::setAddress(const string &_address) {
+    this->address = _address;
+    this->touch();
+}
+void PERSON::setDateOfBirth(const DATE &_dob) {
+    this->dateOfBirth = _dob;
+    this->touch();
+}
+// NOTE: Change metadata, does not count as a change of its own
+void PERSON::setUpdatedAt(long long _updatedAt) { this->updatedAt = _updatedAt; }
+
+void PERSON::touch() { this->version = nextModelVersion(); }
 
 // FUNC: Utility method
 int PERSON::getAge() const { return 2025 - this->dateOfBirth.getYear(); }
 string PERSON::getContactInfo() const {
     string info = "";
-    info += this->email + "," + this->phoneNumber + "," + this->address;
+    info += this->getEmail() + "," + this->getPhoneNumber() + "," + this->getAddress();
     return info;
 }
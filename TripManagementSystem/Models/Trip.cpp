@@ -4,62 +4,96 @@ int TRIP::tripCount = 0;
 
 // FUNC: Constructors
 TRIP::TRIP()
-    : ID(""),
-      Destination(""),
-      Description(""),
+    : ID(),
+      Destination(),
+      Description(modelResource()),
       startDate(1, 1, 2024),
       endDate(1, 1, 2024),
       status(STATUS::Planned),
-      expenses(vector<EXPENSE>()),
-      totalExpense(0) {
+      updatedAt(0),
+      version(nextModelVersion()),
+      members(modelResource()),
+      expenses(modelResource()),
+      expenseIndex(modelResource()),
+      nextExpenseNumber(1),
+      detailsLoaded(true),
+      pendingMemberKeys(modelResource()),
+      pendingPayerKeys(modelResource()) {
     tripCount++;
 }
 
 TRIP::TRIP(const TRIP &other)
     : ID(other.ID),
       Destination(other.Destination),
-      Description(other.Description),
+      Description(other.Description, modelResource()),
       startDate(other.startDate),
       endDate(other.endDate),
       status(other.status),
-      members(other.members),
+      updatedAt(other.updatedAt),
+      version(other.version),
+      members(other.members, modelResource()),
       host(other.host),
-      expenses(other.expenses),
-      totalExpense(other.totalExpense) {}
+      expenses(other.expenses, modelResource()),
+      expenseTotals(other.expenseTotals),
+      expenseIndex(other.expenseIndex, modelResource()),
+      nextExpenseNumber(other.nextExpenseNumber),
+      detailsLoaded(other.detailsLoaded),
+      pendingDetails(other.pendingDetails),
+      pendingMemberKeys(other.pendingMemberKeys, modelResource()),
+      pendingPayerKeys(other.pendingPayerKeys, modelResource()),
+      pendingHostKey(other.pendingHostKey) {}
 
 TRIP::TRIP(const string &_tripID, const string &_dest, const string &_desc, int _startDay, int _startMonth,
            int _startYear, int _endDay, int _endMonth, int _endYear, const STATUS &_status,
-           const vector<EXPENSE> &_expenses, long long _totalExpense)
+           const vector<EXPENSE> &_expenses)
     : ID(_tripID),  // Use the provided ID directly
-      Destination(toUpper(_dest)),
-      Description(_desc),
+      Destination(ISTRING::internUpper(_dest)),
+      Description(_desc, modelResource()),
       startDate(_startDay, _startMonth, _startYear),
       endDate(_endDay, _endMonth, _endYear),
       status(_status),
-      expenses(_expenses),
-      totalExpense(_totalExpense) {
+      updatedAt(0),
+      version(nextModelVersion()),
+      members(modelResource()),
+      expenses(_expenses.begin(), _expenses.end(), modelResource()),
+      expenseIndex(modelResource()),
+      nextExpenseNumber(1),
+      detailsLoaded(true),
+      pendingMemberKeys(modelResource()),
+      pendingPayerKeys(modelResource()) {
+    this->rebuildExpenseIndex();
     tripCount++;
 }
 
 TRIP::TRIP(const string &_tripID, const string &_dest, const string &_desc, const DATE &_startDate,
-           const DATE &_endDate, const STATUS &_status, const vector<EXPENSE> &_expenses, long long _totalExpense)
+           const DATE &_endDate, const STATUS &_status, const vector<EXPENSE> &_expenses)
     : ID(_tripID),  // Use the provided ID directly
-      Destination(toUpper(_dest)),
-      Description(_desc),
+      Destination(ISTRING::internUpper(_dest)),
+      Description(_desc, modelResource()),
       startDate(_startDate),
       endDate(_endDate),
       status(_status),
-      expenses(_expenses),
-      totalExpense(_totalExpense) {
+      updatedAt(0),
+      version(nextModelVersion()),
+      members(modelResource()),
+      expenses(_expenses.begin(), _expenses.end(), modelResource()),
+      expenseIndex(modelResource()),
+      nextExpenseNumber(1),
+      detailsLoaded(true),
+      pendingMemberKeys(modelResource()),
+      pendingPayerKeys(modelResource()) {
+    this->rebuildExpenseIndex();
     tripCount++;
 }
 
 // FUNC: Getters
-string TRIP::getID() const { return this->ID; }
+string TRIP::getID() const { return this->ID.str(); }
 
-string TRIP::getDestination() const { return this->Destination; }
+const IDKEY &TRIP::getKey() const { return this->ID; }
 
-string TRIP::getDescription() const { return this->Description; }
+const string &TRIP::getDestination() const { return this->Destination.str(); }
+
+string TRIP::getDescription() const { return string(this->Description); }
 
 DATE TRIP::getStartDate() const { return this->startDate; }
 
@@ -82,47 +116,163 @@ string TRIP::getStatusString() const {
     }
 }
 
-vector<EXPENSE> TRIP::getAllExpenses() const { return this->expenses; }
+vector<EXPENSE> TRIP::getAllExpenses() const { return vector<EXPENSE>(this->expenses.begin(), this->expenses.end()); }
+
+const EXPENSE *TRIP::findExpense(const IDKEY &expenseID) const {
+    auto it = this->expenseIndex.find(expenseID);
+    return it == this->expenseIndex.end() ? nullptr : &this->expenses[it->second];
+}
+
+long long TRIP::getUpdatedAt() const { return this->updatedAt; }
+
+uint64_t TRIP::getVersion() const { return this->version; }
+
+long long TRIP::getTotalExpense() const { return this->expenseTotals.getTotal().amount; }
 
-long long TRIP::getTotalExpense() const { return this->totalExpense; }
+const EXPENSETOTALS &TRIP::getExpenseTotals() const { return this->expenseTotals; }
+
+// NOTE: Expenses are only stored in the trip, a member's spendings are derived from them by person in charge
+vector<EXPENSE> TRIP::getExpensesPaidBy(const IDKEY &personID) const {
+    vector<EXPENSE> paid;
+    for (const EXPENSE &expense : this->expenses) {
+        if (expense.getPICKey() == personID) {
+            paid.push_back(expense);
+        }
+    }
+    return paid;
+}
+
+long long TRIP::getTotalPaidBy(const IDKEY &personID) const { return this->expenseTotals.getPaidBy(personID).amount; }
 
 HOST TRIP::getHost() const { return this->host; }
 
-vector<MEMBER> TRIP::getMembers() const { return this->members; }
+IDKEY TRIP::getHostKey() const { return this->detailsLoaded ? this->host.getKey() : this->pendingHostKey; }
+
+vector<MEMBER> TRIP::getMembers() const { return vector<MEMBER>(this->members.begin(), this->members.end()); }
+
+// NOTE: Member IDs of the trip whether or not its details have been resolved yet
+vector<IDKEY> TRIP::getMemberKeys() const {
+    if (!this->detailsLoaded) {
+        return vector<IDKEY>(this->pendingMemberKeys.begin(), this->pendingMemberKeys.end());
+    }
+
+    vector<IDKEY> keys;
+    keys.reserve(this->members.size());
+    for (const MEMBER &member : this->members) {
+        keys.push_back(member.getKey());
+    }
+    return keys;
+}
+
+// NOTE: IDs of the people in charge of the trip's expenses, possibly with repeats
+vector<IDKEY> TRIP::getPayerKeys() const {
+    if (!this->detailsLoaded) {
+        return vector<IDKEY>(this->pendingPayerKeys.begin(), this->pendingPayerKeys.end());
+    }
+
+    vector<IDKEY> keys;
+    keys.reserve(this->expenses.size());
+    for (const EXPENSE &expense : this->expenses) {
+        keys.push_back(expense.getPICKey());
+    }
+    return keys;
+}
+
+bool TRIP::isDetailsLoaded() const { return this->detailsLoaded; }
+
+const shared_ptr<const PENDINGDETAILS> &TRIP::getPendingDetails() const { return this->pendingDetails; }
+
+pmr::memory_resource *TRIP::getResource() const { return this->Description.get_allocator().resource(); }
 
 // FUNC: Setters
-void TRIP::setID(const std::string &_ID) { this->ID = _ID; }
+void TRIP::setID(const std::string &_ID) {
+    this->ID = _ID;
+    this->touch();
+}
 
-void TRIP::setDestination(const std::string &_destination) { this->Destination = _destination; }
+void TRIP::setDestination(const std::string &_destination) {
+    this->Destination = _destination;
+    this->touch();
+}
 
-void TRIP::setDescription(const string &_description) { this->Description = _description; }
+void TRIP::setDescription(const string &_description) {
+    this->Description = _description;
+    this->touch();
+}
 
-void TRIP::setStartDate(const DATE &_startDate) { this->startDate = _startDate; }
+void TRIP::setStartDate(const DATE &_startDate) {
+    this->startDate = _startDate;
+    this->touch();
+}
 
-void TRIP::setEndDate(const DATE &_endDate) { this->endDate = _endDate; }
+void TRIP::setEndDate(const DATE &_endDate) {
+    this->endDate = _endDate;
+    this->touch();
+}
 
-void TRIP::setStatus(const STATUS &_status) { this->status = _status; }
+void TRIP::setStatus(const STATUS &_status) {
+    this->status = _status;
+    this->touch();
+}
 
-void TRIP::setTotalExpense(long long _amount) { this->totalExpense = _amount; }
+// NOTE: Change metadata, does not count as a change of its own
+void TRIP::setUpdatedAt(long long _updatedAt) { this->updatedAt = _updatedAt; }
 
 void TRIP::setExpenses(const vector<EXPENSE> &_expenses) {
-    // this->totalExpense = 0;
-    // this->expenses.clear();
-    // for (const EXPENSE &expense : _expenses) {
-    //     this->expenses.push_back(expense);
-    //     this->totalExpense += expense.getAmount();
-    // }
-    this->expenses = _expenses;
+    this->expenses.assign(_expenses.begin(), _expenses.end());
+    this->rebuildExpenseIndex();
+    this->touch();
+}
+
+// NOTE: Keep the unresolved members/host/expenses JSON until the trip is opened
+void TRIP::setPendingDetails(shared_ptr<const PENDINGDETAILS> _details) {
+    this->pendingDetails = move(_details);
+    this->detailsLoaded = false;
+    this->touch();
+}
+
+// NOTE: Totals of the expenses in the pending details, so a header-only trip can report them. Loading the details
+// replaces them with the totals of the expenses that resolved.
+void TRIP::setPendingExpenseTotals(const EXPENSETOTALS &_totals) {
+    this->expenseTotals = _totals;
+    this->touch();
+}
+
+void TRIP::setPendingMemberIDs(const vector<string> &_memberIDs) {
+    this->pendingMemberKeys.assign(_memberIDs.begin(), _memberIDs.end());
+    this->touch();
+}
+
+void TRIP::setPendingHostID(const string &_hostID) {
+    this->pendingHostKey = IDKEY(_hostID);
+    this->touch();
+}
+
+void TRIP::setPendingPayerIDs(const vector<string> &_payerIDs) {
+    this->pendingPayerKeys.assign(_payerIDs.begin(), _payerIDs.end());
+    this->touch();
+}
+
+void TRIP::markDetailsLoaded() {
+    this->pendingDetails.reset();
+    this->pendingMemberKeys.clear();
+    this->pendingMemberKeys.shrink_to_fit();
+    this->pendingPayerKeys.clear();
+    this->pendingPayerKeys.shrink_to_fit();
+    this->pendingHostKey = IDKEY();
+    this->detailsLoaded = true;
+    this->recomputeExpenseTotals();
+    this->touch();
 }
 
 // FUNC: Utility methods
 void TRIP::addMember(const MEMBER &member) {
-    auto it = find_if(members.begin(), members.end(),
-                      [&](const MEMBER &_member) { return member.getID() == _member.getID(); });
+    auto it = find_if(members.begin(), members.end(), [&](const MEMBER &_member) { return member == _member; });
 
     // Add member to trip if not exist
     if (it == members.end()) {
         members.push_back(member);
+        this->touch();
     }
 }
 
@@ -131,22 +281,183 @@ void TRIP::setMembers(const vector<MEMBER> &members) {
     // for (const MEMBER &member : members) {
     //     this->members.push_back(member);
     // }
-    this->members = members;
+    this->members.assign(members.begin(), members.end());
+    this->touch();
 }
 
-void TRIP::setHost(const HOST &_host) { this->host = _host; }
+void TRIP::setHost(const HOST &_host) {
+    this->host = _host;
+    this->touch();
+}
 
-bool TRIP::hasHost() const { return !this->host.getID().empty(); }
+bool TRIP::hasHost() const { return !this->host.getKey().empty(); }
 
-void TRIP::addExpense(const EXPENSE &expense) {
+// NOTE: Expenses without an ID get one from the trip. Adding an ID the trip already has is a no-op, so importing the
+// same file twice does not duplicate expenses.
+bool TRIP::addExpense(const EXPENSE &expense) {
     if (expense.getAmount() <= 0) {
-        return;
+        return false;
+    }
+    if (!expense.getKey().empty() && this->expenseIndex.count(expense.getKey())) {
+        return false;
+    }
+
+    EXPENSE &added = this->expenses.emplace_back(expense);
+    if (added.getKey().empty()) {
+        added.setID(this->allocateExpenseID().str());
     }
+    this->expenseIndex.emplace(added.getKey(), this->expenses.size() - 1);
+    this->expenseTotals.add(added);
+    this->touch();
+    return true;
+}
+
+bool TRIP::updateExpense(const EXPENSE &expense) {
+    auto it = this->expenseIndex.find(expense.getKey());
+    if (it == this->expenseIndex.end() || expense.getAmount() <= 0) {
+        return false;
+    }
+
+    EXPENSE &current = this->expenses[it->second];
+    this->expenseTotals.remove(current);
+    this->expenseTotals.add(expense);
+    current = expense;
+    this->touch();
+    return true;
+}
 
-    this->expenses.push_back(expense);
-    this->totalExpense += expense.getAmount();
+// NOTE: O(1): the last expense is moved into the freed slot, so expense order is not preserved
+bool TRIP::removeExpense(const IDKEY &expenseID) {
+    auto it = this->expenseIndex.find(expenseID);
+    if (it == this->expenseIndex.end()) {
+        return false;
+    }
+
+    size_t slot = it->second;
+    this->expenseTotals.remove(this->expenses[slot]);
+    this->expenseIndex.erase(it);
+
+    if (slot != this->expenses.size() - 1) {
+        this->expenses[slot] = this->expenses.back();
+        this->expenseIndex[this->expenses[slot].getKey()] = slot;
+    }
+    this->expenses.pop_back();
+    this->touch();
+    return true;
+}
+
+// NOTE: Overwrite the embedded copies of a person (trip member and expense PIC) with its current data
+bool TRIP::refreshMember(const IDKEY &previousKey, const MEMBER &member) {
+    bool changed = false;
+    bool paid = false;
+    for (MEMBER &tripMember : this->members) {
+        if (tripMember.getKey() == previousKey) {
+            tripMember = member;
+            changed = true;
+        }
+    }
+    for (EXPENSE &expense : this->expenses) {
+        if (expense.getPICKey() == previousKey) {
+            expense.setPIC(member);
+            changed = true;
+            paid = true;
+        }
+    }
+    // NOTE: The totals group expenses by payer ID
+    if (paid && previousKey != member.getKey()) {
+        this->recomputeExpenseTotals();
+    }
+    if (changed) {
+        this->touch();
+    }
+    return changed;
 }
 
+bool TRIP::refreshHost(const IDKEY &previousKey, const HOST &_host) {
+    if (this->host.getKey() != previousKey) {
+        return false;
+    }
+    this->host = _host;
+    this->touch();
+    return true;
+}
+
+// NOTE: Drop every reference to a deleted person. Expenses they paid go too, the same way loading drops expenses
+// whose person in charge no longer exists.
+bool TRIP::removePerson(const IDKEY &personID) {
+    size_t memberCount = this->members.size();
+    size_t expenseCount = this->expenses.size();
+
+    this->members.erase(remove_if(this->members.begin(), this->members.end(),
+                                  [&](const MEMBER &member) { return member.getKey() == personID; }),
+                        this->members.end());
+
+    this->expenses.erase(remove_if(this->expenses.begin(), this->expenses.end(),
+                                   [&](const EXPENSE &expense) { return expense.getPICKey() == personID; }),
+                         this->expenses.end());
+    if (expenseCount != this->expenses.size()) {
+        this->rebuildExpenseIndex();
+    }
+
+    bool hostRemoved = this->host.getKey() == personID;
+    if (hostRemoved) {
+        this->host = HOST();
+    }
+
+    bool changed = hostRemoved || memberCount != this->members.size() || expenseCount != this->expenses.size();
+    if (changed) {
+        this->touch();
+    }
+    return changed;
+}
+
+// FUNC: Expense IDs
+IDKEY TRIP::allocateExpenseID() {
+    IDKEY candidate;
+    do {
+        candidate = IDKEY("E" + to_string(this->nextExpenseNumber++));
+    } while (this->expenseIndex.count(candidate));
+    return candidate;
+}
+
+// NOTE: Reindex after a bulk change. A repeated ID keeps only its first expense, then expenses loaded without an ID
+// get one. The totals are summed again over what is kept.
+void TRIP::rebuildExpenseIndex() {
+    this->expenseIndex.clear();
+    this->expenseIndex.reserve(this->expenses.size());
+
+    size_t kept = 0;
+    for (size_t i = 0; i < this->expenses.size(); ++i) {
+        const IDKEY &id = this->expenses[i].getKey();
+        if (!id.empty() && !this->expenseIndex.emplace(id, kept).second) {
+            continue;
+        }
+        if (kept != i) {
+            this->expenses[kept] = this->expenses[i];
+        }
+        kept++;
+    }
+    this->expenses.erase(this->expenses.begin() + kept, this->expenses.end());
+
+    for (size_t i = 0; i < this->expenses.size(); ++i) {
+        if (this->expenses[i].getKey().empty()) {
+            IDKEY id = this->allocateExpenseID();
+            this->expenses[i].setID(id.str());
+            this->expenseIndex.emplace(id, i);
+        }
+    }
+    this->recomputeExpenseTotals();
+}
+
+void TRIP::recomputeExpenseTotals() {
+    this->expenseTotals.clear();
+    for (const EXPENSE &expense : this->expenses) {
+        this->expenseTotals.add(expense);
+    }
+}
+
+void TRIP::touch() { this->version = nextModelVersion(); }
+
 // Operators overloading
 TRIP &TRIP::operator=(const TRIP &other) {
     this->ID = other.ID;
@@ -155,10 +466,19 @@ TRIP &TRIP::operator=(const TRIP &other) {
     this->startDate = other.startDate;
     this->endDate = other.endDate;
     this->status = other.status;
+    this->updatedAt = other.updatedAt;
+    this->version = other.version;
     this->members = other.members;
     this->host = other.host;
     this->expenses = other.expenses;
-    this->totalExpense = other.totalExpense;
+    this->expenseTotals = other.expenseTotals;
+    this->expenseIndex = other.expenseIndex;
+    this->nextExpenseNumber = other.nextExpenseNumber;
+    this->detailsLoaded = other.detailsLoaded;
+    this->pendingDetails = other.pendingDetails;
+    this->pendingMemberKeys = other.pendingMemberKeys;
+    this->pendingPayerKeys = other.pendingPayerKeys;
+    this->pendingHostKey = other.pendingHostKey;
 
     return *this;
 }
@@ -171,8 +491,8 @@ bool TRIP::operator==(const TRIP &other) const {
 
 // FUNC: Output
 ostream &operator<<(ostream &os, const TRIP &trip) {
-    os << trip.ID << endl
-       << trip.Destination << endl
+    os << trip.ID.str() << endl
+       << trip.Destination.str() << endl
        << trip.Description << endl
        << trip.startDate << endl
        << trip.endDate << endl
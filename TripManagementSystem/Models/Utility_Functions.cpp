@@ -7,4 +7,5 @@ string toUpper(const string &str) {
     transform(res.begin(), res.end(), res.begin(), [](unsigned char c) { return toupper(c); });
 
     return res;
-}
\ No newline at end of file
+}
+
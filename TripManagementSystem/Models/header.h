@@ -4,12 +4,21 @@
 #define enl "\n"
 
 #include <algorithm>
+#include <atomic>
 #include <cctype>
+#include <cstdint>
+#include <ctime>
 #include <fstream>
 #include <iostream>
+#include <memory>
+#include <memory_resource>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 using namespace std;
@@ -20,10 +29,111 @@ class MEMBER;
 class HOST;
 class EXPENSE;
 class TRIP;
+// NOTE: Parsed details of a header-only trip, defined by the file manager that reads and writes them
+struct PENDINGDETAILS;
 
 // FUNC: toUpper
 string toUpper(const string &str);
 
+// FUNC: logDebug
+// NOTE: Diagnostic output of the models and managers at debug level, kept in the log ring of Managers/Log.h so the
+// core does not depend on Qt
+void logDebug(const string &message);
+
+// FUNC: currentUnixTime
+inline long long currentUnixTime() { return static_cast<long long>(time(nullptr)); }
+
+// FUNC: nextModelVersion
+// NOTE: Trips and people take their versions from this one counter, so a version is never handed out twice: two
+// objects with the same version are copies of the same state, and any change gives a version no earlier state had.
+inline atomic<uint64_t> modelVersionCounter{0};
+inline uint64_t nextModelVersion() { return modelVersionCounter.fetch_add(1, memory_order_relaxed) + 1; }
+
+// CLASS: ISTRING
+// Handle to a string stored once in a global intern pool. Copies are a pointer copy and equality is a pointer
+// compare; the pooled text lives for the whole program so str() never dangles.
+class ISTRING {
+   private:
+    const string *value;
+
+   public:
+    ISTRING();
+    ISTRING(const string &_str);
+    ISTRING(const char *_str);
+
+    static ISTRING internUpper(const string &_str);
+    static size_t poolSize();
+
+    const string &str() const;
+    bool empty() const;
+
+    bool operator==(const ISTRING &other) const;
+    bool operator!=(const ISTRING &other) const;
+    bool operator<(const ISTRING &other) const;
+    size_t hash() const;
+};
+
+struct ISTRING_HASH {
+    size_t operator()(const ISTRING &_str) const { return _str.hash(); }
+};
+
+// CLASS: SHAREDSTRING
+// Handle to a string kept once in a reference-counted dictionary, for free text such as expense notes. Equal texts
+// share one copy while any handle holds it, and the copy leaves the dictionary with its last handle, so edited or
+// removed notes are not kept for the rest of the program the way ISTRING text is.
+class SHAREDSTRING {
+   private:
+    shared_ptr<const string> value;
+
+   public:
+    SHAREDSTRING();
+    SHAREDSTRING(const string &_str);
+
+    static size_t dictionarySize();
+
+    const string &str() const;
+    bool empty() const;
+
+    bool operator==(const SHAREDSTRING &other) const;
+    bool operator!=(const SHAREDSTRING &other) const;
+};
+
+// CLASS: IDKEY
+// Fixed-size value type for person and trip IDs. IDs up to INLINE_CAPACITY chars are stored inline; longer legacy
+// IDs keep an interned pointer instead. The hash is computed once on construction and equality compares words.
+class IDKEY {
+   public:
+    static constexpr size_t INLINE_CAPACITY = 24;
+
+   private:
+    uint64_t words[INLINE_CAPACITY / sizeof(uint64_t)];
+    uint32_t hashValue;
+    uint32_t length;
+
+   public:
+    IDKEY();
+    IDKEY(const string &_id);
+    IDKEY(const char *_id);
+
+    // FUNC: Getters
+    string str() const;
+    size_t size() const;
+    bool empty() const;
+    bool isInline() const;
+    size_t hash() const;
+
+    // Operators overloading
+    bool operator==(const IDKEY &other) const;
+    bool operator!=(const IDKEY &other) const;
+    bool operator<(const IDKEY &other) const;
+};
+
+static_assert(std::is_trivially_copyable<IDKEY>::value, "IDKEY must stay trivially copyable");
+
+struct IDKEY_HASH {
+    size_t operator()(const IDKEY &_id) const { return _id.hash(); }
+};
+
 // CLASS: STATUS
 enum class STATUS { Planned, Ongoing, Completed, Cancelled };
 const string statusToString(STATUS status);
@@ -36,6 +146,7 @@ GENDER stringToGender(const string &genderString);
 
 // CLASS: CATEGORY
 enum class CATEGORY { Food, Drink, Gas, Accommodation, Others };
+const size_t CATEGORY_COUNT = 5;
 const string categoryToString(CATEGORY _category);
 CATEGORY stringToCategory(const string &_categoryStr);
 
@@ -68,17 +179,35 @@ class DATE {
     friend ostream &operator<<(ostream &, const DATE &);
 };
 
+// FUNC: modelResource
+// NOTE: Model strings and lists are pmr containers, built on the resource returned here: the snapshot arena while this
+// thread loads a cache (see ARENASCOPE) and the global heap otherwise. It is kept per thread, so a reader copying a
+// model during a load never allocates from the loader's arena. Assigning to a model keeps the resource it was built on.
+inline thread_local pmr::memory_resource *modelArenaResource = nullptr;
+inline pmr::memory_resource *modelResource() {
+    return modelArenaResource ? modelArenaResource : pmr::new_delete_resource();
+}
+
 // CLASS: PERSON
 class PERSON {
    protected:
-    string fullName, ID;
-    string email, phoneNumber, address;
+    pmr::string fullName;
+    IDKEY ID;
+    pmr::string email, phoneNumber, address;
     GENDER gender;
     DATE dateOfBirth;
+    // NOTE: Seconds since epoch of the last change made through a manager, 0 when unknown (older files)
+    long long updatedAt;
+    // NOTE: Bumped by every setter and kept by copies, comparing versions replaces comparing fields
+    uint64_t version;
+
+    void touch();
 
    public:
     PERSON();
     PERSON(const string &_id, const string &_fullName, const GENDER &_gender, const DATE &_dob);
+    PERSON(const PERSON &other);
+    PERSON &operator=(const PERSON &other) = default;
 
     virtual ~PERSON() = default;
     virtual string getRole() const;
@@ -87,11 +216,14 @@ class PERSON {
     // FUNC: Getters
     virtual string getFullName() const;
     virtual string getID() const;
+    const IDKEY &getKey() const;
     virtual string getEmail() const;
     virtual string getPhoneNumber() const;
     virtual string getAddress() const;
     virtual GENDER getGender() const;
     virtual DATE getDateOfBirth() const;
+    long long getUpdatedAt() const;
+    uint64_t getVersion() const;
     virtual string toString() const;
 
     // FUNC: Setters
@@ -103,6 +235,7 @@ class PERSON {
     void setDOB(const DATE &_dob);
     void setID(const string &_ID);
     void setDateOfBirth(const DATE &_dob);
+    void setUpdatedAt(long long _updatedAt);
 
     // FUNC: Utility methods
     int getAge() const;
@@ -112,12 +245,9 @@ class PERSON {
 // CLASS: MEMBER
 class MEMBER : public PERSON {
    private:
-    vector<string> joinedTripID;
-    string emergencyContact;
+    pmr::string emergencyContact;
     bool hasDriverLicense;
-    vector<string> interests;
-    long long totalSpent;
-    vector<pair<string, EXPENSE>> spendings;
+    pmr::vector<pmr::string> interests;
 
    public:
     MEMBER();
@@ -125,32 +255,17 @@ class MEMBER : public PERSON {
     MEMBER(const MEMBER &other);
 
     // FUNC: Getters
-    vector<string> getJoinedTripIDs() const;
-    string getLastJoinedTripID() const;
-    int getJoinedTripCount() const;
     string getEmergencyContact() const;
     bool getHasDriverLicense() const;
     vector<string> getInterests() const;
-    long long getTotalSpent() const;
     string getRole() const override;
     string getInfo() const override;
-    vector<pair<string, EXPENSE>> getSpendings() const;
-    vector<pair<string, EXPENSE>> getSpendingsForTrip(const string &tripID) const;
 
     // FUNC: Setters
     void setEmergencyContact(const string &_contact);
-    void setSpendings(const vector<pair<string, EXPENSE>> &_spendings);
-    void setTotalSpent(long long _totalSpent);
-    void clearSpendings();
 
     // FUNC: Utility methods
-    void addToTotalSpent(const long long _amount);
-    void addSpending(const EXPENSE &_expense, const TRIP &trip);
     void addInterest(const string &_interest);
-    void joinTrip(const string &_tripID);
-    void leaveTrip(const string &_tripID);
-    bool hasJoinedTrip(const string &_tripID);
-    void removeSpending(const string &_tripID, const EXPENSE &expenseToRemove);
 
     // Operators overloading
     MEMBER &operator=(const MEMBER &other);
@@ -160,15 +275,14 @@ class MEMBER : public PERSON {
 // CLASS: HOST
 class HOST : public PERSON {
    private:
-    vector<string> hostedTripID;
-    string emergencyContact;
+    pmr::string emergencyContact;
 
    public:
     HOST();
     HOST(const string &_id, const string &_fullName, const GENDER &_gender, const DATE &_dob);
+    HOST(const HOST &other);
 
     // FUNC: Getters
-    vector<string> getHostedTripIDs() const;
     string getEmergencyContact() const;
     string getRole() const override;
     string getInfo() const override;
@@ -176,10 +290,6 @@ class HOST : public PERSON {
     // FUNC: Setters
     void setEmergencyContact(const string &_contact);
 
-    // FUNC: Utility methods
-    bool hasHostedTrip(const string &_tripID);
-    void hostTrip(const string &_tripID);
-
     // Operators overloading
     HOST &operator=(const HOST &other);
     bool operator==(const HOST &other) const;
@@ -187,10 +297,11 @@ class HOST : public PERSON {
 
 class EXPENSE {
    private:
+    IDKEY ID;
     DATE date;
     CATEGORY category;
     long long amount;
-    string note;
+    SHAREDSTRING note;
     MEMBER personInCharge;
 
    public:
@@ -200,13 +311,17 @@ class EXPENSE {
     EXPENSE(const DATE &_date, const CATEGORY _category, long long _amount, const string &_note, const MEMBER &_member);
 
     // Getters
+    string getID() const;
+    const IDKEY &getKey() const;
     long long getAmount() const;
     CATEGORY getCategory() const;
-    string getNote() const;
+    const string &getNote() const;
     MEMBER getPIC() const;
+    const IDKEY &getPICKey() const;
     DATE getDate() const;
 
     // Setters
+    void setID(const string &_id);
     void setAmount(long long _amount);
     void setCategory(CATEGORY _category);
     void setNote(const string &_note);
@@ -222,43 +337,134 @@ class EXPENSE {
     bool operator==(const EXPENSE &other) const;
 };
 
+// CLASS: EXPENSESUM
+// Amount and number of the expenses in one group
+struct EXPENSESUM {
+    long long amount = 0;
+    size_t count = 0;
+
+    void add(long long _amount);
+    void remove(long long _amount);
+    bool operator==(const EXPENSESUM &other) const;
+};
+
+// FUNC: monthKey
+// NOTE: Months are keyed as yyyymm, so keys sort in calendar order
+int monthKey(const DATE &date);
+
+// CLASS: EXPENSETOTALS
+// Running totals of a set of expenses: overall, by category, by person in charge and by month. Adding or removing an
+// expense updates them in place instead of re-summing the set. The payer and month lists only hold the few payers and
+// months of one trip, so they are searched linearly; a group is dropped when its last expense goes.
+class EXPENSETOTALS {
+   private:
+    EXPENSESUM total;
+    EXPENSESUM byCategory[CATEGORY_COUNT];
+    pmr::vector<pair<IDKEY, EXPENSESUM>> byPayer;
+    pmr::vector<pair<int, EXPENSESUM>> byMonth;
+
+   public:
+    EXPENSETOTALS();
+    EXPENSETOTALS(const EXPENSETOTALS &other);
+    EXPENSETOTALS(EXPENSETOTALS &&other) = default;
+    EXPENSETOTALS &operator=(const EXPENSETOTALS &other) = default;
+    EXPENSETOTALS &operator=(EXPENSETOTALS &&other) = default;
+
+    // FUNC: Updates
+    void add(long long amount, CATEGORY category, const IDKEY &payer, const DATE &date);
+    void remove(long long amount, CATEGORY category, const IDKEY &payer, const DATE &date);
+    void add(const EXPENSE &expense);
+    void remove(const EXPENSE &expense);
+    void clear();
+
+    // FUNC: Queries
+    const EXPENSESUM &getTotal() const;
+    const EXPENSESUM &getByCategory(CATEGORY category) const;
+    EXPENSESUM getPaidBy(const IDKEY &payer) const;
+    const pmr::vector<pair<IDKEY, EXPENSESUM>> &getByPayer() const;
+    const pmr::vector<pair<int, EXPENSESUM>> &getByMonth() const;
+
+    bool operator==(const EXPENSETOTALS &other) const;
+};
+
 // CLASS: TRIP
 class TRIP {
    private:
     static int tripCount;
-    string ID, Destination, Description;
+    IDKEY ID;
+    ISTRING Destination;
+    pmr::string Description;
     DATE startDate, endDate;
     STATUS status;
-    vector<MEMBER> members;
+    long long updatedAt;
+    uint64_t version;
+    pmr::vector<MEMBER> members;
     HOST host;
-    vector<EXPENSE> expenses;
-    long long totalExpense;
+    pmr::vector<EXPENSE> expenses;
+    // NOTE: Kept in step with expenses by every change to them. Until the details are loaded they are the totals
+    // parsed with the header, see setPendingExpenseTotals.
+    EXPENSETOTALS expenseTotals;
+
+    // Expense IDs are unique within the trip and allocated by it; the index maps an ID to its slot in expenses
+    pmr::unordered_map<IDKEY, size_t, IDKEY_HASH> expenseIndex;
+    size_t nextExpenseNumber;
+
+    // Header-only load: members, host and expenses are kept as parsed JSON until requested. Member, payer and host IDs
+    // are also kept as keys so the manager indexes can be built without resolving the details. The details are never
+    // changed in place, so copies of the trip share them.
+    bool detailsLoaded;
+    shared_ptr<const PENDINGDETAILS> pendingDetails;
+    pmr::vector<IDKEY> pendingMemberKeys;
+    pmr::vector<IDKEY> pendingPayerKeys;
+    IDKEY pendingHostKey;
+
+    IDKEY allocateExpenseID();
+    void rebuildExpenseIndex();
+    void recomputeExpenseTotals();
+    void touch();
 
    public:
     // NOTE: Constructors
     TRIP();
     TRIP(const TRIP &other);
+    TRIP(TRIP &&other) = default;
     TRIP(const string &_tripID, const string &_dest, const string &_desc, int _startDay, int _startMonth,
          int _startYear, int _endDay, int _endMonth, int _endYear, const STATUS &_status,
-         const vector<EXPENSE> &_expenses, long long _totalExpense);
+         const vector<EXPENSE> &_expenses);
     TRIP(const string &_tripID, const string &_dest, const string &_desc, const DATE &_startDate, const DATE &_endDate,
-         const STATUS &_status, const vector<EXPENSE> &_expenses, long long _totalExpense);
+         const STATUS &_status, const vector<EXPENSE> &_expenses);
 
     // ~TRIP() { tripCount--; }
 
     // NOTE: Getters
     string getID() const;
-    string getDestination() const;
+    const IDKEY &getKey() const;
+    const string &getDestination() const;
     string getDescription() const;
     DATE getStartDate() const;
     DATE getEndDate() const;
     STATUS getStatus() const;
     string getStatusString() const;
+    long long getUpdatedAt() const;
+    uint64_t getVersion() const;
     vector<EXPENSE> getAllExpenses() const;
+    const EXPENSE *findExpense(const IDKEY &expenseID) const;
     long long getTotalExpense() const;
+    const EXPENSETOTALS &getExpenseTotals() const;
+    vector<EXPENSE> getExpensesPaidBy(const IDKEY &personID) const;
+    long long getTotalPaidBy(const IDKEY &personID) const;
 
     HOST getHost() const;
+    IDKEY getHostKey() const;
     vector<MEMBER> getMembers() const;
+    vector<IDKEY> getMemberKeys() const;
+    vector<IDKEY> getPayerKeys() const;
+
+    bool isDetailsLoaded() const;
+    // NOTE: Null once the details are loaded
+    const shared_ptr<const PENDINGDETAILS> &getPendingDetails() const;
+    // NOTE: The resource the trip's strings and lists were built on, see modelResource
+    pmr::memory_resource *getResource() const;
 
     // NOTE: Setters
     void setID(const string &_ID);
@@ -267,8 +473,14 @@ class TRIP {
     void setStartDate(const DATE &_startDate);
     void setEndDate(const DATE &_endDate);
     void setStatus(const STATUS &_status);
-    void setTotalExpense(long long _amount);
+    void setUpdatedAt(long long _updatedAt);
     void setExpenses(const vector<EXPENSE> &_expenses);
+    void setPendingDetails(shared_ptr<const PENDINGDETAILS> _details);
+    void setPendingExpenseTotals(const EXPENSETOTALS &_totals);
+    void setPendingMemberIDs(const vector<string> &_memberIDs);
+    void setPendingHostID(const string &_hostID);
+    void setPendingPayerIDs(const vector<string> &_payerIDs);
+    void markDetailsLoaded();
 
     // FUNC: Utility methods
     // People
@@ -277,10 +489,17 @@ class TRIP {
     void setHost(const HOST &_host);
     bool hasHost() const;
     // Expense
-    void addExpense(const EXPENSE &expense);
+    bool addExpense(const EXPENSE &expense);
+    bool updateExpense(const EXPENSE &expense);
+    bool removeExpense(const IDKEY &expenseID);
+    // Embedded person copies. previousKey is the ID the trip knows the person by, which an edit may have changed.
+    bool refreshMember(const IDKEY &previousKey, const MEMBER &member);
+    bool refreshHost(const IDKEY &previousKey, const HOST &_host);
+    bool removePerson(const IDKEY &personID);
 
     // Operators overloading
     TRIP &operator=(const TRIP &other);
+    TRIP &operator=(TRIP &&other) = default;
     bool operator==(const TRIP &other) const;
     friend ostream &operator<<(ostream &, const TRIP &);
 };
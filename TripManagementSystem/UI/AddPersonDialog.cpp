@@ -3,7 +3,7 @@
 #include <QGridLayout>
 #include <QMessageBox>
 
-AddPersonDialog::AddPersonDialog(QWidget *parent) : QDialog(parent) {
+AddPersonDialog::AddPersonDialog(QWidget *parent) : QDialog(parent), personManager(nullptr) {
     setupUI();
     setWindowTitle("Add New Person");
 
@@ -139,12 +139,7 @@ void AddPersonDialog::setupRoleSpecificForm() {
     interestsTextEdit->setMaximumHeight(80);
     interestsTextEdit->setPlaceholderText("Enter interests separated by commas...");
 
-    totalSpentLineEdit = new QLineEdit(this);
-    totalSpentLineEdit->setText("0.0");
-    totalSpentLineEdit->setPlaceholderText("0.0");
-
     memberLayout->addRow("Interests:", interestsTextEdit);
-    memberLayout->addRow("Total Spent:", totalSpentLineEdit);
 
     hostGroupBox = new QGroupBox("Host Information", this);
     QFormLayout *hostLayout = new QFormLayout(hostGroupBox);
@@ -180,7 +175,6 @@ void AddPersonDialog::styleComponents() {
     phoneLineEdit->setStyleSheet(lineEditStyle);
     addressLineEdit->setStyleSheet(lineEditStyle);
     emergencyContactLineEdit->setStyleSheet(lineEditStyle);
-    totalSpentLineEdit->setStyleSheet(lineEditStyle);
 
     personTypeCombo->setStyleSheet(comboBoxStyle);
     genderCombo->setStyleSheet(comboBoxStyle);
@@ -200,16 +194,6 @@ bool AddPersonDialog::validateInput() {
         return false;
     }
 
-    if (personTypeCombo->currentText() == "Member") {
-        bool ok;
-        totalSpentLineEdit->text().toDouble(&ok);
-        if (!ok) {
-            QMessageBox::warning(this, "Validation Error", "Total spent must be a valid number!");
-            totalSpentLineEdit->setFocus();
-            return false;
-        }
-    }
-
     if (phoneLineEdit->text().trimmed().toStdString().length() != 10) {
         QMessageBox::warning(this, "Validation Error", "Phone number must be exactly 10 digits!");
         phoneLineEdit->setFocus();
@@ -261,7 +245,7 @@ bool AddPersonDialog::validateNoDuplicate() {
     QDate dob = dobDateEdit->date();
     DATE currentDateOfBirth(dob.day(), dob.month(), dob.year());
 
-    vector<PERSON> people = personManager->getAllPeople();
+    PEOPLEVIEW people = personManager->getAllPeople();
 
     for (const PERSON &person : people) {
         bool samePhoneNumber = (person.getPhoneNumber() == currentPhoneNumber);
@@ -302,6 +286,9 @@ void AddPersonDialog::onFullNameChanged() {
         DATE dobObj(dob.day(), dob.month(), dob.year());
 
         string newID = PERSONFACTORY::generatePersonID(text.toStdString(), dobObj);
+        if (personManager) {
+            newID = personManager->allocatePersonID(newID);
+        }
 
         idLineEdit->setText(QString::fromStdString(newID));
     }
@@ -314,6 +301,9 @@ void AddPersonDialog::onDateOfBirthChanged() {
         DATE dobObj(dob.day(), dob.month(), dob.year());
 
         string newID = PERSONFACTORY::generatePersonID(fullName.toStdString(), dobObj);
+        if (personManager) {
+            newID = personManager->allocatePersonID(newID);
+        }
 
         idLineEdit->setText(QString::fromStdString(newID));
     }
@@ -343,9 +333,6 @@ PERSON *AddPersonDialog::getPersonData() const {
             member->addInterest(interest.trimmed().toStdString());
         }
 
-        double totalSpent = totalSpentLineEdit->text().toDouble();
-        member->addToTotalSpent(totalSpent);
-
         return member;
     } else {
         HOST *host = new HOST(id, fullName, gender, dob);
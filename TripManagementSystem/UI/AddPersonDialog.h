@@ -58,7 +58,6 @@ class AddPersonDialog : public QDialog {
 
     QGroupBox *memberGroupBox;
     QTextEdit *interestsTextEdit;
-    QLineEdit *totalSpentLineEdit;
 
     QGroupBox *hostGroupBox;
 
@@ -798,9 +798,7 @@ void AddTripDialog::acceptDialog() {
         std::string description = descriptionTextEdit->toPlainText().trimmed().toStdString();
 
         vector<EXPENSE> expenses;
-        long long totalExpense = 0;
-        _tripData = TRIPFACTORY::createTrip(destination, description, startDateObj, endDateObj, tripStatus, expenses,
-                                            totalExpense);
+        _tripData = TRIPFACTORY::createTrip(destination, description, startDateObj, endDateObj, tripStatus, expenses);
 
         if (personManager) {
             QListWidgetItem *selectedHostItem = hostsListWidget->currentItem();
@@ -810,10 +808,7 @@ void AddTripDialog::acceptDialog() {
                     HOST selectedHost = personManager->getHostByID(hostID.toStdString());
                     if (!selectedHost.getID().empty()) {
                         _tripData.setHost(selectedHost);
-                        selectedHost.hostTrip(_tripData.getID());
                     }
-
-                    personManager->updateHost(selectedHost, selectedHost);
                 }
             }
 
@@ -825,9 +820,6 @@ void AddTripDialog::acceptDialog() {
                         MEMBER selectedMember = personManager->getMemberByID(memberID.toStdString());
                         if (!selectedMember.getID().empty()) {
                             _tripData.addMember(selectedMember);
-                            selectedMember.joinTrip(_tripData.getID());
-
-                            personManager->updateMember(selectedMember, selectedMember);
                         }
                     }
                 }
@@ -0,0 +1,179 @@
+#include "AnalyticsDialog.h"
+
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QMessageBox>
+
+#include "../Managers/TripFilter.h"
+#include "../Managers/TripManager.h"
+
+using namespace std;
+
+AnalyticsDialog::AnalyticsDialog(TRIPMANAGER *tripManager, PERSONMANAGER *personManager, QWidget *parent)
+    : QDialog(parent), tripManager(tripManager), personManager(personManager) {
+    setWindowTitle("Expense Analytics");
+    setModal(true);
+    resize(1000, 700);
+
+    setupUI();
+}
+
+void AnalyticsDialog::setupUI() {
+    QVBoxLayout *mainLayout = new QVBoxLayout(this);
+    mainLayout->setSpacing(10);
+    mainLayout->setContentsMargins(15, 15, 15, 15);
+
+    QHBoxLayout *queryLayout = new QHBoxLayout();
+
+    QVBoxLayout *keyLayout = new QVBoxLayout();
+    keyLayout->addWidget(new QLabel("Group by:"));
+    groupKeyList = new QListWidget();
+    for (GROUPKEY key : allGroupKeys()) {
+        QListWidgetItem *item = new QListWidgetItem(QString::fromStdString(groupKeyName(key)));
+        item->setFlags(item->flags() | Qt::ItemIsUserCheckable);
+        item->setCheckState((key == GROUPKEY::Destination || key == GROUPKEY::Month) ? Qt::Checked : Qt::Unchecked);
+        item->setData(Qt::UserRole, static_cast<int>(key));
+        groupKeyList->addItem(item);
+    }
+    // NOTE: Keys group in list order, drag them to change it
+    groupKeyList->setDragDropMode(QAbstractItemView::InternalMove);
+    groupKeyList->setMaximumHeight(200);
+    keyLayout->addWidget(groupKeyList);
+    queryLayout->addLayout(keyLayout);
+
+    QVBoxLayout *aggregateLayout = new QVBoxLayout();
+    aggregateLayout->addWidget(new QLabel("Aggregates:"));
+    sumCheckBox = new QCheckBox("Sum");
+    sumCheckBox->setChecked(true);
+    countCheckBox = new QCheckBox("Count");
+    countCheckBox->setChecked(true);
+    avgCheckBox = new QCheckBox("Average");
+    minCheckBox = new QCheckBox("Min");
+    maxCheckBox = new QCheckBox("Max");
+    aggregateLayout->addWidget(sumCheckBox);
+    aggregateLayout->addWidget(countCheckBox);
+    aggregateLayout->addWidget(avgCheckBox);
+    aggregateLayout->addWidget(minCheckBox);
+    aggregateLayout->addWidget(maxCheckBox);
+    aggregateLayout->addWidget(new QLabel("Percentiles:"));
+    percentilesLineEdit = new QLineEdit();
+    percentilesLineEdit->setPlaceholderText("e.g. 50, 90, 99");
+    aggregateLayout->addWidget(percentilesLineEdit);
+    aggregateLayout->addStretch();
+    queryLayout->addLayout(aggregateLayout);
+    queryLayout->addStretch();
+    mainLayout->addLayout(queryLayout);
+
+    resultTable = new QTableWidget();
+    resultTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    resultTable->setSelectionBehavior(QAbstractItemView::SelectRows);
+    resultTable->setAlternatingRowColors(true);
+    resultTable->verticalHeader()->setVisible(false);
+    resultTable->horizontalHeader()->setStretchLastSection(true);
+    mainLayout->addWidget(resultTable);
+
+    QHBoxLayout *buttonLayout = new QHBoxLayout();
+    resultStatsLabel = new QLabel();
+    resultStatsLabel->setStyleSheet("QLabel { color: #7f8c8d; }");
+    buttonLayout->addWidget(resultStatsLabel);
+    buttonLayout->addStretch();
+    runButton = new QPushButton("Run");
+    runButton->setDefault(true);
+    closeButton = new QPushButton("Close");
+    buttonLayout->addWidget(runButton);
+    buttonLayout->addWidget(closeButton);
+    mainLayout->addLayout(buttonLayout);
+
+    connect(runButton, &QPushButton::clicked, this, &AnalyticsDialog::onRunClicked);
+    connect(closeButton, &QPushButton::clicked, this, &QDialog::close);
+}
+
+// NOTE: Throws on a percentile that does not parse
+ANALYTICSQUERY AnalyticsDialog::readQuery() const {
+    ANALYTICSQUERY query;
+    for (int i = 0; i < groupKeyList->count(); ++i) {
+        QListWidgetItem *item = groupKeyList->item(i);
+        if (item->checkState() == Qt::Checked) {
+            query.groupBy.push_back(static_cast<GROUPKEY>(item->data(Qt::UserRole).toInt()));
+        }
+    }
+
+    const pair<QCheckBox *, const char *> picked[] = {{sumCheckBox, "sum"},
+                                                       {countCheckBox, "count"},
+                                                       {avgCheckBox, "avg"},
+                                                       {minCheckBox, "min"},
+                                                       {maxCheckBox, "max"}};
+    for (const auto &entry : picked) {
+        if (entry.first->isChecked()) {
+            query.aggregates.push_back(parseAggregate(entry.second));
+        }
+    }
+    for (const string &percentile : splitKeywords(percentilesLineEdit->text().toStdString())) {
+        if (!percentile.empty()) {
+            query.aggregates.push_back(parseAggregate("p" + percentile));
+        }
+    }
+    return query;
+}
+
+void AnalyticsDialog::onRunClicked() {
+    ANALYTICSQUERY query;
+    try {
+        query = readQuery();
+    } catch (const runtime_error &e) {
+        QMessageBox::warning(this, "Invalid Query", QString::fromStdString(e.what()));
+        return;
+    }
+    if (query.aggregates.empty()) {
+        QMessageBox::warning(this, "Invalid Query", "Please pick at least one aggregate.");
+        return;
+    }
+
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    QElapsedTimer elapsed;
+    elapsed.start();
+    if (!projected) {
+        // NOTE: Trips are loaded header-only, the projection reads their expenses
+        tripManager->loadAllTripDetails(personManager);
+        columns = projectExpenses(tripManager->getAllTrips());
+        projected = true;
+    }
+    ANALYTICSRESULT result = runAnalytics(columns, query);
+    qint64 milliseconds = elapsed.elapsed();
+    QApplication::restoreOverrideCursor();
+
+    showResult(result, query);
+    resultStatsLabel->setText(QString("%1 groups over %2 expenses in %3 ms")
+                                  .arg(result.rows.size())
+                                  .arg(columns.size())
+                                  .arg(milliseconds));
+}
+
+void AnalyticsDialog::showResult(const ANALYTICSRESULT &result, const ANALYTICSQUERY &query) {
+    QStringList headers;
+    for (const string &name : result.keyNames) {
+        headers << QString::fromStdString(name);
+    }
+    for (const string &name : result.valueNames) {
+        headers << QString::fromStdString(name);
+    }
+
+    int keyCount = static_cast<int>(result.keyNames.size());
+    resultTable->clear();
+    resultTable->setColumnCount(headers.size());
+    resultTable->setHorizontalHeaderLabels(headers);
+    resultTable->setRowCount(static_cast<int>(result.rows.size()));
+    for (int row = 0; row < static_cast<int>(result.rows.size()); ++row) {
+        const ANALYTICSROW &values = result.rows[row];
+        for (int column = 0; column < keyCount; ++column) {
+            resultTable->setItem(row, column, new QTableWidgetItem(QString::fromStdString(values.keys[column])));
+        }
+        for (int i = 0; i < static_cast<int>(values.values.size()); ++i) {
+            QString text = QString::fromStdString(formatAggregateValue(query.aggregates[i], values.values[i]));
+            QTableWidgetItem *item = new QTableWidgetItem(text);
+            item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+            resultTable->setItem(row, keyCount + i, item);
+        }
+    }
+    resultTable->resizeColumnsToContents();
+}
@@ -0,0 +1,57 @@
+#ifndef ANALYTICSDIALOG_H
+#define ANALYTICSDIALOG_H
+
+#include <QCheckBox>
+#include <QDialog>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QLineEdit>
+#include <QListWidget>
+#include <QPushButton>
+#include <QTableWidget>
+#include <QTableWidgetItem>
+#include <QVBoxLayout>
+
+#include "../Managers/ExpenseAnalytics.h"
+
+class TRIPMANAGER;
+class PERSONMANAGER;
+
+// CLASS: AnalyticsDialog
+// Group-by queries over every expense: the keys checked in the list, in list order, and the aggregates picked
+// below it. The expenses are projected on the first run and reused while the dialog is open, it is modal so the
+// store cannot change in between.
+class AnalyticsDialog : public QDialog {
+    Q_OBJECT
+
+   public:
+    AnalyticsDialog(TRIPMANAGER *tripManager, PERSONMANAGER *personManager, QWidget *parent = nullptr);
+
+   private slots:
+    void onRunClicked();
+
+   private:
+    void setupUI();
+    ANALYTICSQUERY readQuery() const;
+    void showResult(const ANALYTICSRESULT &result, const ANALYTICSQUERY &query);
+
+    TRIPMANAGER *tripManager;
+    PERSONMANAGER *personManager;
+    EXPENSECOLUMNS columns;
+    bool projected = false;
+
+    QListWidget *groupKeyList;
+    QCheckBox *sumCheckBox;
+    QCheckBox *countCheckBox;
+    QCheckBox *avgCheckBox;
+    QCheckBox *minCheckBox;
+    QCheckBox *maxCheckBox;
+    QLineEdit *percentilesLineEdit;
+    QTableWidget *resultTable;
+    QLabel *resultStatsLabel;
+    QPushButton *runButton;
+    QPushButton *closeButton;
+};
+
+#endif
@@ -0,0 +1,184 @@
+#include "DebugPanelDialog.h"
+
+#include <QApplication>
+#include <QClipboard>
+#include <QDateTime>
+#include <sstream>
+
+using namespace std;
+
+DebugPanelDialog::DebugPanelDialog(QWidget *parent) : QDialog(parent) {
+    setWindowTitle("Debug Panel");
+    setModal(false);
+    resize(1000, 700);
+
+    refreshTimer = new QTimer(this);
+    refreshTimer->setInterval(1000);
+    connect(refreshTimer, &QTimer::timeout, this, &DebugPanelDialog::refresh);
+
+    setupUI();
+}
+
+void DebugPanelDialog::setupUI() {
+    QVBoxLayout *mainLayout = new QVBoxLayout(this);
+    mainLayout->setSpacing(10);
+    mainLayout->setContentsMargins(15, 15, 15, 15);
+
+    QHBoxLayout *toolbarLayout = new QHBoxLayout();
+    toolbarLayout->addWidget(new QLabel("Show from level:"));
+    levelComboBox = new QComboBox();
+    levelComboBox->addItems({"Debug", "Info", "Warning", "Error"});
+    levelComboBox->setCurrentIndex(static_cast<int>(LOGLEVEL::Info));
+    toolbarLayout->addWidget(levelComboBox);
+    pauseCheckBox = new QCheckBox("Pause");
+    toolbarLayout->addWidget(pauseCheckBox);
+    toolbarLayout->addStretch();
+    logStatsLabel = new QLabel();
+    logStatsLabel->setStyleSheet("QLabel { color: #7f8c8d; }");
+    toolbarLayout->addWidget(logStatsLabel);
+    mainLayout->addLayout(toolbarLayout);
+
+    QSplitter *splitter = new QSplitter(Qt::Vertical);
+
+    logTable = new QTableWidget();
+    logTable->setColumnCount(3);
+    logTable->setHorizontalHeaderLabels({"Time", "Level", "Message"});
+    logTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    logTable->setSelectionBehavior(QAbstractItemView::SelectRows);
+    logTable->setAlternatingRowColors(true);
+    logTable->verticalHeader()->setVisible(false);
+    logTable->horizontalHeader()->setStretchLastSection(true);
+    logTable->setColumnWidth(0, 100);
+    logTable->setColumnWidth(1, 80);
+    splitter->addWidget(logTable);
+
+    metricsTable = new QTableWidget();
+    metricsTable->setColumnCount(7);
+    metricsTable->setHorizontalHeaderLabels({"Metric", "Count", "Mean", "p50", "p90", "p99", "Max"});
+    metricsTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    metricsTable->setSelectionBehavior(QAbstractItemView::SelectRows);
+    metricsTable->setAlternatingRowColors(true);
+    metricsTable->verticalHeader()->setVisible(false);
+    metricsTable->setColumnWidth(0, 260);
+    splitter->addWidget(metricsTable);
+
+    mainLayout->addWidget(splitter);
+
+    QHBoxLayout *buttonLayout = new QHBoxLayout();
+    buttonLayout->addStretch();
+    copyButton = new QPushButton("Copy as JSON");
+    closeButton = new QPushButton("Close");
+    buttonLayout->addWidget(copyButton);
+    buttonLayout->addWidget(closeButton);
+    mainLayout->addLayout(buttonLayout);
+
+    connect(levelComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &DebugPanelDialog::refresh);
+    connect(copyButton, &QPushButton::clicked, this, &DebugPanelDialog::onCopyClicked);
+    connect(closeButton, &QPushButton::clicked, this, &QDialog::close);
+}
+
+// NOTE: Nothing is polled while the panel is hidden
+void DebugPanelDialog::showEvent(QShowEvent *event) {
+    QDialog::showEvent(event);
+    refresh();
+    refreshTimer->start();
+}
+
+void DebugPanelDialog::hideEvent(QHideEvent *event) {
+    refreshTimer->stop();
+    QDialog::hideEvent(event);
+}
+
+void DebugPanelDialog::refresh() {
+    if (pauseCheckBox->isChecked()) {
+        return;
+    }
+    refreshLog();
+    refreshMetrics();
+}
+
+void DebugPanelDialog::refreshLog() {
+    LOGSTATS stats = getLogStats();
+    logStatsLabel->setText(QString("%1 messages logged, %2 dropped by the rate limit")
+                               .arg(stats.recorded)
+                               .arg(stats.suppressed));
+
+    int level = levelComboBox->currentIndex();
+    if (stats.recorded == this->shownSequence && level == this->shownLevel) {
+        return;
+    }
+    this->shownSequence = stats.recorded;
+    this->shownLevel = level;
+
+    vector<LOGRECORD> records = getRecentLogRecords();
+    logTable->setRowCount(0);
+    // NOTE: Newest first, so new messages show without scrolling
+    for (auto it = records.rbegin(); it != records.rend(); ++it) {
+        if (static_cast<int>(it->level) < level) {
+            continue;
+        }
+        int row = logTable->rowCount();
+        logTable->insertRow(row);
+        QString time = QDateTime::fromMSecsSinceEpoch(it->unixMillis).toString("hh:mm:ss.zzz");
+        logTable->setItem(row, 0, new QTableWidgetItem(time));
+        logTable->setItem(row, 1, new QTableWidgetItem(QString::fromStdString(logLevelToString(it->level))));
+        logTable->setItem(row, 2, new QTableWidgetItem(QString::fromStdString(it->message)));
+        if (it->level >= LOGLEVEL::Warning) {
+            QColor color = (it->level == LOGLEVEL::Error) ? QColor("#e74c3c") : QColor("#d35400");
+            for (int column = 0; column < 3; ++column) {
+                logTable->item(row, column)->setForeground(color);
+            }
+        }
+    }
+}
+
+void DebugPanelDialog::refreshMetrics() {
+    vector<pair<string, uint64_t>> counters = getCounterValues();
+    vector<pair<string, HISTOGRAMSUMMARY>> histograms = getHistogramSummaries();
+    metricsTable->setRowCount(static_cast<int>(counters.size() + histograms.size()));
+
+    int row = 0;
+    for (const auto &counter : counters) {
+        metricsTable->setItem(row, 0, new QTableWidgetItem(QString::fromStdString(counter.first)));
+        metricsTable->setItem(row, 1, new QTableWidgetItem(QString::number(counter.second)));
+        for (int column = 2; column < 7; ++column) {
+            metricsTable->setItem(row, column, new QTableWidgetItem(""));
+        }
+        ++row;
+    }
+
+    for (const auto &entry : histograms) {
+        const HISTOGRAMSUMMARY &summary = entry.second;
+        QString name = QString::fromStdString(entry.first);
+        if (summary.sampleEvery > 1) {
+            name += QString(" (1 in %1 timed)").arg(summary.sampleEvery);
+        }
+        metricsTable->setItem(row, 0, new QTableWidgetItem(name));
+        metricsTable->setItem(row, 1, new QTableWidgetItem(QString::number(summary.count)));
+        metricsTable->setItem(row, 2, new QTableWidgetItem(formatValue(summary.mean, summary.unit)));
+        metricsTable->setItem(row, 3, new QTableWidgetItem(formatValue(summary.p50, summary.unit)));
+        metricsTable->setItem(row, 4, new QTableWidgetItem(formatValue(summary.p90, summary.unit)));
+        metricsTable->setItem(row, 5, new QTableWidgetItem(formatValue(summary.p99, summary.unit)));
+        metricsTable->setItem(row, 6, new QTableWidgetItem(formatValue(summary.max, summary.unit)));
+        ++row;
+    }
+}
+
+void DebugPanelDialog::onCopyClicked() {
+    ostringstream out;
+    writeMetricsJson(out);
+    QApplication::clipboard()->setText(QString::fromStdString(out.str()));
+}
+
+QString DebugPanelDialog::formatValue(double value, const string &unit) const {
+    if (unit == "ns") {
+        if (value >= 1e6) {
+            return QString("%1 ms").arg(value / 1e6, 0, 'f', 2);
+        }
+        if (value >= 1e3) {
+            return QString("%1 us").arg(value / 1e3, 0, 'f', 1);
+        }
+        return QString("%1 ns").arg(value, 0, 'f', 0);
+    }
+    return QString("%1 %2").arg(value, 0, 'f', 0).arg(QString::fromStdString(unit));
+}
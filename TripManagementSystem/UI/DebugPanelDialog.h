@@ -0,0 +1,58 @@
+#ifndef DEBUGPANELDIALOG_H
+#define DEBUGPANELDIALOG_H
+
+#include <QCheckBox>
+#include <QComboBox>
+#include <QDialog>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QPushButton>
+#include <QSplitter>
+#include <QTableWidget>
+#include <QTableWidgetItem>
+#include <QTimer>
+#include <QVBoxLayout>
+
+#include "../Managers/Log.h"
+#include "../Managers/Metrics.h"
+
+// CLASS: DebugPanelDialog
+// Live view of the log ring and the metrics, refreshed every second while it is shown. It only reads, so it can stay
+// open next to the main window.
+class DebugPanelDialog : public QDialog {
+    Q_OBJECT
+
+   public:
+    explicit DebugPanelDialog(QWidget *parent = nullptr);
+
+   protected:
+    void showEvent(QShowEvent *event) override;
+    void hideEvent(QHideEvent *event) override;
+
+   private slots:
+    void refresh();
+    void onCopyClicked();
+
+   private:
+    void setupUI();
+    void refreshLog();
+    void refreshMetrics();
+
+    QString formatValue(double value, const string &unit) const;
+
+    QComboBox *levelComboBox;
+    QCheckBox *pauseCheckBox;
+    QTableWidget *logTable;
+    QTableWidget *metricsTable;
+    QLabel *logStatsLabel;
+    QPushButton *copyButton;
+    QPushButton *closeButton;
+    QTimer *refreshTimer;
+
+    // NOTE: Sequence of the newest record shown, the table is only rebuilt when newer ones arrived
+    uint64_t shownSequence = 0;
+    int shownLevel = -1;
+};
+
+#endif
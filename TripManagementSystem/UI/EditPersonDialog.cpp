@@ -1,6 +1,6 @@
 #include "EditPersonDialog.h"
 
-EditPersonDialog::EditPersonDialog(PERSON* person, QWidget* parent)
+EditPersonDialog::EditPersonDialog(const PERSON* person, QWidget* parent)
     : QDialog(parent), originalPerson(person), personManager(nullptr), updatedPerson(nullptr) {
     setupUI();
     populateFields();
@@ -9,7 +9,7 @@ EditPersonDialog::EditPersonDialog(PERSON* person, QWidget* parent)
     setMinimumSize(500, 600);
 }
 
-EditPersonDialog::EditPersonDialog(PERSON* person, PERSONMANAGER* personManager, QWidget* parent)
+EditPersonDialog::EditPersonDialog(const PERSON* person, PERSONMANAGER* personManager, QWidget* parent)
     : QDialog(parent), originalPerson(person), personManager(personManager), updatedPerson(nullptr) {
     setupUI();
     populateFields();
@@ -105,11 +105,7 @@ void EditPersonDialog::setupRoleSpecificForm() {
     interestsTextEdit->setMaximumHeight(80);
     interestsTextEdit->setPlaceholderText("Enter interests separated by commas...");
 
-    totalSpentLineEdit = new QLineEdit(this);
-    totalSpentLineEdit->setPlaceholderText("0.0");
-
     memberLayout->addRow("Interests:", interestsTextEdit);
-    memberLayout->addRow("Total Spent:", totalSpentLineEdit);
 
     hostGroupBox = new QGroupBox("Host Information", this);
     QFormLayout* hostLayout = new QFormLayout(hostGroupBox);
@@ -178,7 +174,6 @@ void EditPersonDialog::styleComponents() {
     phoneLineEdit->setStyleSheet(lineEditStyle);
     addressLineEdit->setStyleSheet(lineEditStyle);
     emergencyContactLineEdit->setStyleSheet(lineEditStyle);
-    totalSpentLineEdit->setStyleSheet(lineEditStyle);
 
     genderCombo->setStyleSheet(comboBoxStyle);
 
@@ -216,8 +211,6 @@ void EditPersonDialog::populateFields() {
             }
         }
         interestsTextEdit->setPlainText(interestsText);
-
-        totalSpentLineEdit->setText(QString::number(member->getTotalSpent(), 'f', 2));
     } else if (originalPerson->getRole() == "Host") {
         const HOST* host = static_cast<const HOST*>(originalPerson);
         emergencyContactLineEdit->setText(QString::fromStdString(host->getEmergencyContact()));
@@ -241,6 +234,9 @@ void EditPersonDialog::onFullNameChanged() {
         DATE dob(dobDate.day(), dobDate.month(), dobDate.year());
 
         string newID = PERSONFACTORY::generatePersonID(fullNameLineEdit->text().trimmed().toStdString(), dob);
+        if (personManager && newID != originalPerson->getID()) {
+            newID = personManager->allocatePersonID(newID);
+        }
         idLineEdit->setText(QString::fromStdString(newID));
     }
 }
@@ -254,6 +250,9 @@ void EditPersonDialog::onDateOfBirthChanged() {
     DATE dob(dobDate.day(), dobDate.month(), dobDate.year());
 
     string newID = PERSONFACTORY::generatePersonID(fullNameLineEdit->text().trimmed().toStdString(), dob);
+    if (personManager && newID != originalPerson->getID()) {
+        newID = personManager->allocatePersonID(newID);
+    }
     idLineEdit->setText(QString::fromStdString(newID));
 }
 
@@ -264,16 +263,6 @@ bool EditPersonDialog::validateInput() {
         return false;
     }
 
-    if (personTypeCombo->currentText() == "Member") {
-        bool ok;
-        totalSpentLineEdit->text().toDouble(&ok);
-        if (!ok) {
-            QMessageBox::warning(this, "Validation Error", "Total spent must be a valid number!");
-            totalSpentLineEdit->setFocus();
-            return false;
-        }
-    }
-
     string email = emailLineEdit->text().trimmed().toStdString();
     if (!email.empty() && (email.find("@") == string::npos || email.find(".") == string::npos)) {
         QMessageBox::warning(this, "Validation Error", "Email must be a valid email address!");
@@ -311,7 +300,7 @@ bool EditPersonDialog::validateNoDuplicates() {
     string currentEmail = emailLineEdit->text().trimmed().toStdString();
     string currentPhone = phoneLineEdit->text().trimmed().toStdString();
 
-    const vector<PERSON>& allPeople = personManager->getAllPeople();
+    PEOPLEVIEW allPeople = personManager->getAllPeople();
 
     for (const PERSON& person : allPeople) {
         if (originalPerson && person.getID() == originalPerson->getID()) continue;
@@ -376,12 +365,6 @@ PERSON* EditPersonDialog::getUpdatedPerson() const {
             }
         }
 
-        bool ok;
-        double totalSpent = totalSpentLineEdit->text().toDouble(&ok);
-        if (ok && totalSpent > 0) {
-            member->addToTotalSpent(totalSpent);
-        }
-
         updatedPerson = member;
     } else {
         HOST* host = new HOST(id, fullName, gender, dob);
@@ -397,4 +380,4 @@ PERSON* EditPersonDialog::getUpdatedPerson() const {
     return updatedPerson;
 }
 
-PERSON* EditPersonDialog::getOriginalPerson() const { return originalPerson; }
\ No newline at end of file
+const PERSON* EditPersonDialog::getOriginalPerson() const { return originalPerson; }
\ No newline at end of file
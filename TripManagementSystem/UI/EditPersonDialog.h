@@ -26,10 +26,10 @@ class EditPersonDialog : public QDialog {
     Q_OBJECT
 
    public:
-    explicit EditPersonDialog(PERSON *person, QWidget *parent = nullptr);
-    explicit EditPersonDialog(PERSON *person, PERSONMANAGER *personManager, QWidget *parent = nullptr);
+    explicit EditPersonDialog(const PERSON *person, QWidget *parent = nullptr);
+    explicit EditPersonDialog(const PERSON *person, PERSONMANAGER *personManager, QWidget *parent = nullptr);
     PERSON *getUpdatedPerson() const;
-    PERSON *getOriginalPerson() const;
+    const PERSON *getOriginalPerson() const;
 
    private slots:
     void onPersonTypeChanged();
@@ -66,14 +66,13 @@ class EditPersonDialog : public QDialog {
 
     QGroupBox *memberGroupBox;
     QTextEdit *interestsTextEdit;
-    QLineEdit *totalSpentLineEdit;
 
     QGroupBox *hostGroupBox;
 
     QPushButton *saveButton;
     QPushButton *cancelButton;
 
-    PERSON *originalPerson;
+    const PERSON *originalPerson;
     PERSONMANAGER *personManager;
     mutable PERSON *updatedPerson;
 };
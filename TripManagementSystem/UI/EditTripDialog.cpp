@@ -1,8 +1,8 @@
 #include "EditTripDialog.h"
 
-EditTripDialog::EditTripDialog(TRIP &trip, QWidget *parent)
-    : QDialog(parent), originalTrip(trip), editedTrip(trip), personManager(nullptr) {
-    setWindowTitle("Edit Trip - " + QString::fromStdString(trip.getDestination()));
+EditTripDialog::EditTripDialog(shared_ptr<const TRIP> trip, QWidget *parent)
+    : QDialog(parent), originalTrip(trip), editedTrip(*trip), personManager(nullptr) {
+    setWindowTitle("Edit Trip - " + QString::fromStdString(trip->getDestination()));
     setWindowIcon(QIcon(":/icons/edit.png"));
     setModal(true);
     setMinimumSize(1300, 750);
@@ -20,6 +20,11 @@ EditTripDialog::EditTripDialog(TRIP &trip, QWidget *parent)
 
 void EditTripDialog::setPersonManager(PERSONMANAGER *manager) {
     personManager = manager;
+    if (!editedTrip.isDetailsLoaded()) {
+        loadTripDetails(editedTrip, personManager);
+        // NOTE: Copy rather than load twice, so both start from the same version
+        originalTrip = make_shared<const TRIP>(editedTrip);
+    }
     updateMembersList();
     populatePeopleSelection();
 }
@@ -262,17 +267,17 @@ void EditTripDialog::setupPeopleSelectionWidget() {
 }
 
 void EditTripDialog::populateFields() {
-    tripIDLineEdit->setText(QString::fromStdString(originalTrip.getID()));
-    destinationLineEdit->setText(QString::fromStdString(originalTrip.getDestination()));
-    descriptionTextEdit->setPlainText(QString::fromStdString(originalTrip.getDescription()));
+    tripIDLineEdit->setText(QString::fromStdString(originalTrip->getID()));
+    destinationLineEdit->setText(QString::fromStdString(originalTrip->getDestination()));
+    descriptionTextEdit->setPlainText(QString::fromStdString(originalTrip->getDescription()));
 
-    DATE startDate = originalTrip.getStartDate();
-    DATE endDate = originalTrip.getEndDate();
+    DATE startDate = originalTrip->getStartDate();
+    DATE endDate = originalTrip->getEndDate();
 
     startDateEdit->setDate(QDate(startDate.getYear(), startDate.getMonth(), startDate.getDay()));
     endDateEdit->setDate(QDate(endDate.getYear(), endDate.getMonth(), endDate.getDay()));
 
-    STATUS currentStatus = originalTrip.getStatus();
+    STATUS currentStatus = originalTrip->getStatus();
     switch (currentStatus) {
         case STATUS::Planned:
             statusComboBox->setCurrentIndex(0);
@@ -292,7 +297,7 @@ void EditTripDialog::populateFields() {
 void EditTripDialog::populatePeopleSelection() {
     if (!personManager) return;
 
-    HOST currentHost = originalTrip.getHost();
+    HOST currentHost = originalTrip->getHost();
     if (!currentHost.getID().empty()) {
         for (int i = 0; i < hostComboBox->count(); ++i) {
             if (hostComboBox->itemData(i).toString().toStdString() == currentHost.getID()) {
@@ -302,19 +307,15 @@ void EditTripDialog::populatePeopleSelection() {
         }
     }
 
-    vector<MEMBER> currentMembers = originalTrip.getMembers();
+    vector<IDKEY> currentMembers = originalTrip->getMemberKeys();
+    sort(currentMembers.begin(), currentMembers.end());
     for (int i = 0; i < membersListWidget->count(); ++i) {
         QListWidgetItem *item = membersListWidget->item(i);
         if (item) {
             QString memberID = item->data(Qt::UserRole).toString();
 
-            bool isSelected = false;
-            for (const MEMBER &member : currentMembers) {
-                if (member.getID() == memberID.toStdString()) {
-                    isSelected = true;
-                    break;
-                }
-            }
+            bool isSelected =
+                binary_search(currentMembers.begin(), currentMembers.end(), IDKEY(memberID.toStdString()));
 
             item->setData(Qt::CheckStateRole, isSelected ? Qt::Checked : Qt::Unchecked);
         }
@@ -613,5 +614,5 @@ void EditTripDialog::onStartDateChanged() {
     }
 }
 
-TRIP EditTripDialog::getUpdatedTrip() const { return editedTrip; }
-TRIP EditTripDialog::getOriginalTrip() const { return originalTrip; }
+const TRIP &EditTripDialog::getUpdatedTrip() const { return editedTrip; }
+const TRIP &EditTripDialog::getOriginalTrip() const { return *originalTrip; }
@@ -18,6 +18,7 @@
 #include <QTextEdit>
 #include <QVBoxLayout>
 #include <QVariant>
+#include <memory>
 
 #include "../Managers/PersonManager.h"
 #include "../Managers/TripFactory.h"
@@ -28,10 +29,10 @@ class EditTripDialog : public QDialog {
     Q_OBJECT
 
    public:
-    explicit EditTripDialog(TRIP &trip, QWidget *parent = nullptr);
+    explicit EditTripDialog(shared_ptr<const TRIP> trip, QWidget *parent = nullptr);
 
-    TRIP getUpdatedTrip() const;
-    TRIP getOriginalTrip() const;
+    const TRIP &getUpdatedTrip() const;
+    const TRIP &getOriginalTrip() const;
 
     void setPersonManager(PERSONMANAGER *manager);
 
@@ -56,7 +57,8 @@ class EditTripDialog : public QDialog {
     void updateSelectedCount();
     bool validatePeopleSelection();
 
-    TRIP originalTrip;
+    // NOTE: The stored trip is shared with the manager snapshot, only the edited copy is ever written
+    shared_ptr<const TRIP> originalTrip;
     TRIP editedTrip;
 
     PERSONMANAGER *personManager;
@@ -1,15 +1,17 @@
 #include "FilterTripDialog.h"
 
-#include <QDebug>
 #include <QMessageBox>
 #include <QScrollArea>
 #include <QSplitter>
 #include <QTextStream>
 #include <algorithm>
 
+#include "../Managers/Metrics.h"
+#include "../Managers/Trace.h"
+
 using namespace std;
 
-FilterTripDialog::FilterTripDialog(const std::vector<TRIP> &allTrips, QWidget *parent)
+FilterTripDialog::FilterTripDialog(const TRIPSNAPSHOT &allTrips, QWidget *parent)
     : QDialog(parent), _allTrips(allTrips), _filteredTrips(allTrips) {
     setupUI();
     setWindowTitle("🔍 Filter and Sort Trips");
@@ -119,6 +121,8 @@ void FilterTripDialog::setupDestinationFilter() {
     QFormLayout *destLayout = new QFormLayout(destinationGroup);
 
     destinationLineEdit = new QLineEdit();
+    // NOTE: Found by name by the UI benchmarks, which type into it
+    destinationLineEdit->setObjectName("destinationLineEdit");
     destinationLineEdit->setPlaceholderText("Search destinations (e.g., Paris, Tokyo)...");
     destLayout->addRow("Search:", destinationLineEdit);
 
@@ -364,15 +368,14 @@ void FilterTripDialog::setupButtons() {
 }
 
 void FilterTripDialog::applyFilters() {
-    _filteredTrips.clear();
-
-    for (const auto &trip : _allTrips) {
-        if (matchesFilters(trip)) {
-            _filteredTrips.push_back(trip);
-        }
-    }
-
-    _filteredTrips = sortTrips(_filteredTrips);
+    TRACE_SPAN("FilterTripDialog::applyFilters", "ui");
+    static METRICHISTOGRAM &filterTime = metricHistogram("ui.filter_ns");
+    METRICTIMER timer(filterTime);
+    // NOTE: Filtering and sorting only reorder pointers into the snapshot, no trip is copied
+    TRIPFILTER filter = currentFilter();
+    TRIPSORTKEY sortKey = static_cast<TRIPSORTKEY>(max(0, sortByComboBox->currentIndex()));
+    _filteredTrips = sortTrips(_allTrips.filter([&filter](const TRIP &trip) { return filter.matches(trip); }),
+                               sortKey, sortAscending->isChecked());
 
     resultsLabel->setText(QString("Found %1 trips matching criteria").arg(_filteredTrips.size()));
 
@@ -523,120 +526,38 @@ void FilterTripDialog::onPresetFilterChanged() {
 
     applyFilters();
 
-    qDebug() << "Applied preset:" << presetFiltersCombo->currentText();
+    logDebug("Applied preset: " + presetFiltersCombo->currentText().toStdString());
 }
 
-bool FilterTripDialog::matchesFilters(const TRIP &trip) const {
-    QString searchText = destinationLineEdit->text().trimmed();
-    if (!searchText.isEmpty()) {
-        QString destination = QString::fromStdString(trip.getDestination());
-        if (destinationExactMatch->isChecked()) {
-            if (destination.compare(searchText, Qt::CaseInsensitive) != 0) {
-                return false;
-            }
-        } else {
-            if (!destination.contains(searchText, Qt::CaseInsensitive)) {
-                return false;
-            }
-        }
-    }
+// NOTE: The widgets are read once here, matching a trip then only compares plain strings and dates
+TRIPFILTER FilterTripDialog::currentFilter() const {
+    auto toDate = [](const QDate &date) { return DATE(date.day(), date.month(), date.year()); };
+    TRIPFILTER filter;
 
+    filter.destinationText = destinationLineEdit->text().trimmed().toStdString();
+    filter.exactDestination = destinationExactMatch->isChecked();
     if (destinationComboBox->currentIndex() > 0) {
-        QString selectedDest = destinationComboBox->currentText();
-        QString tripDest = QString::fromStdString(trip.getDestination());
-        if (tripDest != selectedDest) {
-            return false;
-        }
+        filter.destination = destinationComboBox->currentText().toStdString();
     }
 
-    std::string statusStr = trip.getStatusString();
-    bool statusMatches = false;
-
-    if (statusPlanned->isChecked() && statusStr == "Planned") statusMatches = true;
-    if (statusOngoing->isChecked() && statusStr == "Ongoing") statusMatches = true;
-    if (statusCompleted->isChecked() && statusStr == "Completed") statusMatches = true;
-    if (statusCancelled->isChecked() && statusStr == "Cancelled") statusMatches = true;
-
-    if (!statusMatches) return false;
+    filter.statuses.clear();
+    if (statusPlanned->isChecked()) filter.statuses.push_back(STATUS::Planned);
+    if (statusOngoing->isChecked()) filter.statuses.push_back(STATUS::Ongoing);
+    if (statusCompleted->isChecked()) filter.statuses.push_back(STATUS::Completed);
+    if (statusCancelled->isChecked()) filter.statuses.push_back(STATUS::Cancelled);
 
     QString keywords = descriptionKeywords->text().trimmed();
     if (!keywords.isEmpty()) {
-        QString description = QString::fromStdString(trip.getDescription());
-        QStringList keywordList = keywords.split(',', Qt::SkipEmptyParts);
-
-        bool keywordMatches = false;
-        for (const QString &keyword : keywordList) {
-            QString trimmedKeyword = keyword.trimmed();
-            Qt::CaseSensitivity caseSensitive =
-                descriptionCaseSensitive->isChecked() ? Qt::CaseSensitive : Qt::CaseInsensitive;
-
-            if (description.contains(trimmedKeyword, caseSensitive)) {
-                keywordMatches = true;
-                break;
-            }
-        }
-
-        if (!keywordMatches) return false;
+        filter.keywords = splitKeywords(keywords.toStdString());
     }
-
-    if (enableDateFilter->isChecked()) {
-        DATE tripStartDate = trip.getStartDate();
-        DATE tripEndDate = trip.getEndDate();
-
-        QDate qTripStart(tripStartDate.getYear(), tripStartDate.getMonth(), tripStartDate.getDay());
-        QDate qTripEnd(tripEndDate.getYear(), tripEndDate.getMonth(), tripEndDate.getDay());
-
-        QDate filterStartFrom = startDateFrom->date();
-        QDate filterStartTo = startDateTo->date();
-        QDate filterEndFrom = endDateFrom->date();
-        QDate filterEndTo = endDateTo->date();
-
-        if (qTripStart < filterStartFrom || qTripStart > filterStartTo) {
-            return false;
-        }
-
-        if (qTripEnd < filterEndFrom || qTripEnd > filterEndTo) {
-            return false;
-        }
-    }
-
-    return true;
-}
-
-std::vector<TRIP> FilterTripDialog::sortTrips(std::vector<TRIP> trips) const {
-    int sortBy = sortByComboBox->currentIndex();
-    bool ascending = sortAscending->isChecked();
-
-    std::sort(trips.begin(), trips.end(), [sortBy, ascending](const TRIP &a, const TRIP &b) {
-        bool result;
-
-        switch (sortBy) {
-            case 0:
-                result = a.getStartDate() < b.getStartDate();
-                break;
-            case 1:
-                result = a.getEndDate() < b.getEndDate();
-                break;
-            case 2:
-                result = a.getDestination() < b.getDestination();
-                break;
-            case 3:
-                result = a.getID() < b.getID();
-                break;
-            case 4:
-                result = a.getStatusString() < b.getStatusString();
-                break;
-            case 5:
-                result = a.getDescription().length() < b.getDescription().length();
-                break;
-            default:
-                result = a.getStartDate() < b.getStartDate();
-        }
-
-        return ascending ? result : !result;
-    });
-
-    return trips;
+    filter.caseSensitiveKeywords = descriptionCaseSensitive->isChecked();
+
+    filter.filterDates = enableDateFilter->isChecked();
+    filter.startFrom = toDate(startDateFrom->date());
+    filter.startTo = toDate(startDateTo->date());
+    filter.endFrom = toDate(endDateFrom->date());
+    filter.endTo = toDate(endDateTo->date());
+    return filter;
 }
 
-std::vector<TRIP> FilterTripDialog::getFilteredTrips() const { return _filteredTrips; }
+TRIPSNAPSHOT FilterTripDialog::getFilteredTrips() const { return _filteredTrips; }
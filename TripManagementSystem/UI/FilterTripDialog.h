@@ -19,14 +19,16 @@
 #include <set>
 #include <vector>
 
+#include "Managers/TripFilter.h"
+#include "Managers/TripSnapshot.h"
 #include "Models/header.h"
 
 class FilterTripDialog : public QDialog {
     Q_OBJECT
 
    public:
-    explicit FilterTripDialog(const std::vector<TRIP> &allTrips, QWidget *parent = nullptr);
-    std::vector<TRIP> getFilteredTrips() const;
+    explicit FilterTripDialog(const TRIPSNAPSHOT &allTrips, QWidget *parent = nullptr);
+    TRIPSNAPSHOT getFilteredTrips() const;
 
    private slots:
     void applyAndClose();
@@ -43,11 +45,10 @@ class FilterTripDialog : public QDialog {
     void setupSortingOptions();
     void setupButtons();
 
-    bool matchesFilters(const TRIP &trip) const;
-    std::vector<TRIP> sortTrips(std::vector<TRIP> trips) const;
+    TRIPFILTER currentFilter() const;
 
-    std::vector<TRIP> _allTrips;
-    std::vector<TRIP> _filteredTrips;
+    TRIPSNAPSHOT _allTrips;
+    TRIPSNAPSHOT _filteredTrips;
 
     QGroupBox *destinationGroup;
     QGroupBox *dateGroup;
@@ -7,17 +7,38 @@
 #include <algorithm>
 
 #include "../Managers/FileManager.h"
+#include "../Managers/Log.h"
+#include "../Managers/Metrics.h"
 #include "../Managers/Observer.h"
 #include "../Managers/PersonFactory.h"
 #include "../Managers/PersonManager.h"
+#include "../Managers/Trace.h"
 #include "../Managers/TripManager.h"
 #include "../Models/header.h"
 #include "AddPersonDialog.h"
 #include "AddTripDialog.h"
+#include "AnalyticsDialog.h"
+#include "DebugPanelDialog.h"
 #include "EditTripDialog.h"
 #include "FilterTripDialog.h"
 #include "ViewTripDialog.h"
 
+bool askMergePolicy(QWidget *parent, MERGEPOLICY &policy) {
+    QStringList options;
+    for (MERGEPOLICY option : getAllMergePolicies()) {
+        options << QString::fromStdString(mergePolicyToString(option));
+    }
+
+    bool ok = false;
+    QString choice = QInputDialog::getItem(parent, "Import", "When a record with the same ID already exists:", options,
+                                           0, false, &ok);
+    if (!ok) {
+        return false;
+    }
+    policy = stringToMergePolicy(choice.toStdString());
+    return true;
+}
+
 // ========================================
 // CONSTRUCTOR & DESTRUCTOR
 // ========================================
@@ -27,6 +48,9 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent) {
     tripManager = new TRIPMANAGER();
     personManager->addObserver(this);
     tripManager->addObserver(this);
+    if (!personManager->getLoadWarning().empty()) {
+        QMessageBox::warning(nullptr, "Cache Load Error", QString::fromStdString(personManager->getLoadWarning()));
+    }
 
     setupUI();
     setupStatusBar();
@@ -36,19 +60,8 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent) {
     QRect screenGeometry = QApplication::primaryScreen()->geometry();
     move(screenGeometry.center() - rect().center());
 
-    vector<TRIP> cachedTrips;
-    loadCacheFromFile(cachedTrips);
-    if (!cachedTrips.empty()) {
-        for (const TRIP &trip : cachedTrips) {
-            try {
-                tripManager->addTrip(trip);
-            } catch (const exception &e) {
-                addDebugMessage(QString("Failed to load trip '%1': %2")
-                                    .arg(QString::fromStdString(trip.getDestination()))
-                                    .arg(e.what()));
-            }
-        }
-    }
+    loadCacheFromFile();
+    updateTripDisplay(tripManager->getAllTrips());
 
     addDebugMessage("Application initialization completed");
 }
@@ -59,7 +72,7 @@ MainWindow::~MainWindow() {
     saveCacheToFile();
 
     savePeopleDataToCache(personManager->getAllMembers(), personManager->getAllHosts(),
-                          getPeopleCacheFilePath().toStdString());
+                          getPeopleCacheFilePath());
     if (personManager) {
         personManager->removeObserver(this);
         delete personManager;
@@ -473,6 +486,17 @@ void MainWindow::setupMenuBar() {
     editMenu->addAction(deleteTripAction);
     connect(deleteTripAction, &QAction::triggered, this, &MainWindow::onDeleteTripClicked);
 
+    editMenu->addSeparator();
+    QAction *undoAction = new QAction("&Undo", this);
+    undoAction->setShortcut(QKeySequence::Undo);
+    editMenu->addAction(undoAction);
+    connect(undoAction, &QAction::triggered, this, &MainWindow::onUndoClicked);
+
+    QAction *redoAction = new QAction("&Redo", this);
+    redoAction->setShortcut(QKeySequence::Redo);
+    editMenu->addAction(redoAction);
+    connect(redoAction, &QAction::triggered, this, &MainWindow::onRedoClicked);
+
     QMenu *viewMenu = menuBar()->addMenu("&View");
     QAction *refreshAction = new QAction("&Refresh", this);
     viewMenu->addAction(refreshAction);
@@ -482,6 +506,17 @@ void MainWindow::setupMenuBar() {
     viewMenu->addAction(filterAction);
     connect(filterAction, &QAction::triggered, this, &MainWindow::onFilterTripsClicked);
 
+    QAction *analyticsAction = new QAction("Expense &Analytics", this);
+    analyticsAction->setShortcut(QKeySequence("Ctrl+Shift+A"));
+    viewMenu->addAction(analyticsAction);
+    connect(analyticsAction, &QAction::triggered, this, &MainWindow::onShowAnalyticsClicked);
+
+    viewMenu->addSeparator();
+    QAction *debugPanelAction = new QAction("&Debug Panel", this);
+    debugPanelAction->setShortcut(QKeySequence("Ctrl+Shift+D"));
+    viewMenu->addAction(debugPanelAction);
+    connect(debugPanelAction, &QAction::triggered, this, &MainWindow::onShowDebugPanelClicked);
+
     QMenu *helpMenu = menuBar()->addMenu("&Help");
     QAction *aboutAction = new QAction("&About", this);
     helpMenu->addAction(aboutAction);
@@ -492,14 +527,16 @@ void MainWindow::setupStatusBar() { statusBar()->showMessage("Ready"); }
 // ========================================
 // CACHE & DATA MANAGEMENT
 // ========================================
-void MainWindow::loadCacheFromFile(vector<TRIP> &outputTrips) {
+void MainWindow::loadCacheFromFile() {
+    TRACE_SPAN("MainWindow::loadCacheFromFile", "load");
     try {
         if (cacheFileExists()) {
-            size_t previousCount = outputTrips.size();
-
-            loadTripCacheFile(outputTrips, personManager);
-
-            size_t loadedCount = outputTrips.size() - previousCount;
+            size_t loadedCount = tripManager->loadSnapshot();
+            savedTripEpoch = tripManager->getEpoch();
+            addDebugMessage(QString("Trip snapshot arena: %1 bytes").arg(tripManager->getSnapshotBytes()));
+            if (!tripManager->validateDataIntegrity(personManager)) {
+                addDebugMessage("Trip cache has integrity problems, see debug output");
+            }
 
             if (loadedCount > 0) {
                 statusBar()->showMessage(QString("Loaded %1 trips from previous session").arg(loadedCount), 3000);
@@ -508,25 +545,29 @@ void MainWindow::loadCacheFromFile(vector<TRIP> &outputTrips) {
             }
         } else {
             statusBar()->showMessage("No previous data found - Ready for new trips", 3000);
-            outputTrips.clear();  // Ensure we start with empty list
         }
     } catch (const std::exception &e) {
         QMessageBox::warning(
             this, "Cache Load Error",
             QString("Failed to load cached trips: %1\n\nStarting with empty trip list.").arg(e.what()));
-        outputTrips.clear();  // Clear any partially loaded data
         statusBar()->showMessage("Cache load failed - Starting fresh", 3000);
     }
 }
 
 void MainWindow::saveCacheToFile() {
+    TRACE_SPAN("MainWindow::saveCacheToFile", "save");
+    if (tripManager->getEpoch() == savedTripEpoch) {
+        return;  // Nothing changed since the last write
+    }
+
     try {
         addDebugMessage("Updating cache file...");
-        std::vector<TRIP> currentTrips = tripManager->getAllTrips();
+        TRIPSNAPSHOT currentTrips = tripManager->getAllTrips();
 
         addDebugMessage(QString("Saving %1 trips to cache").arg(currentTrips.size()));
 
         updateCacheFile(currentTrips);
+        savedTripEpoch = tripManager->getEpoch();
 
         addDebugMessage("Cache file updated successfully");
 
@@ -540,7 +581,10 @@ void MainWindow::saveCacheToFile() {
 // DISPLAY UPDATE FUNCTIONS
 // ========================================
 
-void MainWindow::updateTripDisplay(vector<TRIP> trips) {
+void MainWindow::updateTripDisplay(const TRIPSNAPSHOT &trips) {
+    TRACE_SPAN("MainWindow::updateTripDisplay", "ui");
+    static METRICHISTOGRAM &refreshTime = metricHistogram("ui.refresh_ns");
+    METRICTIMER timer(refreshTime);
     if (!tripsTable) {
         return;
     }
@@ -566,17 +610,15 @@ void MainWindow::updateTripDisplay(vector<TRIP> trips) {
     updateStatusBar(trips);
 }
 
-void MainWindow::updateStatusBar(const vector<TRIP> trips) {
+void MainWindow::updateStatusBar(const TRIPSNAPSHOT &trips) {
     if (statsLabel) {
         statsLabel->setText(QString("Trips count: %1").arg(trips.size()));
     }
     statusBar()->showMessage(QString("Ready - %1 trips").arg(trips.size()));
 }
 
-void MainWindow::addDebugMessage(const QString &message) {
-    QString timestamp = QDateTime::currentDateTime().toString("hh:mm:ss");
-    Q_UNUSED(message);
-}
+// NOTE: Into the log ring at info level, see View > Debug Panel
+void MainWindow::addDebugMessage(const QString &message) { logInfo(message.toStdString()); }
 
 // ========================================
 // FILE OPERATIONS (First sidebar group)
@@ -595,18 +637,25 @@ void MainWindow::onImportTripsClicked() {
             importTripInfoFromJson(importedTrips, fileName.toStdString(), personManager);
         }
 
-        for (const TRIP &trip : importedTrips) {
-            tripManager->addTrip(trip);
+        if (importedTrips.empty()) {
+            QMessageBox::warning(this, "Import Failed", "No trips found in the file or the file format is incorrect.");
+            return;
         }
 
-        addDebugMessage(QString("Import completed. %1 trips loaded.").arg(importedTrips.size()));
-        QMessageBox::information(this, "Import Complete",
-                                 QString("Successfully imported %1 trips.").arg(importedTrips.size()));
+        MERGEPOLICY policy;
+        if (!askMergePolicy(this, policy)) {
+            return;
+        }
+
+        MERGEREPORT report = tripManager->mergeTrips(importedTrips, policy, personManager);
+
+        addDebugMessage(QString("Import completed. %1 trips read.").arg(importedTrips.size()));
+        QMessageBox::information(this, "Import Complete", QString::fromStdString(report.toString()));
     }
 }
 
 void MainWindow::onExportTripsClicked() {
-    std::vector<TRIP> currentTrips = tripManager->getAllTrips();
+    TRIPSNAPSHOT currentTrips = tripManager->getAllTrips();
 
     if (currentTrips.empty()) {
         QMessageBox::warning(this, "No Data", "No trips to export. Please import trips first.");
@@ -652,22 +701,39 @@ void MainWindow::onEditTripClicked() {
     }
 
     QString tripIdToEdit = tripsTable->item(currentRow, 0)->text();
-    vector<TRIP> allTrips = tripManager->getAllTrips();
+    tripManager->loadTripDetails(tripIdToEdit.toStdString(), personManager);
+    shared_ptr<const TRIP> selectedTrip = tripManager->shareTripById(tripIdToEdit.toStdString());
 
-    auto it = find_if(allTrips.begin(), allTrips.end(),
-                      [&](const TRIP &trip) { return trip.getID() == tripIdToEdit.toStdString(); });
-
-    if (it != allTrips.end()) {
-        EditTripDialog editDialog(*it, this);
+    if (selectedTrip) {
+        EditTripDialog editDialog(selectedTrip, this);
         editDialog.setPersonManager(personManager);
 
         if (editDialog.exec() == QDialog::Accepted) {
-            tripManager->updateTrip(editDialog.getOriginalTrip(), editDialog.getUpdatedTrip());
+            const TRIP &originalTrip = editDialog.getOriginalTrip();
+            const TRIP &updatedTrip = editDialog.getUpdatedTrip();
+            if (originalTrip.getVersion() == updatedTrip.getVersion()) {
+                statusBar()->showMessage("No changes detected.", 2000);
+                return;
+            }
+
+            tripManager->updateTrip(originalTrip, updatedTrip);
             addDebugMessage("Trip updated: " + tripIdToEdit);
         }
     }
 }
 
+void MainWindow::onUndoClicked() {
+    if (!tripManager->undo()) {
+        statusBar()->showMessage("Nothing to undo.", 2000);
+    }
+}
+
+void MainWindow::onRedoClicked() {
+    if (!tripManager->redo()) {
+        statusBar()->showMessage("Nothing to redo.", 2000);
+    }
+}
+
 void MainWindow::onDeleteTripClicked() {
     int currentRow = tripsTable->currentRow();
     if (currentRow < 0) {
@@ -704,22 +770,19 @@ void MainWindow::onViewTripDetailsClicked() {
     }
 
     QString tripIdToView = tripsTable->item(currentRow, 0)->text();
-    vector<TRIP> allTrips = tripManager->getAllTrips();
+    tripManager->loadTripDetails(tripIdToView.toStdString(), personManager);
+    shared_ptr<const TRIP> selectedTrip = tripManager->shareTripById(tripIdToView.toStdString());
 
-    auto it = find_if(allTrips.begin(), allTrips.end(),
-                      [&](const TRIP &trip) { return trip.getID() == tripIdToView.toStdString(); });
-
-    if (it != allTrips.end()) {
-        ViewTripDialog dialog(*it, personManager, this);  // Pass by reference
+    if (selectedTrip) {
+        // NOTE: The dialog keeps the shared trip as its original and works on a single copy
+        ViewTripDialog dialog(selectedTrip, personManager, this);
 
         if (dialog.exec() == QDialog::Accepted) {
-            TRIP originalTrip = dialog.getOriginalTrip();
-            TRIP updatedTrip = dialog.getUpdatedTrip();
+            const TRIP &originalTrip = dialog.getOriginalTrip();
+            const TRIP &updatedTrip = dialog.getUpdatedTrip();
 
-            bool isUpdated =
-                ((originalTrip.getAllExpenses().size() != updatedTrip.getAllExpenses().size()) ||
-                 (originalTrip.getMembers().size() != updatedTrip.getMembers().size()) ||
-                 (originalTrip.getDescription() != updatedTrip.getDescription()) || (!(originalTrip == updatedTrip)));
+            // NOTE: Every edit bumps the trip's version, so the copies differ exactly when something was changed
+            bool isUpdated = originalTrip.getVersion() != updatedTrip.getVersion();
 
             if (isUpdated) {
                 tripManager->updateTrip(originalTrip, updatedTrip);
@@ -754,11 +817,11 @@ TRIPMANAGER *MainWindow::getTripManager() const { return tripManager; }
 // ========================================
 
 void MainWindow::onFilterTripsClicked() {
-    std::vector<TRIP> allTrips = tripManager->getAllTrips();
+    TRIPSNAPSHOT allTrips = tripManager->getAllTrips();
     FilterTripDialog filterDialog(allTrips, this);
 
     if (filterDialog.exec() == QDialog::Accepted) {
-        std::vector<TRIP> filteredTrips = filterDialog.getFilteredTrips();
+        TRIPSNAPSHOT filteredTrips = filterDialog.getFilteredTrips();
         updateTripDisplay(filteredTrips);
         updateStatusBar(filteredTrips);
 
@@ -771,27 +834,31 @@ void MainWindow::onFilterTripsClicked() {
 }
 
 void MainWindow::onShowUpcomingTripsClicked() {
-    std::vector<TRIP> allTrips = tripManager->getAllTrips();
-    std::vector<TRIP> upcomingTrips;
-    for (const TRIP &trip : allTrips) {
-        if (trip.getStatusString() == "Planned") {
-            upcomingTrips.push_back(trip);
-        }
-    }
+    TRIPSNAPSHOT upcomingTrips =
+        tripManager->getAllTrips().filter([](const TRIP &trip) { return trip.getStatus() == STATUS::Planned; });
     updateTripDisplay(upcomingTrips);
 }
 
 void MainWindow::onShowCompletedTripsClicked() {
-    std::vector<TRIP> allTrips = tripManager->getAllTrips();
-    std::vector<TRIP> completedTrips;
-    for (const TRIP &trip : allTrips) {
-        if (trip.getStatusString() == "Completed") {
-            completedTrips.push_back(trip);
-        }
-    }
+    TRIPSNAPSHOT completedTrips =
+        tripManager->getAllTrips().filter([](const TRIP &trip) { return trip.getStatus() == STATUS::Completed; });
     updateTripDisplay(completedTrips);
 }
 
+void MainWindow::onShowAnalyticsClicked() {
+    AnalyticsDialog analyticsDialog(tripManager, personManager, this);
+    analyticsDialog.exec();
+}
+
+void MainWindow::onShowDebugPanelClicked() {
+    if (!debugPanel) {
+        debugPanel = new DebugPanelDialog(this);
+    }
+    debugPanel->show();
+    debugPanel->raise();
+    debugPanel->activateWindow();
+}
+
 void MainWindow::onRefreshViewClicked() {
     updateTripDisplay(tripManager->getAllTrips());
     tripsTable->clearSelection();
@@ -808,8 +875,7 @@ void MainWindow::onRefreshViewClicked() {
 void MainWindow::onTripAdded(const std::string &tripId) {
     addDebugMessage("Observer: Trip added - " + QString::fromStdString(tripId));
 
-    std::vector<TRIP> currentTrips = tripManager->getAllTrips();
-    updateTripDisplay(currentTrips);
+    updateTripDisplay(tripManager->getAllTrips());
     saveCacheToFile();
 
     statusBar()->showMessage(QString("New trip added: %1").arg(QString::fromStdString(tripId)), 3000);
@@ -818,8 +884,7 @@ void MainWindow::onTripAdded(const std::string &tripId) {
 void MainWindow::onTripRemoved(const std::string &tripId) {
     addDebugMessage("Observer: Trip removed - " + QString::fromStdString(tripId));
 
-    std::vector<TRIP> currentTrips = tripManager->getAllTrips();
-    updateTripDisplay(currentTrips);
+    updateTripDisplay(tripManager->getAllTrips());
     saveCacheToFile();
 
     statusBar()->showMessage(QString("Trip removed: %1").arg(QString::fromStdString(tripId)), 3000);
@@ -828,8 +893,7 @@ void MainWindow::onTripRemoved(const std::string &tripId) {
 void MainWindow::onTripUpdated(const std::string &tripId) {
     addDebugMessage("Observer: Trip updated - " + QString::fromStdString(tripId));
 
-    vector<TRIP> currentTrips = tripManager->getAllTrips();
-    updateTripDisplay(currentTrips);
+    updateTripDisplay(tripManager->getAllTrips());
     saveCacheToFile();
 
     statusBar()->showMessage(QString("Trip updated: %1").arg(QString::fromStdString(tripId)), 3000);
@@ -841,10 +905,56 @@ void MainWindow::onPersonAdded(const string &personID) {
 
 void MainWindow::onPersonRemoved(const string &personID) {
     addDebugMessage("Person removed: " + QString::fromStdString(personID));
+
+    // NOTE: Drop the person from the trips that reference them, then persist the trips once
+    size_t affectedTrips = tripManager->cascadePersonRemoved(personID, personManager);
+    if (affectedTrips > 0) {
+        addDebugMessage(QString("Removed references from %1 trip(s)").arg(affectedTrips));
+        updateTripDisplay(tripManager->getAllTrips());
+        saveCacheToFile();
+    }
+}
+
+void MainWindow::onPersonUpdated(const string &oldID, const string &newID) {
+    addDebugMessage("Person updated: " + QString::fromStdString(newID));
+
+    // NOTE: Trips only store person IDs on disk, refreshing the in-memory copies is enough unless the ID changed
+    size_t affectedTrips = tripManager->cascadePersonUpdated(oldID, newID, personManager);
+    if (affectedTrips > 0) {
+        updateTripDisplay(tripManager->getAllTrips());
+        if (oldID != newID) {
+            saveCacheToFile();
+        }
+    }
+}
+
+void MainWindow::onTripsMerged(const vector<string> &tripIDs) {
+    addDebugMessage(QString("Observer: %1 trips merged").arg(tripIDs.size()));
+
+    // NOTE: One refresh and one cache write for the whole batch
+    updateTripDisplay(tripManager->getAllTrips());
+    saveCacheToFile();
+
+    statusBar()->showMessage(QString("%1 trips imported or updated").arg(tripIDs.size()), 3000);
 }
 
-void MainWindow::onPersonUpdated(const string &personID) {
-    addDebugMessage("Person updated: " + QString::fromStdString(personID));
+void MainWindow::onTripsRestored() {
+    addDebugMessage("Observer: trip list restored");
+
+    updateTripDisplay(tripManager->getAllTrips());
+    saveCacheToFile();
+}
+
+void MainWindow::onPeopleMerged(const vector<string> &personIDs) {
+    addDebugMessage(QString("Observer: %1 people merged").arg(personIDs.size()));
+
+    size_t affectedTrips = 0;
+    for (const string &personID : personIDs) {
+        affectedTrips += tripManager->cascadePersonUpdated(personID, personID, personManager);
+    }
+    if (affectedTrips > 0) {
+        updateTripDisplay(tripManager->getAllTrips());
+    }
 }
 
 void MainWindow::onImportPeopleClicked() {
@@ -874,25 +984,13 @@ void MainWindow::onImportPeopleClicked() {
             return;
         }
 
-        int importCount = 0;
-
-        for (const MEMBER &member : importedMembers) {
-            if (!personManager->findMemberById(member.getID())) {
-                personManager->addMember(member);
-                importCount++;
-            }
-        }
-
-        for (const HOST &host : importedHosts) {
-            if (!personManager->findHostById(host.getID())) {
-                personManager->addHost(host);
-                importCount++;
-            }
+        MERGEPOLICY policy;
+        if (!askMergePolicy(this, policy)) {
+            return;
         }
 
-        QMessageBox::information(
-            this, "Import Successful",
-            QString("Successfully imported %1 people.").arg(importedMembers.size() + importedHosts.size()));
+        MERGEREPORT report = personManager->mergePeople(importedMembers, importedHosts, policy);
+        QMessageBox::information(this, "Import Successful", QString::fromStdString(report.toString()));
 
         addDebugMessage(QString("Imported %1 people from %2")
                             .arg(importedMembers.size() + importedHosts.size())
@@ -907,8 +1005,10 @@ void MainWindow::onImportPeopleClicked() {
 void MainWindow::onExportPeopleClicked() {
     addDebugMessage("Opening People Export dialog...");
 
-    const vector<MEMBER> &members = personManager->getAllMembers();
-    const vector<HOST> &hosts = personManager->getAllHosts();
+    // NOTE: The file dialog runs its own event loop, the snapshot keeps the exported lists fixed meanwhile
+    PEOPLESNAPSHOT people = personManager->getSnapshot();
+    const vector<MEMBER> &members = people.getMembers();
+    const vector<HOST> &hosts = people.getHosts();
 
     if (members.empty() && hosts.empty()) {
         QMessageBox::warning(this, "Export Failed", "There are no people to export.");
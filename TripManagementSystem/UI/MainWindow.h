@@ -8,6 +8,7 @@
 #include <QDateTime>
 #include <QDialog>
 #include <QDir>
+#include <QFileInfo>
 #include <QFileDialog>
 #include <QFrame>
 #include <QGridLayout>
@@ -15,6 +16,7 @@
 #include <QHBoxLayout>
 #include <QHeaderView>
 #include <QIcon>
+#include <QInputDialog>
 #include <QLabel>
 #include <QListWidget>
 #include <QMainWindow>
@@ -47,11 +49,14 @@
 #include "ManagePeopleDialog.h"
 
 void saveTripAttendeesToCache(const vector<TRIP> &trips, const string &filePath);
+// FUNC: Ask how an import should treat records that already exist, false when the user cancels
+bool askMergePolicy(QWidget *parent, MERGEPOLICY &policy);
 
 class TRIP;
 class TRIPMANAGER;
 class AddTripDialog;
 class FilterTripDialog;
+class DebugPanelDialog;
 
 class MainWindow : public QMainWindow, public OBSERVER {
     Q_OBJECT
@@ -68,7 +73,10 @@ class MainWindow : public QMainWindow, public OBSERVER {
     void onTripUpdated(const string &tripID) override;
     void onPersonAdded(const string &personID) override;
     void onPersonRemoved(const string &personID) override;
-    void onPersonUpdated(const string &personID) override;
+    void onPersonUpdated(const string &oldID, const string &newID) override;
+    void onTripsMerged(const vector<string> &tripIDs) override;
+    void onPeopleMerged(const vector<string> &personIDs) override;
+    void onTripsRestored() override;
 
    private slots:
     // File Operations
@@ -79,6 +87,8 @@ class MainWindow : public QMainWindow, public OBSERVER {
     void onAddTripClicked();
     void onEditTripClicked();
     void onDeleteTripClicked();
+    void onUndoClicked();
+    void onRedoClicked();
     void onViewTripDetailsClicked();
 
     // People Management
@@ -89,6 +99,8 @@ class MainWindow : public QMainWindow, public OBSERVER {
     void onRefreshViewClicked();
     void onShowUpcomingTripsClicked();
     void onShowCompletedTripsClicked();
+    void onShowAnalyticsClicked();
+    void onShowDebugPanelClicked();
 
     // People import/export functions
     void onImportPeopleClicked();
@@ -100,10 +112,10 @@ class MainWindow : public QMainWindow, public OBSERVER {
     void setupStatusBar();
     void setupSidebar();
     void setupMainContent();
-    void updateTripDisplay(const vector<TRIP> trips);
-    void updateStatusBar(const vector<TRIP> trips);
+    void updateTripDisplay(const TRIPSNAPSHOT &trips);
+    void updateStatusBar(const TRIPSNAPSHOT &trips);
     void addDebugMessage(const QString &message);
-    void loadCacheFromFile(vector<TRIP> &outputTrips);
+    void loadCacheFromFile();
     void saveCacheToFile();
 
     // UI Components
@@ -154,10 +166,14 @@ class MainWindow : public QMainWindow, public OBSERVER {
     QLabel *statusLabel;
     QLabel *tripCountLabel;
     QProgressBar *progressBar;
+    // NOTE: Created when first opened, then kept so it can be shown again
+    DebugPanelDialog *debugPanel = nullptr;
 
     // Data
     PERSONMANAGER *personManager;
     TRIPMANAGER *tripManager;
+    // NOTE: Trip manager epoch the cache file was last written at, the cache is only rewritten when it moved on
+    uint64_t savedTripEpoch = 0;
 
     // Helper function to get project path (relative to executable)
     QString getProjectPath() const {
@@ -10,8 +10,6 @@ ManagePeopleDialog::ManagePeopleDialog(PERSONMANAGER *personManager, QWidget *pa
     setModal(true);
     setMinimumSize(900, 600);
 
-    updatePeopleData();
-
     setupUI();
     styleComponents();
     refreshPersonList();
@@ -20,79 +18,19 @@ ManagePeopleDialog::ManagePeopleDialog(PERSONMANAGER *personManager, QWidget *pa
     move(screenGeometry.center() - rect().center());
 }
 
-void ManagePeopleDialog::updatePeopleData() {
-    try {
-        QWidget *parentWidget = this->parentWidget();
-        MainWindow *mainWindow = qobject_cast<MainWindow *>(parentWidget);
-
-        if (!mainWindow) {
-            QWidget *topLevel = parentWidget;
-            while (topLevel && !qobject_cast<MainWindow *>(topLevel)) {
-                topLevel = topLevel->parentWidget();
-            }
-            mainWindow = qobject_cast<MainWindow *>(topLevel);
-        }
-
-        if (!mainWindow) {
-            return;
-        }
-
-        TRIPMANAGER *tripManager = mainWindow->getTripManager();
-        if (!tripManager) {
-            return;
-        }
-
-        vector<TRIP> currentTrips = tripManager->getAllTrips();
-
-        vector<MEMBER> allMembers = personManager->getAllMembers();
-        for (MEMBER &member : allMembers) {
-            member.clearSpendings();
-            member.setTotalSpent(0);
-
-            for (const TRIP &trip : currentTrips) {
-                vector<MEMBER> tripMembers = trip.getMembers();
-                bool isMemberInTrip = false;
-
-                for (const MEMBER &tripMember : tripMembers) {
-                    if (tripMember.getID() == member.getID()) {
-                        isMemberInTrip = true;
-                        break;
-                    }
-                }
-
-                if (isMemberInTrip) {
-                    vector<EXPENSE> tripExpenses = trip.getAllExpenses();
-                    for (const EXPENSE &expense : tripExpenses) {
-                        if (expense.getPIC().getID() == member.getID()) {
-                            member.addSpending(expense, trip);
-                        }
-                    }
-                }
-            }
-
-            MEMBER originalMember = personManager->getMemberByID(member.getID());
-            personManager->updateMember(originalMember, member);
-        }
-
-        vector<HOST> allHosts = personManager->getAllHosts();
-        for (HOST &host : allHosts) {
-            host.getHostedTripIDs().clear();
-
-            for (const TRIP &trip : currentTrips) {
-                if (trip.getHost().getID() == host.getID()) {
-                    host.hostTrip(trip.getID());
-                }
-            }
+TRIPMANAGER *ManagePeopleDialog::findTripManager() const {
+    QWidget *parentWidget = this->parentWidget();
+    MainWindow *mainWindow = qobject_cast<MainWindow *>(parentWidget);
 
-            HOST originalHost = personManager->getHostByID(host.getID());
-            personManager->updateHost(originalHost, host);
+    if (!mainWindow) {
+        QWidget *topLevel = parentWidget;
+        while (topLevel && !qobject_cast<MainWindow *>(topLevel)) {
+            topLevel = topLevel->parentWidget();
         }
-
-    } catch (const std::exception &e) {
-        QMessageBox::warning(
-            this, "Data Update Warning",
-            QString("Could not fully update people data: %1\n\nDialog will show current data.").arg(e.what()));
+        mainWindow = qobject_cast<MainWindow *>(topLevel);
     }
+
+    return mainWindow ? mainWindow->getTripManager() : nullptr;
 }
 
 void ManagePeopleDialog::setupUI() {
@@ -479,7 +417,7 @@ void ManagePeopleDialog::updatePersonInfo() {
     QListWidgetItem *currentItem = peopleListWidget->currentItem();
     if (currentItem) {
         QString personId = currentItem->data(Qt::UserRole).toString();
-        PERSON *person = personManager->findPersonById(personId.toStdString());
+        const PERSON *person = personManager->findPersonById(personId.toStdString());
 
         if (person) {
             QString info = QString(
@@ -530,7 +468,7 @@ void ManagePeopleDialog::onEditPersonClicked() {
     }
 
     QString personId = currentItem->data(Qt::UserRole).toString();
-    PERSON *person = personManager->findPersonById(personId.toStdString());
+    const PERSON *person = personManager->findPersonById(personId.toStdString());
 
     if (!person) {
         QMessageBox::warning(this, "Error", "Selected person not found.");
@@ -561,7 +499,7 @@ void ManagePeopleDialog::onDeletePersonClicked() {
     }
 
     QString personId = currentItem->data(Qt::UserRole).toString();
-    PERSON *person = personManager->findPersonById(personId.toStdString());
+    const PERSON *person = personManager->findPersonById(personId.toStdString());
 
     if (person) {
         int ret = QMessageBox::question(
@@ -588,14 +526,14 @@ void ManagePeopleDialog::onViewPersonClicked() {
     }
 
     QString personId = currentItem->data(Qt::UserRole).toString();
-    PERSON *person = personManager->findPersonById(personId.toStdString());
+    const PERSON *person = personManager->findPersonById(personId.toStdString());
 
     if (person) {
         showPersonDetailDialog(person);
     }
 }
 
-void ManagePeopleDialog::showPersonDetailDialog(PERSON *person) {
+void ManagePeopleDialog::showPersonDetailDialog(const PERSON *person) {
     QDialog *detailDialog = new QDialog(this);
     detailDialog->setWindowTitle(QString("👤 %1 - Details").arg(QString::fromStdString(person->getFullName())));
     detailDialog->setModal(true);
@@ -696,8 +634,8 @@ void ManagePeopleDialog::showPersonDetailDialog(PERSON *person) {
 
     mainLayout->addWidget(personalGroup);
 
-    MEMBER *member = dynamic_cast<MEMBER *>(person);
-    HOST *host = dynamic_cast<HOST *>(person);
+    const MEMBER *member = dynamic_cast<const MEMBER *>(person);
+    const HOST *host = dynamic_cast<const HOST *>(person);
 
     if (member) {
         QGroupBox *spendingGroup = new QGroupBox("💰 Spending Information");
@@ -707,7 +645,13 @@ void ManagePeopleDialog::showPersonDetailDialog(PERSON *person) {
         spendingLayout->setContentsMargins(15, 20, 15, 15);
         spendingLayout->setSpacing(10);
 
-        long long totalSpent = member->getTotalSpent();
+        // NOTE: Spendings are derived from the trip expenses this member is in charge of
+        vector<pair<string, EXPENSE>> spendings;
+        long long totalSpent = 0;
+        if (TRIPMANAGER *tripManager = findTripManager()) {
+            spendings = tripManager->getSpendingsOfMember(member->getID(), personManager);
+            totalSpent = tripManager->getExpenseTotalOfMember(member->getID()).amount;
+        }
         QLabel *totalLabel = new QLabel(QString("💵 Total Spent: %1").arg(formatCurrency(totalSpent)));
         totalLabel->setFixedHeight(50);
         totalLabel->setStyleSheet(
@@ -756,8 +700,6 @@ void ManagePeopleDialog::showPersonDetailDialog(PERSON *person) {
             "    min-height: 25px;"
             "}");
 
-        vector<pair<string, EXPENSE>> spendings = member->getSpendings();
-
         spendingTable->setRowCount(spendings.size());
 
         for (size_t i = 0; i < spendings.size(); ++i) {
@@ -795,9 +737,18 @@ void ManagePeopleDialog::showPersonDetailDialog(PERSON *person) {
         tripLayout->setContentsMargins(15, 20, 15, 15);
         tripLayout->setSpacing(10);
 
-        vector<string> hostedTripIDs = host->getHostedTripIDs();
+        // NOTE: Hosted trips come from the host reverse index, no scan over all trips
+        vector<TRIP> hostedTrips;
+        if (TRIPMANAGER *tripManager = findTripManager()) {
+            for (const IDKEY &tripKey : tripManager->getTripKeysOfHost(host->getID())) {
+                const TRIP *trip = tripManager->findTripById(tripKey.str());
+                if (trip) {
+                    hostedTrips.push_back(*trip);
+                }
+            }
+        }
 
-        QLabel *totalLabel = new QLabel(QString("🎯 Total Hosted Trips: %1").arg(hostedTripIDs.size()));
+        QLabel *totalLabel = new QLabel(QString("🎯 Total Hosted Trips: %1").arg(hostedTrips.size()));
         totalLabel->setFixedHeight(50);
         totalLabel->setStyleSheet(
             "QLabel { "
@@ -845,32 +796,6 @@ void ManagePeopleDialog::showPersonDetailDialog(PERSON *person) {
             "    min-height: 25px;"
             "}");
 
-        QWidget *parentWidget = this->parentWidget();
-        MainWindow *mainWindow = qobject_cast<MainWindow *>(parentWidget);
-
-        if (!mainWindow) {
-            QWidget *topLevel = parentWidget;
-            while (topLevel && !qobject_cast<MainWindow *>(topLevel)) {
-                topLevel = topLevel->parentWidget();
-            }
-            mainWindow = qobject_cast<MainWindow *>(topLevel);
-        }
-
-        vector<TRIP> hostedTrips;
-        if (mainWindow && mainWindow->getTripManager()) {
-            TRIPMANAGER *tripManager = mainWindow->getTripManager();
-            vector<TRIP> allTrips = tripManager->getAllTrips();
-
-            for (const TRIP &trip : allTrips) {
-                for (const string &tripId : hostedTripIDs) {
-                    if (trip.getID() == tripId) {
-                        hostedTrips.push_back(trip);
-                        break;
-                    }
-                }
-            }
-        }
-
         tripsTable->setRowCount(hostedTrips.size());
 
         for (size_t i = 0; i < hostedTrips.size(); ++i) {
@@ -977,26 +902,15 @@ void ManagePeopleDialog::onImportPeopleClicked() {
             return;
         }
 
-        int importCount = 0;
-
-        for (const MEMBER &member : importedMembers) {
-            if (!personManager->findMemberById(member.getID())) {
-                personManager->addMember(member);
-                importCount++;
-            }
-        }
-
-        for (const HOST &host : importedHosts) {
-            if (!personManager->findHostById(host.getID())) {
-                personManager->addHost(host);
-                importCount++;
-            }
+        MERGEPOLICY policy;
+        if (!askMergePolicy(this, policy)) {
+            return;
         }
 
+        MERGEREPORT report = personManager->mergePeople(importedMembers, importedHosts, policy);
         refreshPersonList();
 
-        QMessageBox::information(this, "Import Successful",
-                                 QString("Successfully imported %1 people.").arg(importCount));
+        QMessageBox::information(this, "Import Successful", QString::fromStdString(report.toString()));
 
     } catch (const std::exception &e) {
         QMessageBox::critical(this, "Import Error", QString("An error occurred during import: %1").arg(e.what()));
@@ -7,7 +7,9 @@
 #include <QDate>
 #include <QDateEdit>
 #include <QDialog>
+#include <QDir>
 #include <QFileDialog>
+#include <QFileInfo>
 #include <QFormLayout>
 #include <QFrame>
 #include <QGridLayout>
@@ -54,12 +56,12 @@ class ManagePeopleDialog : public QDialog {
     void onExportPeopleClicked();
 
    private:
-    void updatePeopleData();
+    TRIPMANAGER* findTripManager() const;
     void setupUI();
     void styleComponents();
     void refreshPersonList();
     void updatePersonInfo();
-    void showPersonDetailDialog(PERSON* person);
+    void showPersonDetailDialog(const PERSON* person);
     QString formatCurrency(long long amount);
 
     PERSONMANAGER* personManager;
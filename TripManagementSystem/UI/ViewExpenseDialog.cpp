@@ -8,6 +8,11 @@ ViewExpenseDialog::ViewExpenseDialog(TRIP &trip, PERSONMANAGER *personManager, Q
       expensesChanged(false),
       personManager(personManager),
       totalAmount(0) {
+    if (!trip.isDetailsLoaded()) {
+        loadTripDetails(trip, personManager);
+        expenses = trip.getAllExpenses();
+    }
+
     setWindowTitle(QString("View Expenses - %1").arg(tripName));
     setModal(true);
     setMinimumSize(900, 700);
@@ -175,6 +180,7 @@ void ViewExpenseDialog::populateExpenseTable() {
         const EXPENSE &expense = expenses[i];
 
         QTableWidgetItem *dateItem = new QTableWidgetItem(formatDate(expense.getDate()));
+        dateItem->setData(Qt::UserRole, QString::fromStdString(expense.getID()));
         expenseTable->setItem(static_cast<int>(i), 0, dateItem);
 
         QTableWidgetItem *categoryItem = new QTableWidgetItem(formatCategory(expense.getCategory()));
@@ -196,10 +202,8 @@ void ViewExpenseDialog::populateExpenseTable() {
 }
 
 void ViewExpenseDialog::updateTotalAmount() {
-    totalAmount = 0;
-    for (const EXPENSE &expense : expenses) {
-        totalAmount += expense.getAmount();
-    }
+    // NOTE: The trip keeps its totals up to date with every expense change
+    totalAmount = trip.getTotalExpense();
 
     totalExpenseLabel->setText(QString("Total: %1").arg(formatCurrency(totalAmount)));
     expenseCountLabel->setText(QString("%1 expense(s)").arg(expenses.size()));
@@ -216,7 +220,14 @@ void ViewExpenseDialog::onDeleteExpense() {
         return;
     }
 
-    const EXPENSE &expenseToDelete = expenses[currentRow];
+    // NOTE: The table is sortable, so the row is resolved through the expense ID it carries, not its position
+    QTableWidgetItem *idItem = expenseTable->item(currentRow, 0);
+    IDKEY expenseID(idItem ? idItem->data(Qt::UserRole).toString().toStdString() : string());
+    const EXPENSE *found = trip.findExpense(expenseID);
+    if (!found) {
+        return;
+    }
+    const EXPENSE expenseToDelete = *found;
 
     QMessageBox msgBox(this);
     msgBox.setWindowTitle("⚠️ Confirm Deletion");
@@ -238,39 +249,12 @@ void ViewExpenseDialog::onDeleteExpense() {
 
     if (msgBox.exec() == QMessageBox::Yes) {
         try {
-            long long expenseAmount = expenseToDelete.getAmount();
-            string memberID = expenseToDelete.getPIC().getID();
-            string tripID = trip.getID();
-
-            string expenseDateStr = expenseToDelete.getDate().toString();
-            CATEGORY expenseCategory = expenseToDelete.getCategory();
-
-            removeExpenseAt(currentRow);
-            expensesChanged = true;
-            trip.setExpenses(expenses);
-
-            vector<MEMBER> tripMembers = trip.getMembers();
-            bool memberFound = false;
-
-            for (size_t i = 0; i < tripMembers.size(); ++i) {
-                if (tripMembers[i].getID() == memberID) {
-                    memberFound = true;
-                    tripMembers[i].removeSpending(tripID, expenseToDelete);
-                    personManager->updateMember(tripMembers[i], tripMembers[i]);
-                    break;
-                }
-            }
-
-            if (!memberFound) {
-                qDebug() << "Warning: Member with ID" << QString::fromStdString(memberID)
-                         << "not found in trip members.";
-            }
-
-            trip.setMembers(tripMembers);
-
-            if (personManager) {
-                updatePeopleCacheFile(personManager->getAllMembers(), personManager->getAllHosts());
+            // NOTE: Member spendings are derived from the trip's expenses, nothing else to reconcile
+            if (!trip.removeExpense(expenseID)) {
+                throw runtime_error("Expense " + expenseID.str() + " is no longer in this trip");
             }
+            expensesChanged = true;
+            expenses = trip.getAllExpenses();
 
             populateExpenseTable();
             updateTotalAmount();
@@ -299,12 +283,6 @@ void ViewExpenseDialog::onRefreshView() {
 
 void ViewExpenseDialog::onExpenseSelectionChanged() { updateButtonStates(); }
 
-void ViewExpenseDialog::removeExpenseAt(int index) {
-    if (index >= 0 && index < static_cast<int>(expenses.size())) {
-        expenses.erase(expenses.begin() + index);
-    }
-}
-
 QString ViewExpenseDialog::formatCurrency(long long amount) const {
     QString amountStr = QString::number(amount);
     QString formatted;
@@ -47,7 +47,6 @@ class ViewExpenseDialog : public QDialog {
     void updateTotalAmount();
     void updateButtonStates();
 
-    void removeExpenseAt(int index);
     QString formatCurrency(long long amount) const;
     QString formatDate(const DATE &date) const;
     QString formatCategory(CATEGORY category) const;
@@ -1,7 +1,12 @@
 #include "ViewTripDialog.h"
 
-ViewTripDialog::ViewTripDialog(TRIP &_trip, PERSONMANAGER *personManager, QWidget *parent)
-    : QDialog(parent), trip(_trip), originalTrip(_trip), personManager(personManager) {
+ViewTripDialog::ViewTripDialog(shared_ptr<const TRIP> _trip, PERSONMANAGER *personManager, QWidget *parent)
+    : QDialog(parent), trip(*_trip), originalTrip(_trip), personManager(personManager) {
+    if (!trip.isDetailsLoaded()) {
+        loadTripDetails(trip, personManager);
+        originalTrip = make_shared<const TRIP>(trip);
+    }
+
     setWindowTitle("View Trip Details - " + QString::fromStdString(trip.getDestination()));
     setWindowIcon(QIcon(":/icons/view.png"));
     setModal(true);
@@ -529,24 +534,10 @@ void ViewTripDialog::displayCurrentTrip() {
 }
 
 void ViewTripDialog::displayPeopleInfo() {
-    qDebug() << "=== displayPeopleInfo() ===";
-    qDebug() << "PersonManager available:" << (personManager != nullptr);
-
     HOST host = trip.getHost();
-    qDebug() << "Trip host ID:" << QString::fromStdString(host.getID());
-    qDebug() << "Host name:" << QString::fromStdString(host.getFullName());
 
+    // NOTE: Person updates and deletes cascade into the trips, so the embedded copies are current
     if (!host.getID().empty()) {
-        if (personManager) {
-            HOST freshHost = personManager->getHostByID(host.getID());
-            if (!freshHost.getID().empty()) {
-                host = freshHost;
-                qDebug() << "Using fresh host data from PersonManager";
-            } else {
-                qDebug() << "Host not found in PersonManager, using trip data";
-            }
-        }
-
         hostLabel->setText(QString::fromStdString(host.getID()));
         hostNameLabel->setText(QString::fromStdString(host.getFullName()));
         hostEmailLabel->setText(QString::fromStdString(host.getEmail()));
@@ -561,25 +552,8 @@ void ViewTripDialog::displayPeopleInfo() {
     }
 
     vector<MEMBER> members = trip.getMembers();
-    qDebug() << "Trip has" << members.size() << "members";
-
-    if (personManager && !members.empty()) {
-        vector<MEMBER> freshMembers;
-        for (const MEMBER &member : members) {
-            if (!member.getID().empty()) {
-                MEMBER freshMember = personManager->getMemberByID(member.getID());
-                if (!freshMember.getID().empty()) {
-                    freshMembers.push_back(freshMember);
-                    qDebug() << "Updated member:" << QString::fromStdString(freshMember.getFullName());
-                } else {
-                    freshMembers.push_back(member);
-                    qDebug() << "Member not found in PersonManager, keeping original:"
-                             << QString::fromStdString(member.getFullName());
-                }
-            }
-        }
-        members = freshMembers;
-    }
+    logDebug("Showing trip " + trip.getID() + ": host " + (host.getID().empty() ? "none" : host.getID()) + ", " +
+             to_string(members.size()) + " members");
 
     membersCountLabel->setText(QString("Total Member(s): %1").arg(members.size()));
 
@@ -602,8 +576,6 @@ void ViewTripDialog::displayPeopleInfo() {
         }
         membersInfoButton->setEnabled(true);
     }
-
-    qDebug() << "=== displayPeopleInfo() completed ===";
 }
 
 void ViewTripDialog::onHostInfoClicked() {
@@ -823,13 +795,7 @@ void ViewTripDialog::onMemberInfoClicked() {
             QLabel *phoneLabel = new QLabel(QString::fromStdString(member.getPhoneNumber()));
             QLabel *genderLabel = new QLabel(QString::fromStdString(genderToString(member.getGender())));
 
-            vector<pair<string, EXPENSE>> memberSpendings = member.getSpendingsForTrip(trip.getID());
-            long long totalSpent = 0;
-            for (size_t i = 0; i < memberSpendings.size(); i++) {
-                if (memberSpendings[i].first == trip.getID()) {
-                    totalSpent += memberSpendings[i].second.getAmount();
-                }
-            }
+            long long totalSpent = trip.getTotalPaidBy(member.getKey());
 
             QLabel *spentLabel = new QLabel(QString("%1").arg(formatCurrency(totalSpent)));
 
@@ -936,7 +902,7 @@ void ViewTripDialog::onMemberInfoClicked() {
 }
 
 void ViewTripDialog::editCurrentTrip() {
-    EditTripDialog editDialog(trip, this);
+    EditTripDialog editDialog(make_shared<const TRIP>(trip), this);
     editDialog.setPersonManager(personManager);
     if (editDialog.exec() == QDialog::Accepted) {
         trip = editDialog.getUpdatedTrip();
@@ -963,39 +929,9 @@ void ViewTripDialog::onAddExpenseClicked() {
     if (dialog.exec() == QDialog::Accepted) {
         EXPENSE newExpense = dialog.getExpense();
 
+        // NOTE: The trip is the only store for expenses, member spendings are derived from it
         trip.addExpense(newExpense);
 
-        MEMBER memberInCharge = newExpense.getPIC();
-        if (personManager) {
-            MEMBER freshMember = personManager->getMemberByID(memberInCharge.getID());
-            if (!freshMember.getID().empty()) {
-                freshMember.addSpending(newExpense, trip);
-                personManager->updateMember(memberInCharge, freshMember);
-
-                vector<MEMBER> tripMembers = trip.getMembers();
-
-                for (size_t i = 0; i < tripMembers.size(); i++) {
-                    if (tripMembers[i].getID() == freshMember.getID()) {
-                        tripMembers[i] = freshMember;
-                        break;
-                    }
-                }
-
-                trip.setMembers(tripMembers);
-
-                updatePeopleCacheFile(personManager->getAllMembers(), personManager->getAllHosts());
-            }
-        } else {
-            vector<MEMBER> tripMembers = trip.getMembers();
-            for (size_t i = 0; i < tripMembers.size(); i++) {
-                if (tripMembers[i].getID() == memberInCharge.getID()) {
-                    tripMembers[i].addSpending(newExpense, trip);
-                    break;
-                }
-            }
-            trip.setMembers(tripMembers);
-        }
-
         updateExpenseDisplay();
         displayCurrentTrip();
         displayPeopleInfo();
@@ -1004,9 +940,9 @@ void ViewTripDialog::onAddExpenseClicked() {
 
 void ViewTripDialog::closeView() { accept(); }
 
-TRIP ViewTripDialog::getUpdatedTrip() const { return trip; }
+const TRIP &ViewTripDialog::getUpdatedTrip() const { return trip; }
 
-TRIP ViewTripDialog::getOriginalTrip() const { return originalTrip; }
+const TRIP &ViewTripDialog::getOriginalTrip() const { return *originalTrip; }
 
 void ViewTripDialog::updateExpenseDisplay() {
     expenseListWidget->clear();
@@ -1102,10 +1038,7 @@ void ViewTripDialog::updateExpenseDisplay() {
         }
     }
 
-    long long totalExpenses = 0;
-    for (const EXPENSE &expense : expenses) {
-        totalExpenses += expense.getAmount();
-    }
+    long long totalExpenses = trip.getTotalExpense();
 
     QString formattedTotal = formatCurrency(totalExpenses);
     QString totalIcon = "💰";
@@ -32,10 +32,10 @@ class ViewTripDialog : public QDialog {
     Q_OBJECT
 
    public:
-    explicit ViewTripDialog(TRIP &_trip, PERSONMANAGER *personManager, QWidget *parent = nullptr);
+    explicit ViewTripDialog(shared_ptr<const TRIP> _trip, PERSONMANAGER *personManager, QWidget *parent = nullptr);
     void setPersonManager(PERSONMANAGER *personManager);
-    TRIP getUpdatedTrip() const;
-    TRIP getOriginalTrip() const;
+    const TRIP &getUpdatedTrip() const;
+    const TRIP &getOriginalTrip() const;
 
    private slots:
     void editCurrentTrip();
@@ -56,8 +56,8 @@ class ViewTripDialog : public QDialog {
 
     QString formatCurrency(long long amount) const;
 
-    TRIP &trip;
-    TRIP originalTrip;
+    TRIP trip;
+    shared_ptr<const TRIP> originalTrip;
 
     QLabel *idLabel;
     QLabel *destinationLabel;
@@ -0,0 +1,28 @@
+# The widgets of the application, included by the projects that build them: the application and the UI benchmarks
+INCLUDEPATH += $$PWD/.. $$PWD
+
+SOURCES += $$PWD/MainWindow.cpp \
+    $$PWD/AddTripDialog.cpp \
+    $$PWD/FilterTripDialog.cpp \
+    $$PWD/ViewTripDialog.cpp \
+    $$PWD/EditTripDialog.cpp \
+    $$PWD/AddPersonDialog.cpp \
+    $$PWD/ManagePeopleDialog.cpp \
+    $$PWD/EditPersonDialog.cpp \
+    $$PWD/AddExpenseDialog.cpp \
+    $$PWD/ViewExpenseDialog.cpp \
+    $$PWD/DebugPanelDialog.cpp \
+    $$PWD/AnalyticsDialog.cpp
+
+HEADERS += $$PWD/MainWindow.h \
+    $$PWD/AddTripDialog.h \
+    $$PWD/FilterTripDialog.h \
+    $$PWD/ViewTripDialog.h \
+    $$PWD/EditTripDialog.h \
+    $$PWD/AddPersonDialog.h \
+    $$PWD/ManagePeopleDialog.h \
+    $$PWD/EditPersonDialog.h \
+    $$PWD/AddExpenseDialog.h \
+    $$PWD/ViewExpenseDialog.h \
+    $$PWD/DebugPanelDialog.h \
+    $$PWD/AnalyticsDialog.h
@@ -0,0 +1,195 @@
+#include "UIBenchmarks.h"
+
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QEvent>
+#include <QLineEdit>
+#include <QTableWidget>
+#include <memory>
+
+#include "../Managers/TripManager.h"
+#include "FilterTripDialog.h"
+#include "MainWindow.h"
+
+using namespace std;
+
+namespace {
+// NOTE: A repaint that has not come by then is not going to, the window is broken rather than slow
+const qint64 PAINT_TIMEOUT_MS = 30000;
+// NOTE: What a user types into the destination search and deletes again, each text applies the filters once
+const QStringList DESTINATION_KEYSTROKES = {"h", "ha", "h", ""};
+
+// CLASS: PAINTWATCH
+// Notes the paint events of a widget, so a measurement can wait until a change has been drawn
+class PAINTWATCH : public QObject {
+   private:
+    bool painted = false;
+
+   protected:
+    bool eventFilter(QObject *watched, QEvent *event) override {
+        if (event->type() == QEvent::Paint) {
+            this->painted = true;
+        }
+        return QObject::eventFilter(watched, event);
+    }
+
+   public:
+    void watch(QWidget *widget) { widget->installEventFilter(this); }
+    void reset() { this->painted = false; }
+
+    // NOTE: Runs the event loop until the next paint, the way the window gets to it after a click
+    void waitForPaint() {
+        QElapsedTimer elapsed;
+        elapsed.start();
+        while (!this->painted) {
+            if (elapsed.elapsed() > PAINT_TIMEOUT_MS) {
+                throw runtime_error("the trip table was not repainted");
+            }
+            QCoreApplication::processEvents(QEventLoop::AllEvents, 5);
+        }
+    }
+};
+
+// NOTE: The viewport is what shows the rows, the table itself only paints its frame
+QWidget *tripTableViewport(MainWindow &window) {
+    QTableWidget *table = window.findChild<QTableWidget *>();
+    if (!table) {
+        throw runtime_error("the main window has no trip table");
+    }
+    return table->viewport();
+}
+
+// CLASS: OPENWINDOW
+// A shown main window on the dataset's cache, painted once, with its trip table watched
+struct OPENWINDOW {
+    MainWindow window;
+    PAINTWATCH watch;
+
+    OPENWINDOW() {
+        this->watch.watch(tripTableViewport(this->window));
+        this->window.show();
+        this->watch.waitForPaint();
+    }
+
+    TRIPMANAGER &trips() { return *this->window.getTripManager(); }
+
+    // NOTE: The change notifies the window, which refreshes the table and writes the cache before it returns
+    template <typename CHANGE>
+    void changeAndRepaint(CHANGE change) {
+        this->watch.reset();
+        change();
+        this->watch.waitForPaint();
+    }
+};
+
+// FUNC: From creating the window, which loads the cache and fills the table, until the trips are on screen
+void runFirstPaintBenchmark(BENCHMARKRUNNER &runner, size_t size) {
+    unique_ptr<MainWindow> window;
+    PAINTWATCH watch;
+    runner.run(
+        "ui_first_paint", "ui", size,
+        [&]() -> uint64_t {
+            window = make_unique<MainWindow>();
+            watch.reset();
+            watch.watch(tripTableViewport(*window));
+            window->show();
+            watch.waitForPaint();
+            return 1;
+        },
+        // NOTE: Closing the window writes the people cache, which is not part of starting up
+        [&]() { window.reset(); });
+    window.reset();
+}
+
+// FUNC: The refresh button, which rebuilds every row of the table
+void runRefreshBenchmark(BENCHMARKRUNNER &runner, size_t size, OPENWINDOW &open) {
+    runner.run("ui_refresh", "ui", size, [&]() -> uint64_t {
+        open.changeAndRepaint([&]() {
+            if (!QMetaObject::invokeMethod(&open.window, "onRefreshViewClicked", Qt::DirectConnection)) {
+                throw runtime_error("the main window has no refresh slot");
+            }
+        });
+        return 1;
+    });
+}
+
+// FUNC: Typing into the filter dialog's destination search, every keystroke filters and sorts the whole list
+void runFilterDialogBenchmark(BENCHMARKRUNNER &runner, size_t size, OPENWINDOW &open) {
+    FilterTripDialog dialog(open.trips().getAllTrips(), &open.window);
+    QLineEdit *destination = dialog.findChild<QLineEdit *>("destinationLineEdit");
+    if (!destination) {
+        throw runtime_error("the filter dialog has no destination search");
+    }
+
+    runner.run("ui_filter_apply", "ui", size, [&]() -> uint64_t {
+        for (const QString &text : DESTINATION_KEYSTROKES) {
+            destination->setText(text);
+        }
+        return static_cast<uint64_t>(DESTINATION_KEYSTROKES.size());
+    });
+}
+
+// FUNC: Adding, editing and removing a trip, each through the observer refresh of the table and the cache write
+void runRoundTripBenchmarks(BENCHMARKRUNNER &runner, size_t size, OPENWINDOW &open) {
+    TRIPSNAPSHOT loaded = open.trips().getAllTrips();
+    if (loaded.empty()) {
+        throw runtime_error("the main window loaded no trips");
+    }
+    // NOTE: A copy of a stored trip, addTrip gives it a free ID next to the original's
+    TRIP addition = loaded[loaded.size() / 2];
+    string addedID;
+    auto add = [&]() { addedID = open.trips().addTrip(addition); };
+    auto remove = [&]() {
+        open.trips().removeTrip(addedID);
+        addedID.clear();
+    };
+    // NOTE: The setups repaint too, so a measured change does not also pay for drawing the one before it
+    auto removeAdded = [&]() {
+        if (!addedID.empty()) {
+            open.changeAndRepaint(remove);
+        }
+    };
+    auto addMissing = [&]() {
+        if (addedID.empty()) {
+            open.changeAndRepaint(add);
+        }
+    };
+
+    runner.run(
+        "ui_trip_add", "ui", size,
+        [&]() -> uint64_t {
+            open.changeAndRepaint(add);
+            return 1;
+        },
+        removeAdded);
+
+    addMissing();
+    size_t edits = 0;
+    runner.run("ui_trip_edit", "ui", size, [&]() -> uint64_t {
+        shared_ptr<const TRIP> stored = open.trips().shareTripById(addedID);
+        TRIP updated = *stored;
+        updated.setDescription("Edited " + to_string(++edits));
+        open.changeAndRepaint([&]() { open.trips().updateTrip(*stored, updated); });
+        return 1;
+    });
+
+    runner.run(
+        "ui_trip_remove", "ui", size,
+        [&]() -> uint64_t {
+            open.changeAndRepaint(remove);
+            return 1;
+        },
+        addMissing);
+    removeAdded();
+}
+}  // namespace
+
+void runUIBenchmarks(BENCHMARKRUNNER &runner, const BENCHMARKDATASET &dataset) {
+    size_t size = dataset.getSummary().trips;
+    runFirstPaintBenchmark(runner, size);
+
+    OPENWINDOW open;
+    runRefreshBenchmark(runner, size, open);
+    runFilterDialogBenchmark(runner, size, open);
+    runRoundTripBenchmarks(runner, size, open);
+}
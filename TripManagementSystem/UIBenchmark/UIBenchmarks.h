@@ -0,0 +1,13 @@
+#ifndef UIBENCHMARKS_H
+#define UIBENCHMARKS_H
+
+#include "Benchmarks.h"
+
+using namespace std;
+
+// FUNC: The main window on a dataset's cache: time to the first paint of the trip table, refreshing it, applying the
+// filter dialog, and adding, editing and removing a trip through the observer refresh and cache write. Needs a
+// QApplication; each latency includes the repaint of the trip table it causes.
+void runUIBenchmarks(BENCHMARKRUNNER &runner, const BENCHMARKDATASET &dataset);
+
+#endif  // UIBENCHMARKS_H
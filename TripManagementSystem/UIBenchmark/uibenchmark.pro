@@ -0,0 +1,44 @@
+# The benchmark suite plus the main window's benchmarks, run on Qt's offscreen platform so no display is needed. The
+# report is the one tripbench writes, so the gate compares the UI results with the core ones.
+QT += core widgets gui
+CONFIG += c++17 console debug_and_release
+CONFIG -= app_bundle
+
+TARGET = tripuibench
+TEMPLATE = app
+
+include(../core/core.pri)
+include(../UI/ui.pri)
+INCLUDEPATH += $$PWD $$PWD/../Benchmark
+
+DEFINES += TRIP_UI_BENCHMARKS QT_DEPRECATED_WARNINGS
+
+CONFIG(debug, debug|release) {
+    DESTDIR = $$OUT_PWD/../debug
+}
+
+CONFIG(release, debug|release) {
+    DESTDIR = $$OUT_PWD/../release
+}
+
+SOURCES += ../Benchmark/main.cpp \
+    ../Benchmark/AllocationBudgets.cpp \
+    ../Benchmark/AllocationCounter.cpp \
+    ../Benchmark/BenchmarkRunner.cpp \
+    ../Benchmark/Benchmarks.cpp \
+    ../Benchmark/RegressionGate.cpp \
+    ../Benchmark/StressTest.cpp \
+    UIBenchmarks.cpp
+
+HEADERS += ../Benchmark/AllocationBudgets.h \
+    ../Benchmark/AllocationCounter.h \
+    ../Benchmark/BenchmarkRunner.h \
+    ../Benchmark/Benchmarks.h \
+    ../Benchmark/RegressionGate.h \
+    ../Benchmark/StressTest.h \
+    UIBenchmarks.h
+
+# Peak working set size
+win32: LIBS += -lpsapi
+
+QMAKE_CXXFLAGS += -Wall -Wextra
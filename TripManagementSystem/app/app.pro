@@ -0,0 +1,29 @@
+QT += core widgets gui
+
+CONFIG += c++17 debug_and_release 
+
+TARGET = TripManagementSystem
+TEMPLATE = app
+
+include(../core/core.pri)
+include(../UI/ui.pri)
+
+# Main application file
+SOURCES += ../main.cpp
+
+# Compiler definitions
+DEFINES += QT_DEPRECATED_WARNINGS
+
+# NOTE: The executable still lands in debug/ and release/ next to the cache folder, where the build scripts expect it
+CONFIG(debug, debug|release) {
+    DESTDIR = $$OUT_PWD/../debug
+    TARGET = TripManagementSystem
+}
+
+CONFIG(release, debug|release) {
+    DESTDIR = $$OUT_PWD/../release
+    TARGET = TripManagementSystem
+}
+
+# Additional compiler flags for better debugging
+QMAKE_CXXFLAGS += -Wall -Wextra
@@ -0,0 +1,15 @@
+# Included by the projects that link the core library
+INCLUDEPATH += $$PWD/../Models $$PWD/../Managers $$PWD/../include
+DEPENDPATH += $$PWD/../Models $$PWD/../Managers
+
+# NOTE: Trace spans, see Managers/Trace.h
+tracing: DEFINES += TRIP_TRACING
+
+CONFIG(debug, debug|release) {
+    CORE_LIB_DIR = $$OUT_PWD/../lib/debug
+} else {
+    CORE_LIB_DIR = $$OUT_PWD/../lib/release
+}
+
+LIBS += -L$$CORE_LIB_DIR -ltripcore
+PRE_TARGETDEPS += $$CORE_LIB_DIR/libtripcore.a
@@ -0,0 +1,79 @@
+# Core library: models, managers and persistence, no Qt dependency
+CONFIG += c++17 staticlib debug_and_release
+CONFIG -= qt
+
+TARGET = tripcore
+TEMPLATE = lib
+
+CONFIG(debug, debug|release) {
+    DESTDIR = $$OUT_PWD/../lib/debug
+}
+
+CONFIG(release, debug|release) {
+    DESTDIR = $$OUT_PWD/../lib/release
+}
+
+INCLUDEPATH += ../Models ../Managers ../include
+
+# NOTE: "qmake CONFIG+=tracing" compiles the trace spans in, the consumers pick the same define up from core.pri
+tracing: DEFINES += TRIP_TRACING
+
+# Model files
+SOURCES += ../Models/Date.cpp \
+    ../Models/Gender.cpp \
+    ../Models/Host.cpp \
+    ../Models/Person.cpp \
+    ../Models/Member.cpp \
+    ../Models/Status.cpp \
+    ../Models/Trip.cpp \
+    ../Models/Expense.cpp \
+    ../Models/ExpenseTotals.cpp \
+    ../Models/Category.cpp \
+    ../Models/IdKey.cpp \
+    ../Models/InternedString.cpp \
+    ../Models/Utility_Functions.cpp
+
+# Manager files
+SOURCES += ../Managers/FileManager_Trip.cpp \
+    ../Managers/FileManager_People.cpp \
+    ../Managers/TripManager.cpp \
+    ../Managers/Observer.cpp \
+    ../Managers/PersonFactory.cpp \
+    ../Managers/TripFactory.cpp \
+    ../Managers/PersonManager.cpp \
+    ../Managers/ExpenseAggregates.cpp \
+    ../Managers/ExpenseAnalytics.cpp \
+    ../Managers/MembershipIndex.cpp \
+    ../Managers/SnapshotArena.cpp \
+    ../Managers/IdAllocator.cpp \
+    ../Managers/MergeImport.cpp \
+    ../Managers/TripSnapshot.cpp \
+    ../Managers/DatasetGenerator.cpp \
+    ../Managers/TripFilter.cpp \
+    ../Managers/Trace.cpp \
+    ../Managers/Log.cpp \
+    ../Managers/Metrics.cpp
+
+# Header files
+HEADERS += ../Models/header.h \
+    ../Managers/FileManager.h \
+    ../Managers/TripManager.h \
+    ../Managers/Observer.h \
+    ../Managers/PersonFactory.h \
+    ../Managers/TripFactory.h \
+    ../Managers/PersonManager.h \
+    ../Managers/ExpenseAggregates.h \
+    ../Managers/ExpenseAnalytics.h \
+    ../Managers/MembershipIndex.h \
+    ../Managers/SnapshotArena.h \
+    ../Managers/IdAllocator.h \
+    ../Managers/MergeImport.h \
+    ../Managers/TripSnapshot.h \
+    ../Managers/PersistentVector.h \
+    ../Managers/DatasetGenerator.h \
+    ../Managers/TripFilter.h \
+    ../Managers/Trace.h \
+    ../Managers/Log.h \
+    ../Managers/Metrics.h
+
+QMAKE_CXXFLAGS += -Wall -Wextra
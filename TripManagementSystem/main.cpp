@@ -1,12 +1,20 @@
 #include <QApplication>
 #include <QPalette>
 #include <QStyleFactory>
+#include <cstdlib>
 
+#include "Managers/Trace.h"
 #include "UI/MainWindow.h"
 
 int main(int argc, char* argv[]) {
     QApplication app(argc, argv);
 
+    // NOTE: TRIP_TRACE=<file> records the trace spans of the session and writes them once the window is gone
+    const char* traceFile = getenv("TRIP_TRACE");
+    if (traceFile && *traceFile) {
+        startTracing();
+    }
+
     app.setStyle(QStyleFactory::create("Fusion"));
 
     QPalette lightPalette;
@@ -23,8 +31,20 @@ int main(int argc, char* argv[]) {
 
     app.setPalette(lightPalette);
 
-    MainWindow window;
-    window.show();
+    int result = 0;
+    {
+        MainWindow window;
+        window.show();
+        result = app.exec();
+    }
 
-    return app.exec();
+    if (traceFile && *traceFile) {
+        stopTracing();
+        try {
+            writeChromeTraceFile(traceFile);
+        } catch (const std::exception& e) {
+            logDebug(e.what());
+        }
+    }
+    return result;
 }
\ No newline at end of file
@@ -0,0 +1,61 @@
+@echo off
+setlocal
+
+echo ========================================
+echo Trip Management System - Performance Gate
+echo ========================================
+echo.
+
+cd /d "%~dp0\TripManagementSystem"
+
+if not exist "release\tripbench.exe" (
+    echo ERROR: release\tripbench.exe not found!
+    echo Please run build_run.bat first.
+    exit /b 2
+)
+
+:: With the UI benchmarks built and their platform plugin deployed, the gate covers the main window as well
+set BENCH_EXE=release\tripbench.exe
+if exist "release\tripuibench.exe" if exist "release\platforms\qoffscreen.dll" set BENCH_EXE=release\tripuibench.exe
+echo Benchmarks: %BENCH_EXE%
+echo.
+
+:: The baseline has to be recorded with the same sizes, repetitions and seed it is compared with
+set BENCH_ARGS=--sizes 1000,10000 --repetitions 5 --min-time-ms 200 --seed 1
+
+if /i "%~1"=="update" (
+    echo Recording a new baseline in Benchmark\baseline.json...
+    %BENCH_EXE% %BENCH_ARGS% --output Benchmark\baseline.json
+    exit /b %errorlevel%
+)
+
+echo Checking the allocation budgets...
+%BENCH_EXE% budgets
+if errorlevel 2 (
+    echo.
+    echo ERROR: the allocation budgets could not be checked.
+    exit /b 2
+)
+if errorlevel 1 (
+    echo.
+    echo FAILED: an operation went over its allocation budget, see the counts above.
+    exit /b 1
+)
+echo.
+
+echo Running the benchmarks and comparing them to Benchmark\baseline.json...
+echo Results of this run go to bench_results.json
+echo.
+%BENCH_EXE% %BENCH_ARGS% --baseline Benchmark\baseline.json --output bench_results.json
+set GATE_RESULT=%errorlevel%
+
+echo.
+if %GATE_RESULT% equ 0 (
+    echo PASSED: no load, save, lookup, filter or UI regressions.
+) else if %GATE_RESULT% equ 1 (
+    echo FAILED: throughput regressed, see the differences above.
+) else (
+    echo ERROR: the benchmarks could not be run.
+)
+
+exit /b %GATE_RESULT%
@@ -71,7 +71,7 @@ if %errorlevel% equ 0 (
     )
 )
 
-%MAKE_CMD% -f Makefile.Release
+%MAKE_CMD% release
 if %errorlevel% neq 0 (
     echo ERROR: Build failed!
     echo Check the error messages above.
@@ -159,6 +159,13 @@ if %errorlevel% neq 0 (
     echo windeployqt completed successfully!
 )
 
+:: The UI benchmarks (tripuibench) run on the offscreen platform, which windeployqt does not deploy
+for /f "tokens=*" %%i in ('qmake -query QT_INSTALL_PLUGINS') do set QT_PLUGINS_DIR=%%i
+if exist "%QT_PLUGINS_DIR%\platforms\qoffscreen.dll" (
+    if not exist "platforms" mkdir platforms
+    copy "%QT_PLUGINS_DIR%\platforms\qoffscreen.dll" platforms\ >nul 2>&1
+)
+
 :: Copy cache folder if it exists
 if exist "..\cache" (
     echo Copying cache folder...
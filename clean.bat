@@ -14,6 +14,22 @@ if exist .qmake.stash del .qmake.stash
 if exist object_script.TripManagementSystem.Debug del object_script.TripManagementSystem.Debug
 if exist object_script.TripManagementSystem.Release del object_script.TripManagementSystem.Release
 
+:: Generated files of the core library, application, command-line and benchmark subprojects
+for %%d in (core app CLI Benchmark UIBenchmark) do (
+    if exist %%d\Makefile del %%d\Makefile
+    if exist %%d\Makefile.Debug del %%d\Makefile.Debug
+    if exist %%d\Makefile.Release del %%d\Makefile.Release
+    if exist %%d\debug rmdir /s /q %%d\debug
+    if exist %%d\release rmdir /s /q %%d\release
+)
+
+if exist bench_results.json del bench_results.json
+
+if exist lib (
+    echo Removing lib directory...
+    rmdir /s /q lib
+)
+
 if exist debug (
     echo Removing debug directory...
     rmdir /s /q debug